@@ -72,6 +72,7 @@ public:
 
   virtual void* GetHTTPResponseData() const;
   virtual size_t GetHTTPResonseDataLength() const;
+  virtual const char* GetName() const { return "plexremote"; }
 
   static CPlexServerPtr getServerFromArguments(const ArgMap& arguments);
 
@@ -0,0 +1,130 @@
+#!/usr/bin/env python
+#
+#      Copyright (C) 2005-2012 Team XBMC
+#      http://www.xbmc.org
+#
+#  This Program is free software; you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation; either version 2, or (at your option)
+#  any later version.
+#
+#  This Program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with XBMC; see the file COPYING.  If not, write to
+#  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+#  http://www.gnu.org/copyleft/gpl.html
+#
+#  Load generator for the built-in web server. Runs clients against the
+#  JSON-RPC, image and vfs handlers at the same time, at increasing levels
+#  of concurrency, and prints throughput and latency per handler so it
+#  shows where the box saturates. The per handler counters the server
+#  itself keeps are written to the log when the web server stops.
+#
+#  Example:
+#    WebServerBench.py --host 127.0.0.1 --port 8080 --user xbmc --password xbmc \
+#      --image "image://special%3a%2f%2fskin%2fbackgrounds%2fvideos.jpg/" \
+#      --vfs "special%3a%2f%2fxbmc%2fmedia%2fSplash.png" --concurrency 1,8,32,128
+#
+
+import base64, json, optparse, sys, threading, time
+
+try:
+  import httplib
+except ImportError:
+  import http.client as httplib
+
+class Worker(threading.Thread):
+  def __init__(self, options, targets, stop):
+    threading.Thread.__init__(self)
+    self.daemon = True
+    self.options = options
+    self.targets = targets
+    self.stop = stop
+    self.results = dict((name, []) for name, method, url, body in targets)
+    self.errors = dict((name, 0) for name, method, url, body in targets)
+
+  def connect(self):
+    return httplib.HTTPConnection(self.options.host, self.options.port, timeout=self.options.timeout)
+
+  def run(self):
+    headers = { "Content-Type": "application/json" }
+    if self.options.user:
+      credentials = "%s:%s" % (self.options.user, self.options.password)
+      headers["Authorization"] = "Basic " + base64.b64encode(credentials.encode()).decode()
+
+    # keep-alive connection, reopened after a failure
+    connection = self.connect()
+    index = 0
+    while not self.stop.is_set():
+      name, method, url, body = self.targets[index % len(self.targets)]
+      index += 1
+      start = time.time()
+      try:
+        connection.request(method, url, body, headers)
+        response = connection.getresponse()
+        response.read()
+        if response.status >= 400:
+          self.errors[name] += 1
+        else:
+          self.results[name].append(time.time() - start)
+      except Exception:
+        self.errors[name] += 1
+        connection.close()
+        connection = self.connect()
+    connection.close()
+
+def percentile(values, fraction):
+  if not values:
+    return 0.0
+  return values[min(len(values) - 1, int(len(values) * fraction))]
+
+def run(options, targets, concurrency):
+  stop = threading.Event()
+  workers = [Worker(options, targets, stop) for i in range(concurrency)]
+  for worker in workers:
+    worker.start()
+  time.sleep(options.duration)
+  stop.set()
+  for worker in workers:
+    worker.join(options.timeout + 1)
+
+  for name, method, url, body in targets:
+    latencies = sorted(sum([worker.results[name] for worker in workers], []))
+    errors = sum([worker.errors[name] for worker in workers])
+    print("%6d  %-8s %9.1f %9.1f %9.1f %9.1f %7d" % (concurrency, name,
+          len(latencies) / float(options.duration),
+          percentile(latencies, 0.5) * 1000, percentile(latencies, 0.95) * 1000,
+          percentile(latencies, 0.99) * 1000, errors))
+  sys.stdout.flush()
+
+def main():
+  parser = optparse.OptionParser()
+  parser.add_option("--host", default="127.0.0.1")
+  parser.add_option("--port", type="int", default=8080)
+  parser.add_option("--user", default="")
+  parser.add_option("--password", default="")
+  parser.add_option("--image", default="", help="url encoded image:// path to request")
+  parser.add_option("--vfs", default="", help="url encoded vfs path to request")
+  parser.add_option("--method", default="JSONRPC.Ping", help="JSON-RPC method to call")
+  parser.add_option("--concurrency", default="1,4,16,64", help="comma separated numbers of clients")
+  parser.add_option("--duration", type="int", default=10, help="seconds per concurrency level")
+  parser.add_option("--timeout", type="int", default=30)
+  (options, args) = parser.parse_args()
+
+  request = json.dumps({ "jsonrpc": "2.0", "method": options.method, "id": 1 })
+  targets = [ ("jsonrpc", "POST", "/jsonrpc", request) ]
+  if options.image:
+    targets.append(("image", "GET", "/image/" + options.image, None))
+  if options.vfs:
+    targets.append(("vfs", "GET", "/vfs/" + options.vfs, None))
+
+  print("%6s  %-8s %9s %9s %9s %9s %7s" % ("conns", "handler", "req/s", "p50 ms", "p95 ms", "p99 ms", "errors"))
+  for concurrency in [int(level) for level in options.concurrency.split(",")]:
+    run(options, targets, concurrency)
+
+if __name__ == "__main__":
+  main()
@@ -4244,6 +4244,7 @@ bool CApplication::PlayFile(const CFileItem& item_, bool bRestart)
 
     *m_itemCurrentFile = item;
     m_nextPlaylistItem = -1;
+    m_nextPlaylistPath.Empty();
     m_currentStackPosition = 0;
     m_currentStack->Clear();
 
@@ -5353,6 +5354,7 @@ bool CApplication::OnMessage(CGUIMessage& message)
 #endif
       // reset the seek handler
       m_seekHandler->Reset();
+      m_nextPlaylistPath.Empty();
       CPlayList playList = g_playlistPlayer.GetPlaylist(g_playlistPlayer.GetCurrentPlaylist());
 
       // Update our infoManager with the new details etc.
@@ -5452,6 +5454,7 @@ bool CApplication::OnMessage(CGUIMessage& message)
         {
           // player accepted the next file
           m_nextPlaylistItem = iNext;
+          m_nextPlaylistPath = playlist[iNext]->GetPath();
         }
         else
         {
@@ -5465,6 +5468,25 @@ bool CApplication::OnMessage(CGUIMessage& message)
     }
     break;
 
+  case GUI_MSG_PLAYLIST_CHANGED:
+    {
+      // the player opens the queued item ahead of time, if it is no longer
+      // the next one ask for the new one so the player can replace it
+      if (m_pPlayer && IsPlayingAudio() && !m_nextPlaylistPath.IsEmpty())
+      {
+        int iNext = g_playlistPlayer.GetNextSong();
+        CPlayList& playlist = g_playlistPlayer.GetPlaylist(g_playlistPlayer.GetCurrentPlaylist());
+        if (iNext != m_nextPlaylistItem || iNext < 0 || iNext >= playlist.size() ||
+            playlist[iNext]->GetPath() != m_nextPlaylistPath)
+        {
+          m_nextPlaylistPath.Empty();
+          CGUIMessage msg(GUI_MSG_QUEUE_NEXT_ITEM, 0, 0);
+          g_windowManager.SendThreadMessage(msg);
+        }
+      }
+    }
+    break;
+
   case GUI_MSG_PLAYBACK_STOPPED:
   case GUI_MSG_PLAYBACK_ENDED:
   case GUI_MSG_PLAYLISTPLAYER_STOPPED:
@@ -450,6 +450,7 @@ protected:
   int m_iPlaySpeed;
   int m_currentStackPosition;
   int m_nextPlaylistItem;
+  CStdString m_nextPlaylistPath; // queued item not yet started
 
   bool m_bPresentFrame;
   unsigned int m_lastFrameTime;
@@ -37,6 +37,11 @@ using namespace std;
 using namespace EPG;
 using namespace PVR;
 
+/* idle connections kept per database, enough for the GUI and a couple of jobs */
+#define MAX_IDLE_CONNECTIONS 4
+/* connections idle for longer are closed rather than reused */
+#define MAX_IDLE_TIME 60000
+
 CDatabaseManager &CDatabaseManager::Get()
 {
   static CDatabaseManager s_manager;
@@ -44,6 +49,7 @@ CDatabaseManager &CDatabaseManager::Get()
 }
 
 CDatabaseManager::CDatabaseManager()
+  : m_pool(MAX_IDLE_CONNECTIONS, MAX_IDLE_TIME)
 {
 }
 
@@ -78,8 +84,17 @@ void CDatabaseManager::Initialize(bool addonsOnly)
 
 void CDatabaseManager::Deinitialize()
 {
-  CSingleLock lock(m_section);
-  m_dbStatus.clear();
+  {
+    CSingleLock lock(m_section);
+    m_dbStatus.clear();
+  }
+
+  // a profile change moves the databases, don't hand out connections to the old ones
+  PoolStats stats = GetPoolStats();
+  if (stats.opened)
+    CLog::Log(LOGDEBUG, "%s - connection pool: %u opened, %u reused, %u in use (peak %u), %u idle",
+              __FUNCTION__, stats.opened, stats.reused, stats.inUse, stats.peakInUse, stats.idle);
+  m_pool.Clear();
 }
 
 bool CDatabaseManager::CanOpen(const std::string &name)
@@ -106,3 +121,23 @@ void CDatabaseManager::UpdateStatus(const std::string &name, DB_STATUS status)
   CSingleLock lock(m_section);
   m_dbStatus[name] = status;
 }
+
+dbiplus::Database *CDatabaseManager::AcquireConnection(const std::string &key)
+{
+  return m_pool.Acquire(key);
+}
+
+void CDatabaseManager::ConnectionOpened(const std::string &key)
+{
+  m_pool.Opened(key);
+}
+
+void CDatabaseManager::ReleaseConnection(const std::string &key, dbiplus::Database *db)
+{
+  m_pool.Release(key, db);
+}
+
+CDatabaseManager::PoolStats CDatabaseManager::GetPoolStats()
+{
+  return m_pool.GetStats();
+}
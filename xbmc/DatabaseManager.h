@@ -24,9 +24,11 @@
 #include <string>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
+#include "dbwrappers/DatabasePool.h"
 
 class CDatabase;
 class DatabaseSettings;
+namespace dbiplus { class Database; }
 
 /*!
  \ingroup database
@@ -35,6 +37,10 @@ class DatabaseSettings;
  Ensures that databases used in XBMC are up to date, and if a database can't be
  opened, ensures we don't continuously try it.
 
+ Also keeps a pool of idle connections, so the many short lived CDatabase
+ objects used by the GUI and background jobs reuse a connection, with its
+ prepared statements and page cache, rather than opening one each time.
+
  */
 class CDatabaseManager
 {
@@ -65,6 +71,27 @@ public:
    */ 
   bool CanOpen(const std::string &name);
 
+  /*! \brief Take an idle connection from the pool.
+   \param key identifies the database and the settings it's opened with.
+   \return a connected database, or NULL if there is no idle connection to it.
+   */
+  dbiplus::Database *AcquireConnection(const std::string &key);
+
+  /*! \brief Count a newly opened connection as in use.
+   \param key identifies the database and the settings it's opened with.
+   */
+  void ConnectionOpened(const std::string &key);
+
+  /*! \brief Hand a connection back once its user is done with it.
+   Connections beyond what the pool keeps idle are disconnected.
+   \param key identifies the database and the settings it's opened with.
+   \param db the connection, NULL if the user closed it instead.
+   */
+  void ReleaseConnection(const std::string &key, dbiplus::Database *db);
+
+  typedef CDatabasePool::Stats PoolStats;
+  PoolStats GetPoolStats();
+
 private:
   // private construction, and no assignements; use the provided singleton methods
   CDatabaseManager();
@@ -78,4 +105,5 @@ private:
 
   CCriticalSection            m_section;     ///< Critical section protecting m_dbStatus.
   std::map<std::string, DB_STATUS> m_dbStatus;    ///< Our database status map.
+  CDatabasePool               m_pool;        ///< Idle connections for reuse.
 };
@@ -37,6 +37,21 @@
 
 using namespace XFILE;
 
+/* entries kept in memory to answer lookups without touching the database */
+#define TEXTURE_LOOKUP_SIZE 5000
+#define PATH_LOOKUP_SIZE    2000
+
+static bool GetTextureDetails(const CTextureRecord &record, CTextureDetails &details)
+{
+  if (record.details.file.empty())
+    return false;
+
+  details = record.details;
+  if (!CTextureDatabase::IsHashCheckDue(record.lastCheck))
+    details.hash.clear();
+  return true;
+}
+
 CTextureCache &CTextureCache::Get()
 {
   static CTextureCache s_cache;
@@ -46,10 +61,16 @@ CTextureCache &CTextureCache::Get()
 CTextureCache::CTextureCache()
 /* PLEX */
 #ifndef TARGET_RPI
-  : CJobQueue(false, 2)
+  : CJobQueue(false, 2),
+#else
+  : CJobQueue(),
 #endif
 /* END PLEX */
+    m_textures(TEXTURE_LOOKUP_SIZE),
+    m_paths(PATH_LOOKUP_SIZE)
 {
+  m_texturesComplete = false;
+  m_lookupGeneration = 0;
 }
 
 CTextureCache::~CTextureCache()
@@ -59,15 +80,63 @@ CTextureCache::~CTextureCache()
 void CTextureCache::Initialize()
 {
   CSingleLock lock(m_databaseSection);
-  if (!m_database.IsOpen())
-    m_database.Open();
+  if (!m_database.IsOpen() && m_database.Open())
+    LoadLookupCache();
 }
 
 void CTextureCache::Deinitialize()
 {
   CancelJobs();
+
+  std::vector<CTextureDetails> useCounts;
+  {
+    CSingleLock lock(m_useCountSection);
+    useCounts.swap(m_useCounts);
+  }
+
   CSingleLock lock(m_databaseSection);
+  if (!useCounts.empty() && m_database.IsOpen())
+  { // write out the use counts that hadn't made up a full batch yet
+    m_database.BeginTransaction();
+    for (std::vector<CTextureDetails>::const_iterator i = useCounts.begin(); i != useCounts.end(); ++i)
+      m_database.IncrementUseCount(*i);
+    m_database.CommitTransaction();
+  }
   m_database.Close();
+
+  CSingleLock lookupLock(m_lookupSection);
+  m_textures.Clear();
+  m_paths.Clear();
+  m_texturesComplete = false;
+  m_lookupGeneration++;
+}
+
+void CTextureCache::LoadLookupCache()
+{
+  // ask for one more than we keep to find out whether they all fit
+  std::vector< std::pair<CStdString, CTextureRecord> > textures;
+  if (!m_database.GetCachedTextures(m_textures.MaxSize() + 1, textures))
+    return;
+
+  CSingleLock lock(m_lookupSection);
+  m_textures.Clear();
+  // least recently used first, so they are the first to go
+  for (std::vector< std::pair<CStdString, CTextureRecord> >::reverse_iterator i = textures.rbegin(); i != textures.rend(); ++i)
+    m_textures.Set(i->first, i->second);
+  m_texturesComplete = textures.size() <= m_textures.MaxSize();
+  m_lookupGeneration++;
+
+  CLog::Log(LOGDEBUG, "%s - loaded %u textures%s", __FUNCTION__, (unsigned int)m_textures.Size(), m_texturesComplete ? "" : ", more in database");
+}
+
+void CTextureCache::UpdateLookupCache(const CStdString &url, const CTextureRecord &record)
+{
+  CSingleLock lock(m_lookupSection);
+  if (record.details.file.empty() && m_texturesComplete)
+    m_textures.Erase(url);
+  else if (m_textures.Set(url, record))
+    m_texturesComplete = false;
+  m_lookupGeneration++;
 }
 
 bool CTextureCache::IsCachedImage(const CStdString &url) const
@@ -247,14 +316,46 @@ void CTextureCache::ClearCachedImage(const CStdString &url, bool deleteSource /*
 
 bool CTextureCache::GetCachedTexture(const CStdString &url, CTextureDetails &details)
 {
-  CSingleLock lock(m_databaseSection);
-  return m_database.GetCachedTexture(url, details);
+  CTextureRecord record;
+  unsigned int generation;
+  {
+    CSingleLock lock(m_lookupSection);
+    if (m_textures.Get(url, record))
+      return GetTextureDetails(record, details);
+    if (m_texturesComplete)
+      return false;
+    generation = m_lookupGeneration;
+  }
+
+  // the database holds more textures than we keep in memory
+  {
+    CSingleLock lock(m_databaseSection);
+    if (!m_database.IsOpen())
+      return false;
+    if (!m_database.GetCachedTexture(url, record))
+      record = CTextureRecord();
+  }
+
+  { // remember the result, unless it was changed while we were reading
+    CSingleLock lock(m_lookupSection);
+    if (generation == m_lookupGeneration)
+      m_textures.Set(url, record);
+  }
+  return GetTextureDetails(record, details);
 }
 
 bool CTextureCache::AddCachedTexture(const CStdString &url, const CTextureDetails &details)
 {
+  CTextureRecord record;
+  record.details = details;
+  if (details.updateable)
+    record.lastCheck = CDateTime::GetCurrentDateTime();
+
   CSingleLock lock(m_databaseSection);
-  return m_database.AddCachedTexture(url, details);
+  if (!m_database.AddCachedTexture(url, record.details))
+    return false;
+  UpdateLookupCache(url, record);
+  return true;
 }
 
 void CTextureCache::IncrementUseCount(const CTextureDetails &details)
@@ -273,13 +374,113 @@ void CTextureCache::IncrementUseCount(const CTextureDetails &details)
 bool CTextureCache::SetCachedTextureValid(const CStdString &url, bool updateable)
 {
   CSingleLock lock(m_databaseSection);
-  return m_database.SetCachedTextureValid(url, updateable);
+  if (!m_database.SetCachedTextureValid(url, updateable))
+    return false;
+
+  CSingleLock lookupLock(m_lookupSection);
+  CTextureRecord record;
+  if (m_textures.Get(url, record) && !record.details.file.empty())
+  {
+    record.lastCheck = updateable ? CDateTime::GetCurrentDateTime() : CDateTime();
+    m_textures.Set(url, record);
+  }
+  m_lookupGeneration++;
+  return true;
 }
 
 bool CTextureCache::ClearCachedTexture(const CStdString &url, CStdString &cachedURL)
 {
   CSingleLock lock(m_databaseSection);
-  return m_database.ClearCachedTexture(url, cachedURL);
+  bool cleared = m_database.ClearCachedTexture(url, cachedURL);
+  UpdateLookupCache(url, CTextureRecord());
+  return cleared;
+}
+
+void CTextureCache::InvalidateCachedImage(const CStdString &url)
+{
+  CSingleLock lock(m_databaseSection);
+  if (!m_database.InvalidateCachedTexture(url))
+    return;
+
+  CSingleLock lookupLock(m_lookupSection);
+  CTextureRecord record;
+  if (m_textures.Get(url, record) && !record.details.file.empty())
+  { // same as the database, old enough for the next load to check the image
+    record.lastCheck = CDateTime::GetCurrentDateTime() - CDateTimeSpan(2, 0, 0, 0);
+    m_textures.Set(url, record);
+  }
+  m_lookupGeneration++;
+}
+
+CStdString CTextureCache::GetTextureForPath(const CStdString &url, const CStdString &type)
+{
+  if (url.empty())
+    return "";
+
+  PathKey key(url, type);
+  std::string texture;
+  unsigned int generation;
+  {
+    CSingleLock lock(m_lookupSection);
+    if (m_paths.Get(key, texture))
+      return texture;
+    generation = m_lookupGeneration;
+  }
+
+  {
+    CSingleLock lock(m_databaseSection);
+    if (!m_database.IsOpen())
+    { // we're between skins, nothing is remembered until we're initialized again
+      lock.Leave();
+      CTextureDatabase db;
+      return db.Open() ? db.GetTextureForPath(url, type) : "";
+    }
+    texture = m_database.GetTextureForPath(url, type);
+  }
+
+  CSingleLock lock(m_lookupSection);
+  if (generation == m_lookupGeneration)
+    m_paths.Set(key, texture);
+  return texture;
+}
+
+void CTextureCache::SetTextureForPath(const CStdString &url, const CStdString &type, const CStdString &texture)
+{
+  if (url.empty())
+    return;
+
+  CSingleLock lock(m_databaseSection);
+  if (!m_database.IsOpen())
+  {
+    lock.Leave();
+    CTextureDatabase db;
+    if (db.Open())
+      db.SetTextureForPath(url, type, texture);
+    return;
+  }
+  m_database.SetTextureForPath(url, type, texture);
+
+  CSingleLock lookupLock(m_lookupSection);
+  m_paths.Set(PathKey(url, type), texture);
+  m_lookupGeneration++;
+}
+
+void CTextureCache::ClearTextureForPath(const CStdString &url, const CStdString &type)
+{
+  CSingleLock lock(m_databaseSection);
+  if (!m_database.IsOpen())
+  {
+    lock.Leave();
+    CTextureDatabase db;
+    if (db.Open())
+      db.ClearTextureForPath(url, type);
+    return;
+  }
+  m_database.ClearTextureForPath(url, type);
+
+  CSingleLock lookupLock(m_lookupSection);
+  m_paths.Set(PathKey(url, type), "");
+  m_lookupGeneration++;
 }
 
 CStdString CTextureCache::GetCacheFile(const CStdString &url)
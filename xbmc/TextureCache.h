@@ -25,6 +25,7 @@
 #include "utils/JobManager.h"
 #include "TextureDatabase.h"
 #include "threads/Event.h"
+#include "utils/LRUMap.h"
 
 class CURL;
 class CBaseTexture;
@@ -120,6 +121,30 @@ public:
    */
   virtual void ClearCachedImage(const CStdString &image, bool deleteSource = false);
 
+  /*! \brief Invalidate the cached version of the given image so that it is checked for changes on next load
+   Thread-safe wrapper of CTextureDatabase::InvalidateCachedTexture
+   \param image url of the image
+   */
+  void InvalidateCachedImage(const CStdString &image);
+
+  /*! \brief Get a texture associated with the given path
+   Thread-safe wrapper of CTextureDatabase::GetTextureForPath, answered from memory where possible
+   \sa CTextureDatabase::GetTextureForPath
+   */
+  CStdString GetTextureForPath(const CStdString &url, const CStdString &type);
+
+  /*! \brief Set a texture associated with the given path
+   Thread-safe wrapper of CTextureDatabase::SetTextureForPath
+   \sa CTextureDatabase::SetTextureForPath
+   */
+  void SetTextureForPath(const CStdString &url, const CStdString &type, const CStdString &texture);
+
+  /*! \brief Clear a texture associated with the given path
+   Thread-safe wrapper of CTextureDatabase::ClearTextureForPath
+   \sa CTextureDatabase::ClearTextureForPath
+   */
+  void ClearTextureForPath(const CStdString &url, const CStdString &type);
+
   /*! \brief retrieve a cache file (relative to the cache path) to associate with the given image, excluding extension
    Use GetCachedPath(GetCacheFile(url)+extension) for the full path to the file.
    \param url location of the image
@@ -234,6 +259,25 @@ private:
    */
   virtual void OnCachingComplete(bool success, CTextureCacheJob *job);
 
+  /*! \brief Fill the lookup cache with the most recently used textures from the database
+   */
+  void LoadLookupCache();
+
+  /*! \brief Remember a texture in the lookup cache after it was changed in the database
+   Must be called with m_databaseSection held, after the database has been updated.
+   \param url url of the original image
+   \param record the texture, an empty details.file marks an image that is not cached
+   */
+  void UpdateLookupCache(const CStdString &url, const CTextureRecord &record);
+
+  typedef std::pair<std::string, std::string> PathKey; ///< url and image type
+
+  CCriticalSection m_lookupSection;    ///< Guards the lookup caches, never held while the database is accessed
+  CLRUMap<std::string, CTextureRecord> m_textures; ///< url -> texture, an empty file marks an image that is not cached
+  bool             m_texturesComplete; ///< Whether every cached texture is in m_textures, so that misses needn't go to the database
+  unsigned int     m_lookupGeneration; ///< Bumped on every write, so stale database reads aren't stored
+  CLRUMap<PathKey, std::string> m_paths; ///< path and type -> texture
+
   CCriticalSection m_databaseSection;
   CTextureDatabase m_database;
   std::set<CStdString> m_processing; ///< currently processing list to avoid 2 jobs being processed at once
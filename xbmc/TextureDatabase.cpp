@@ -147,6 +147,18 @@ bool CTextureDatabase::IncrementUseCount(const CTextureDetails &details)
 }
 
 bool CTextureDatabase::GetCachedTexture(const CStdString &url, CTextureDetails &details)
+{
+  CTextureRecord record;
+  if (!GetCachedTexture(url, record))
+    return false;
+
+  details = record.details;
+  if (!IsHashCheckDue(record.lastCheck))
+    details.hash.clear();
+  return true;
+}
+
+bool CTextureDatabase::GetCachedTexture(const CStdString &url, CTextureRecord &record)
 {
   try
   {
@@ -157,14 +169,12 @@ bool CTextureDatabase::GetCachedTexture(const CStdString &url, CTextureDetails &
     m_pDS->query(sql.c_str());
     if (!m_pDS->eof())
     { // have some information
-      details.id = m_pDS->fv(0).get_asInt();
-      details.file  = m_pDS->fv(1).get_asString();
-      CDateTime lastCheck;
-      lastCheck.SetFromDBDateTime(m_pDS->fv(2).get_asString());
-      if (lastCheck.IsValid() && lastCheck + CDateTimeSpan(1,0,0,0) < CDateTime::GetCurrentDateTime())
-        details.hash = m_pDS->fv(3).get_asString();
-      details.width = m_pDS->fv(4).get_asInt();
-      details.height = m_pDS->fv(5).get_asInt();
+      record.details.id = m_pDS->fv(0).get_asInt();
+      record.details.file  = m_pDS->fv(1).get_asString();
+      record.lastCheck.SetFromDBDateTime(m_pDS->fv(2).get_asString());
+      record.details.hash = m_pDS->fv(3).get_asString();
+      record.details.width = m_pDS->fv(4).get_asInt();
+      record.details.height = m_pDS->fv(5).get_asInt();
       m_pDS->close();
       return true;
     }
@@ -177,6 +187,43 @@ bool CTextureDatabase::GetCachedTexture(const CStdString &url, CTextureDetails &
   return false;
 }
 
+bool CTextureDatabase::GetCachedTextures(unsigned int limit, std::vector< std::pair<CStdString, CTextureRecord> > &textures)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString sql = PrepareSQL("SELECT url, id, cachedurl, lasthashcheck, imagehash, width, height FROM texture JOIN sizes ON (texture.id=sizes.idtexture AND sizes.size=1) ORDER BY sizes.lastusetime DESC LIMIT %u", limit);
+    if (!m_pDS->query_stream(sql))
+      return false;
+    while (!m_pDS->eof())
+    {
+      CTextureRecord record;
+      record.details.id = m_pDS->fv(1).get_asInt();
+      record.details.file = m_pDS->fv(2).get_asString();
+      record.lastCheck.SetFromDBDateTime(m_pDS->fv(3).get_asString());
+      record.details.hash = m_pDS->fv(4).get_asString();
+      record.details.width = m_pDS->fv(5).get_asInt();
+      record.details.height = m_pDS->fv(6).get_asInt();
+      textures.push_back(std::make_pair(CStdString(m_pDS->fv(0).get_asString()), record));
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
+bool CTextureDatabase::IsHashCheckDue(const CDateTime &lastCheck)
+{
+  return lastCheck.IsValid() && lastCheck + CDateTimeSpan(1,0,0,0) < CDateTime::GetCurrentDateTime();
+}
+
 bool CTextureDatabase::SetCachedTextureValid(const CStdString &url, bool updateable)
 {
   CStdString date = updateable ? CDateTime::GetCurrentDateTime().GetAsDBDateTime() : "";
@@ -184,7 +231,7 @@ bool CTextureDatabase::SetCachedTextureValid(const CStdString &url, bool updatea
   return ExecuteQuery(sql);
 }
 
-bool CTextureDatabase::AddCachedTexture(const CStdString &url, const CTextureDetails &details)
+bool CTextureDatabase::AddCachedTexture(const CStdString &url, CTextureDetails &details)
 {
   try
   {
@@ -198,6 +245,7 @@ bool CTextureDatabase::AddCachedTexture(const CStdString &url, const CTextureDet
     sql = PrepareSQL("INSERT INTO texture (id, url, cachedurl, imagehash, lasthashcheck) VALUES(NULL, '%s', '%s', '%s', '%s')", url.c_str(), details.file.c_str(), details.hash.c_str(), date.c_str());
     m_pDS->exec(sql.c_str());
     int textureID = (int)m_pDS->lastinsertid();
+    details.id = textureID;
 
     // set the size information
     sql = PrepareSQL("INSERT INTO sizes (idtexture, size, usecount, lastusetime, width, height) VALUES(%u, 1, 1, CURRENT_TIMESTAMP, %u, %u)", textureID, details.width, details.height);
@@ -22,6 +22,19 @@
 
 #include "dbwrappers/Database.h"
 #include "TextureCacheJob.h"
+#include "XBDateTime.h"
+
+#include <utility>
+#include <vector>
+
+/*! \brief Details of a cached texture together with the time its image hash was last checked
+ */
+class CTextureRecord
+{
+public:
+  CTextureDetails details;
+  CDateTime       lastCheck;
+};
 
 class CTextureDatabase : public CDatabase
 {
@@ -31,7 +44,28 @@ public:
   virtual bool Open();
 
   bool GetCachedTexture(const CStdString &originalURL, CTextureDetails &details);
-  bool AddCachedTexture(const CStdString &originalURL, const CTextureDetails &details);
+
+  /*! \brief Get a cached texture without deciding whether its hash is due for a check
+   \param originalURL url of the original image
+   \param record [out] texture details, details.hash is always the stored image hash
+   \return true if the image is cached, false otherwise
+   \sa IsHashCheckDue
+   */
+  bool GetCachedTexture(const CStdString &originalURL, CTextureRecord &record);
+
+  /*! \brief Get the most recently used cached textures
+   Used to warm up the lookup cache of CTextureCache at startup.
+   \param limit maximum number of textures to retrieve
+   \param textures [out] original url and record of each texture
+   \return true if successful, false otherwise
+   */
+  bool GetCachedTextures(unsigned int limit, std::vector< std::pair<CStdString, CTextureRecord> > &textures);
+
+  /*! \brief Add a cached texture, replacing any previous one for the url
+   \param originalURL url of the original image
+   \param details texture details, details.id is set to the id of the new texture
+   */
+  bool AddCachedTexture(const CStdString &originalURL, CTextureDetails &details);
   bool SetCachedTextureValid(const CStdString &originalURL, bool updateable);
   bool ClearCachedTexture(const CStdString &originalURL, CStdString &cacheFile);
   bool IncrementUseCount(const CTextureDetails &details);
@@ -71,6 +105,12 @@ public:
    */
   void ClearTextureForPath(const CStdString &url, const CStdString &type);
 
+  /*! \brief Check whether the image behind a texture should be checked for changes
+   \param lastCheck time the image hash was last checked, invalid if the image is never checked
+   \return true if the image hash should be returned to the caller for checking
+   */
+  static bool IsHashCheckDue(const CDateTime &lastCheck);
+
 protected:
   /*! \brief retrieve a hash for the given url
    Computes a hash of the current url to use for lookups in the database
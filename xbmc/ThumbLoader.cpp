@@ -37,17 +37,12 @@ CThumbLoader::~CThumbLoader()
 
 CStdString CThumbLoader::GetCachedImage(const CFileItem &item, const CStdString &type)
 {
-  CTextureDatabase db;
-  if (!item.GetPath().empty() && db.Open())
-    return db.GetTextureForPath(item.GetPath(), type);
-  return "";
+  return CTextureCache::Get().GetTextureForPath(item.GetPath(), type);
 }
 
 void CThumbLoader::SetCachedImage(const CFileItem &item, const CStdString &type, const CStdString &image)
 {
-  CTextureDatabase db;
-  if (!item.GetPath().empty() && db.Open())
-    db.SetTextureForPath(item.GetPath(), type, image);
+  CTextureCache::Get().SetTextureForPath(item.GetPath(), type, image);
 }
 
 CProgramThumbLoader::CProgramThumbLoader()
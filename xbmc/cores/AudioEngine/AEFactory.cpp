@@ -239,6 +239,14 @@ bool CAEFactory::SupportsRaw()
   return false;
 }
 
+bool CAEFactory::GetStats(AEStats &stats)
+{
+  if(AE)
+    return AE->GetStats(stats);
+
+  return false;
+}
+
 void CAEFactory::SetMute(const bool enabled)
 {
   if(AE)
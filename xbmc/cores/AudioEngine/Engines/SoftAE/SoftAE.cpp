@@ -73,7 +73,9 @@ CSoftAE::CSoftAE():
   m_convertedSize      (0           ),
   m_masterStream       (NULL        ),
   m_outputStageFn      (NULL        ),
-  m_streamStageFn      (NULL        )
+  m_streamStageFn      (NULL        ),
+  m_statsWindowStart   (0           ),
+  m_sinkTicks          (0           )
 {
   unsigned int c_retry = 5;
   CAESinkFactory::EnumerateEx(m_sinkInfoList);
@@ -945,6 +947,82 @@ double CSoftAE::GetCacheTotal()
   return timeBuffer + timeSink + timeTranscoder;
 }
 
+bool CSoftAE::GetStats(AEStats &stats)
+{
+  {
+    CSingleLock statsLock(m_statsLock);
+    stats = m_stats;
+  }
+
+  stats.passthrough = m_rawPassthrough;
+  stats.transcode   = m_transcode && !m_rawPassthrough;
+
+  {
+    CSingleLock streamLock(m_streamLock);
+    stats.streams = m_playingStreams.size();
+    if (m_masterStream)
+      stats.resampleRatio = m_masterStream->GetResampleRatio();
+  }
+
+  CSharedLock sinkLock(m_sinkLock);
+  if (stats.transcode && m_encoder)
+  {
+    stats.bufferedTime  = (double)m_buffer.Used() * m_frameSizeMul * m_encoderInitSampleRateMul;
+    stats.bufferedTotal = (double)m_buffer.Size() * m_frameSizeMul * m_encoderInitSampleRateMul;
+  }
+  else
+  {
+    stats.bufferedTime  = (double)m_buffer.Used() * m_frameSizeMul * m_sinkFormatSampleRateMul;
+    stats.bufferedTotal = (double)m_buffer.Size() * m_frameSizeMul * m_sinkFormatSampleRateMul;
+  }
+
+  if (m_sink)
+  {
+    stats.sink           = m_sink->GetName();
+    stats.sinkDelay      = m_sink->GetDelay();
+    stats.sinkCacheTime  = m_sink->GetCacheTime();
+    stats.sinkCacheTotal = m_sink->GetCacheTotal();
+    stats.underruns      = m_sink->GetUnderruns();
+  }
+
+  return true;
+}
+
+void CSoftAE::CStageTimer::Publish(AEStageTiming &timing, double usPerTick)
+{
+  timing.average = m_count ? (double)m_total / m_count * usPerTick : 0.0;
+  timing.max     = (double)m_max * usPerTick;
+  Reset();
+}
+
+void CSoftAE::PublishStats()
+{
+  const double usPerTick = 1000000.0 / CurrentHostFrequency();
+
+  CSingleLock statsLock(m_statsLock);
+  m_streamTimer.Publish(m_stats.streamStage, usPerTick);
+  m_outputTimer.Publish(m_stats.outputStage, usPerTick);
+  m_sinkTimer  .Publish(m_stats.sinkWrite  , usPerTick);
+}
+
+unsigned int CSoftAE::WriteSink(uint8_t *data, unsigned int frames, bool hasAudio)
+{
+  const int64_t start = CurrentHostCounter();
+  unsigned int wrote = m_sink->AddPackets(data, frames, hasAudio);
+  const int64_t ticks = CurrentHostCounter() - start;
+
+  m_sinkTimer.Add(ticks);
+  m_sinkTicks += ticks;
+
+  if (wrote == INT_MAX)
+  {
+    CSingleLock statsLock(m_statsLock);
+    m_stats.sinkErrors++;
+  }
+
+  return wrote;
+}
+
 bool CSoftAE::IsSuspended()
 {
   return m_isSuspended;
@@ -1061,12 +1139,22 @@ void CSoftAE::Run()
   CLog::Log(LOGINFO, "CSoftAE::Run - Thread Started");
 
   bool hasAudio = false;
+  m_statsWindowStart = CurrentHostCounter();
   while (m_running)
   {
     bool restart = false;
 
     /* with the new non blocking implementation - we just reOpen here, when it tells reOpen */
-    if ((this->*m_outputStageFn)(hasAudio) > 0)
+    m_sinkTicks = 0;
+    int64_t stageStart = CurrentHostCounter();
+    int wrote = (this->*m_outputStageFn)(hasAudio);
+    int64_t stageEnd = CurrentHostCounter();
+
+    /* only account passes that did something, the stage is polled until a full packet is buffered */
+    if (wrote > 0 || m_sinkTicks > 0)
+      m_outputTimer.Add(stageEnd - stageStart - m_sinkTicks);
+
+    if (wrote > 0)
       hasAudio = false; /* taken some audio - reset our silence flag */
 
     /* if we have enough room in the buffer */
@@ -1078,14 +1166,23 @@ void CSoftAE::Run()
 
       /* run the stream stage */
       CSoftAEStream *oldMaster = m_masterStream;
+      stageStart = CurrentHostCounter();
       if ((this->*m_streamStageFn)(m_chLayout.Count(), out, restart) > 0)
         hasAudio = true; /* have some audio */
+      stageEnd = CurrentHostCounter();
+      m_streamTimer.Add(stageEnd - stageStart);
 
       /* if in audiophile mode and the master stream has changed, flag for restart */
       if (m_audiophile && oldMaster != m_masterStream)
         restart = true;
     }
 
+    if (stageEnd - m_statsWindowStart >= CurrentHostFrequency())
+    {
+      PublishStats();
+      m_statsWindowStart = stageEnd;
+    }
+
     /* Handle idle or forced suspend */
     ProcessSuspend();
 
@@ -1154,13 +1251,7 @@ unsigned int CSoftAE::MixSounds(float *buffer, unsigned int samples)
 
     float volume = ss->owner->GetVolume();
     unsigned int mixSamples = std::min(ss->sampleCount, samples);
-    #ifdef __SSE__
-      CAEUtil::SSEMulAddArray(out, ss->samples, volume, mixSamples);
-    #else
-      float *sample_buffer = ss->samples;
-      for (unsigned int i = 0; i < mixSamples; ++i)
-        *out++ += *sample_buffer++ * volume;
-    #endif
+    CAEUtil::MulAddArray(out, ss->samples, volume, mixSamples);
 
     ss->sampleCount -= mixSamples;
     ss->samples     += mixSamples;
@@ -1188,15 +1279,7 @@ bool CSoftAE::FinalizeSamples(float *buffer, unsigned int samples, bool hasAudio
 
   /* deamplify */
   if (!m_sinkHandlesVolume && m_volume < 1.0)
-  {
-    #ifdef __SSE__
-      CAEUtil::SSEMulArray(buffer, m_volume, samples);
-    #else
-      float *fbuffer = buffer;
-      for (unsigned int i = 0; i < samples; i++)
-        *fbuffer++ *= m_volume;
-    #endif
-  }
+    CAEUtil::MulArray(buffer, m_volume, samples);
 
   /* check if we need to clamp */
   bool clamp = false;
@@ -1241,7 +1324,7 @@ int CSoftAE::RunOutputStage(bool hasAudio)
 
   /* Output frames to sink */
   if (m_sink)
-    wroteFrames = m_sink->AddPackets((uint8_t*)data, m_sinkFormat.m_frames, hasAudio);
+    wroteFrames = WriteSink((uint8_t*)data, m_sinkFormat.m_frames, hasAudio);
 
   /* Return value of INT_MAX signals error in sink - restart */
   if (wroteFrames == INT_MAX)
@@ -1284,7 +1367,7 @@ int CSoftAE::RunRawOutputStage(bool hasAudio)
 
   int wroteFrames = 0;
   if (m_sink)
-    wroteFrames = m_sink->AddPackets((uint8_t *)data, m_sinkFormat.m_frames, hasAudio);
+    wroteFrames = WriteSink((uint8_t *)data, m_sinkFormat.m_frames, hasAudio);
 
   /* Return value of INT_MAX signals error in sink - restart */
   if (wroteFrames == INT_MAX)
@@ -1338,7 +1421,7 @@ int CSoftAE::RunTranscodeStage(bool hasAudio)
   /* if we have enough data to write */
   if (m_encodedBuffer.Used() >= sinkBlock)
   {
-    int wroteFrames = m_sink->AddPackets((uint8_t*)m_encodedBuffer.Raw(sinkBlock), m_sinkFormat.m_frames, hasAudio);
+    int wroteFrames = WriteSink((uint8_t*)m_encodedBuffer.Raw(sinkBlock), m_sinkFormat.m_frames, hasAudio);
     
     /* Return value of INT_MAX signals error in sink - restart */
     if (wroteFrames == INT_MAX)
@@ -1441,15 +1524,7 @@ unsigned int CSoftAE::RunStreamStage(unsigned int channelCount, void *out, bool
       continue;
 
     float volume = stream->GetVolume() * stream->GetReplayGain() * stream->RunLimiter(frame, channelCount);
-    #ifdef __SSE__
-    if (channelCount > 1)
-      CAEUtil::SSEMulAddArray(dst, frame, volume, channelCount);
-    else
-    #endif
-    {
-      for (unsigned int i = 0; i < channelCount; ++i)
-        *dst++ += *frame++ * volume;
-    }
+    CAEUtil::MulAddArray(dst, frame, volume, channelCount);
 
     ++mixed;
   }
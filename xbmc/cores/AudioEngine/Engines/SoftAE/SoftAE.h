@@ -101,6 +101,7 @@ public:
   virtual void EnumerateOutputDevices(AEDeviceList &devices, bool passthrough);
   virtual std::string GetDefaultDevice(bool passthrough);
   virtual bool SupportsRaw();
+  virtual bool GetStats(AEStats &stats);
 
   /* internal stream methods */
   void PauseStream (CSoftAEStream *stream);
@@ -151,6 +152,7 @@ private:
   CCriticalSection m_soundSampleLock; /* m_playing_sounds lock */
   CSharedSection   m_sinkLock;        /* lock for m_sink on re-open */
   CCriticalSection m_threadLock;      /* locked while starting/stopping the thread */
+  CCriticalSection m_statsLock;       /* m_stats lock */
 
   /* the current configuration */
   float               m_volume;
@@ -245,5 +247,30 @@ private:
 
   void         RemoveStream(StreamList &streams, CSoftAEStream *stream);
   void         PrintSinks();
+
+  /* stage timing, accumulated by the engine thread and published to m_stats once per window */
+  class CStageTimer
+  {
+  public:
+    CStageTimer() { Reset(); }
+    void Add(int64_t ticks) { m_total += ticks; m_count++; if (ticks > m_max) m_max = ticks; }
+    void Publish(AEStageTiming &timing, double usPerTick);
+    void Reset() { m_total = m_max = 0; m_count = 0; }
+  private:
+    int64_t      m_total;
+    int64_t      m_max;
+    unsigned int m_count;
+  };
+
+  AEStats      m_stats;
+  CStageTimer  m_streamTimer, m_outputTimer, m_sinkTimer;
+  int64_t      m_statsWindowStart;
+  int64_t      m_sinkTicks; /* time spent in the sink during the current output stage */
+
+  /*! \brief Write a packet to the sink, timing how long it blocks
+   \return the number of frames taken by the sink, INT_MAX on sink error
+   */
+  unsigned int WriteSink(uint8_t *data, unsigned int frames, bool hasAudio);
+  void         PublishStats();
 };
 
@@ -22,6 +22,7 @@
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/MathUtils.h"
+#include "settings/AdvancedSettings.h"
 
 #include "AEFactory.h"
 #include "Utils/AEUtil.h"
@@ -44,7 +45,9 @@ CSoftAEStream::CSoftAEStream(enum AEDataFormat dataFormat, unsigned int sampleRa
   m_rgain           (1.0f ),
   m_refillBuffer    (0    ),
   m_convertFn       (NULL ),
-  m_ssrc            (NULL ),
+  m_resampler       (NULL ),
+  m_resampleBuffer  (NULL ),
+  m_resampleFrames  (0    ),
   m_framesBuffered  (0    ),
   m_newPacket       (NULL ),
   m_packet          (NULL ),
@@ -55,8 +58,6 @@ CSoftAEStream::CSoftAEStream(enum AEDataFormat dataFormat, unsigned int sampleRa
   m_fadeRunning     (false),
   m_slave           (NULL )
 {
-  m_ssrcData.data_out = NULL;
-
   m_initDataFormat        = dataFormat;
   m_initSampleRate        = sampleRate;
   m_initEncodedSampleRate = encodedSampleRate;
@@ -107,8 +108,10 @@ void CSoftAEStream::Initialize()
 
     if (m_resample)
     {
-      _aligned_free(m_ssrcData.data_out);
-      m_ssrcData.data_out = NULL;
+      _aligned_free(m_resampleBuffer);
+      m_resampleBuffer = NULL;
+      delete m_resampler;
+      m_resampler = NULL;
     }
   }
 
@@ -188,14 +191,19 @@ void CSoftAEStream::Initialize()
   /* if we need to resample, set it up */
   if (m_resample)
   {
-    int err;
-    m_ssrc                   = src_new(SRC_SINC_MEDIUM_QUALITY, m_initChannelLayout.Count(), &err);
-    m_ssrcData.data_in       = m_convertBuffer;
-    m_internalRatio          = (double)AE.GetSampleRate() / (double)m_initSampleRate;
-    m_ssrcData.src_ratio     = m_internalRatio;
-    m_ssrcData.data_out      = (float*)_aligned_malloc(m_format.m_frameSamples * (int)std::ceil(m_ssrcData.src_ratio) * sizeof(float), 16);
-    m_ssrcData.output_frames = m_format.m_frames * (long)std::ceil(m_ssrcData.src_ratio);
-    m_ssrcData.end_of_input  = 0;
+    /* streams that only resample to follow the clock can use a different engine */
+    const CStdString &engine = m_initSampleRate == AE.GetSampleRate() ? g_advancedSettings.m_audioSyncResampler : g_advancedSettings.m_audioResampler;
+    AEResampleQuality quality = CAEResamplerFactory::GetQuality(engine, AE_RESAMPLE_SRC_MEDIUM);
+    CLog::Log(LOGDEBUG, "CSoftAEStream::Initialize - Resampling %u -> %u using the %s resampler", m_initSampleRate, AE.GetSampleRate(), engine.c_str());
+
+    m_internalRatio = (double)AE.GetSampleRate() / (double)m_initSampleRate;
+    m_resampler     = CAEResamplerFactory::Create(quality);
+    if (!m_resampler->Initialize(m_initChannelLayout.Count(), m_internalRatio))
+    {
+      m_valid = false;
+      return;
+    }
+    AllocResampleBuffer();
     // we must buffer the same amount as before but taking the source sample rate into account
     // there is no reason to decrease the buffer for upsampling
     if (m_internalRatio < 1)
@@ -228,9 +236,9 @@ CSoftAEStream::~CSoftAEStream()
 
   if (m_resample)
   {
-    _aligned_free(m_ssrcData.data_out);
-    src_delete(m_ssrc);
-    m_ssrc = NULL;
+    _aligned_free(m_resampleBuffer);
+    delete m_resampler;
+    m_resampler = NULL;
   }
 
   delete m_newPacket;
@@ -329,12 +337,11 @@ unsigned int CSoftAEStream::ProcessFrameBuffer()
   /* resample it if we need to */
   if (m_resample)
   {
-    m_ssrcData.input_frames = samples / m_chLayoutCount;
-    if (src_process(m_ssrc, &m_ssrcData) != 0)
+    unsigned int used;
+    if (!m_resampler->Process(m_convertBuffer, samples / m_chLayoutCount, m_resampleBuffer, m_resampleFrames, used, frames))
       return 0;
-    data     = (uint8_t*)m_ssrcData.data_out;
-    frames   = m_ssrcData.output_frames_gen;
-    consumed = m_ssrcData.input_frames_used * m_bytesPerFrame;
+    data     = (uint8_t*)m_resampleBuffer;
+    consumed = used * m_bytesPerFrame;
     if (!frames)
       return consumed;
 
@@ -560,10 +567,7 @@ void CSoftAEStream::InternalFlush()
 {
   /* reset the resampler */
   if (m_resample)
-  {
-    m_ssrcData.end_of_input = 0;
-    src_reset(m_ssrc);
-  }
+    m_resampler->Reset();
 
   /* invalidate any incoming samples */
   m_newPacket->data.Empty();
@@ -595,7 +599,7 @@ double CSoftAEStream::GetResampleRatio()
     return 1.0f;
 
   CSharedLock lock(m_lock);
-  return m_ssrcData.src_ratio;
+  return m_resampler->GetRatio();
 }
 
 bool CSoftAEStream::SetResampleRatio(double ratio)
@@ -605,23 +609,27 @@ bool CSoftAEStream::SetResampleRatio(double ratio)
 
   CSharedLock lock(m_lock);
 
-  int oldRatioInt = (int)std::ceil(m_ssrcData.src_ratio);
+  int oldRatioInt = (int)std::ceil(m_resampler->GetRatio());
 
   m_resampleRatio = ratio;
-
-  src_set_ratio(m_ssrc, m_resampleRatio * m_internalRatio);
-  m_ssrcData.src_ratio = m_resampleRatio * m_internalRatio;
+  m_resampler->SetRatio(m_resampleRatio * m_internalRatio);
 
   //Check the resample buffer size and resize if necessary.
-  if (oldRatioInt < std::ceil(m_ssrcData.src_ratio))
+  if (oldRatioInt < std::ceil(m_resampler->GetRatio()))
   {
-    _aligned_free(m_ssrcData.data_out);
-    m_ssrcData.data_out      = (float*)_aligned_malloc(m_format.m_frameSamples * (int)std::ceil(m_ssrcData.src_ratio) * sizeof(float), 16);
-    m_ssrcData.output_frames = m_format.m_frames * (long)std::ceil(m_ssrcData.src_ratio);
+    _aligned_free(m_resampleBuffer);
+    AllocResampleBuffer();
   }
   return true;
 }
 
+void CSoftAEStream::AllocResampleBuffer()
+{
+  const double ratio = std::ceil(m_resampler->GetRatio());
+  m_resampleBuffer = (float*)_aligned_malloc(m_format.m_frameSamples * (int)ratio * sizeof(float), 16);
+  m_resampleFrames = m_format.m_frames * (unsigned int)ratio;
+}
+
 void CSoftAEStream::RegisterAudioCallback(IAudioCallback* pCallback)
 {
   CExclusiveLock lock(m_lock);
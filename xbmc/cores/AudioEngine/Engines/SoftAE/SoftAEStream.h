@@ -19,7 +19,6 @@
  *
  */
 
-#include <samplerate.h>
 #include <list>
 
 #include "threads/SharedSection.h"
@@ -30,6 +29,7 @@
 #include "Utils/AERemap.h"
 #include "Utils/AEBuffer.h"
 #include "Utils/AELimiter.h"
+#include "Utils/AEResampler.h"
 
 class IAEPostProc;
 class CSoftAEStream : public IAEStream
@@ -90,6 +90,7 @@ public:
 private:
   void InternalFlush();
   void CheckResampleBuffers();
+  void AllocResampleBuffer();
 
   CSharedSection    m_lock;
   enum AEDataFormat m_initDataFormat;
@@ -128,8 +129,9 @@ private:
   unsigned int        m_samplesPerFrame;
   CAEChannelInfo      m_aeChannelLayout;
   unsigned int        m_aeBytesPerFrame;
-  SRC_STATE          *m_ssrc;
-  SRC_DATA            m_ssrcData;
+  IAEResampler       *m_resampler;
+  float              *m_resampleBuffer;
+  unsigned int        m_resampleFrames;
   unsigned int        m_framesBuffered;
   std::list<PPacket*> m_outBuffer;
   unsigned int        ProcessFrameBuffer();
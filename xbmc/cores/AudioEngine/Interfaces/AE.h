@@ -21,6 +21,7 @@
 
 #include <list>
 #include <map>
+#include <string>
 
 #include "system.h"
 #include "threads/CriticalSection.h"
@@ -40,6 +41,54 @@ class IAEPacketizer;
 #define AE_SOUND_IDLE   1 /* only play sounds while no streams are running */
 #define AE_SOUND_ALWAYS 2 /* always play sounds */
 
+/**
+ * Processing time of one engine stage over the last statistics window, in microseconds
+ */
+struct AEStageTiming
+{
+  AEStageTiming() : average(0.0), max(0.0) {}
+  double average;
+  double max;
+};
+
+/**
+ * Snapshot of the engine buffering and timing counters, see IAE::GetStats
+ */
+struct AEStats
+{
+  AEStats() :
+    passthrough   (false),
+    transcode     (false),
+    streams       (0    ),
+    resampleRatio (1.0  ),
+    bufferedTime  (0.0  ),
+    bufferedTotal (0.0  ),
+    sinkDelay     (0.0  ),
+    sinkCacheTime (0.0  ),
+    sinkCacheTotal(0.0  ),
+    underruns     (0    ),
+    sinkErrors    (0    )
+  {}
+
+  std::string   sink;           /* name of the open sink, empty if none */
+  bool          passthrough;
+  bool          transcode;
+  unsigned int  streams;        /* number of playing streams */
+  double        resampleRatio;  /* ratio applied to the master stream for A/V sync */
+
+  double        bufferedTime;   /* seconds of audio queued in the engine */
+  double        bufferedTotal;  /* size of the engine queue in seconds */
+  double        sinkDelay;      /* seconds until the next packet added to the sink is heard */
+  double        sinkCacheTime;  /* seconds of audio queued in the sink */
+  double        sinkCacheTotal; /* size of the sink cache in seconds */
+  unsigned int  underruns;      /* underruns reported by the sink since it was opened */
+  unsigned int  sinkErrors;     /* sink reopens caused by write errors since the engine started */
+
+  AEStageTiming streamStage;    /* mixing the streams into the engine buffer */
+  AEStageTiming outputStage;    /* finalizing and converting a sink packet */
+  AEStageTiming sinkWrite;      /* blocked in IAESink::AddPackets */
+};
+
 /**
  * IAE Interface
  */
@@ -183,5 +232,12 @@ public:
    * @returns true if the AudioEngine is capable of RAW output
    */
   virtual bool SupportsRaw() { return false; }
+
+  /**
+   * Returns the engine buffering and timing counters, used to diagnose dropouts
+   * @param stats The structure to fill
+   * @return false if the engine does not collect statistics
+   */
+  virtual bool GetStats(AEStats &stats) { return false; }
 };
 
@@ -99,5 +99,11 @@ public:
     @return false if sink must be reinitialized
   */
   virtual bool SoftResume() {return false;};
+
+  /*
+    Returns the number of underruns the device reported since the sink was initialized,
+    sinks that cannot detect underruns return 0.
+  */
+  virtual unsigned int GetUnderruns() {return 0;};
 };
 
@@ -66,7 +66,8 @@ static unsigned int ALSASampleRateList[] =
 };
 
 CAESinkALSA::CAESinkALSA() :
-  m_pcm(NULL)
+  m_pcm      (NULL),
+  m_underruns(0   )
 {
   /* ensure that ALSA has been initialized */
   if (!snd_config)
@@ -130,6 +131,7 @@ bool CAESinkALSA::Initialize(AEAudioFormat &format, std::string &device)
 {
   m_initDevice = device;
   m_initFormat = format;
+  m_underruns  = 0;
 
   /* if we are raw, correct the data format */
   if (AE_IS_RAW(format.m_dataFormat))
@@ -553,6 +555,7 @@ void CAESinkALSA::HandleError(const char* name, int err)
   {
     case -EPIPE:
       CLog::Log(LOGERROR, "CAESinkALSA::HandleError(%s) - underrun", name);
+      ++m_underruns;
       if ((err = snd_pcm_prepare(m_pcm)) < 0)
         CLog::Log(LOGERROR, "CAESinkALSA::HandleError(%s) - snd_pcm_prepare returned %d (%s)", name, err, snd_strerror(err));
       break;
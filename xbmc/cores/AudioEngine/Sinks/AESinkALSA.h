@@ -51,6 +51,7 @@ public:
   virtual void         Drain           ();
   virtual bool         SoftSuspend();
   virtual bool         SoftResume();
+  virtual unsigned int GetUnderruns() { return m_underruns; }
 
   static void EnumerateDevicesEx(AEDeviceInfoList &list, bool force = false);
 private:
@@ -68,6 +69,7 @@ private:
   std::string       m_device;
   snd_pcm_t        *m_pcm;
   int               m_timeout;
+  unsigned int      m_underruns;
 
   static snd_pcm_format_t AEFormatToALSAFormat(const enum AEDataFormat format);
 
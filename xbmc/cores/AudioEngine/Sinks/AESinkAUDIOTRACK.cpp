@@ -71,7 +71,6 @@ CAESinkAUDIOTRACK::CAESinkAUDIOTRACK()
   : CThread("audiotrack")
 {
   m_sinkbuffer = NULL;
-  m_alignedS16LE = NULL;
 #if defined(HAS_AMLPLAYER)
   aml_cpufreq_limit(true);
 #endif
@@ -145,8 +144,6 @@ void CAESinkAUDIOTRACK::Deinitialize()
   m_wake.Set();
   StopThread();
   delete m_sinkbuffer, m_sinkbuffer = NULL;
-  if (m_alignedS16LE)
-    _aligned_free(m_alignedS16LE), m_alignedS16LE = NULL;
 }
 
 bool CAESinkAUDIOTRACK::IsCompatible(const AEAudioFormat format, const std::string device)
@@ -197,13 +194,24 @@ unsigned int CAESinkAUDIOTRACK::AddPackets(uint8_t *data, unsigned int frames, b
         break;
 #if defined(__ARM_NEON__)
       case AE_FMT_FLOAT:
-        if (!m_alignedS16LE)
-          m_alignedS16LE = (int16_t*)_aligned_malloc(m_format.m_frames * m_sink_frameSize, 16);
-        // neon convert AE_FMT_S16LE to AE_FMT_FLOAT
-        pa_sconv_s16le_from_f32ne_neon(write_frames * m_format.m_channelLayout.Count(), (const float32_t *)data, m_alignedS16LE);
-        m_sinkbuffer->Write((unsigned char*)m_alignedS16LE, write_frames * m_sink_frameSize);
+      {
+        // neon convert AE_FMT_FLOAT to AE_FMT_S16LE directly into the sink buffer
+        const float32_t *src  = (const float32_t *)data;
+        unsigned int     left = write_frames * m_sink_frameSize;
+        while (left)
+        {
+          unsigned int space;
+          int16_t *dst = (int16_t*)m_sinkbuffer->GetWritePtr(space);
+          space = std::min(space, left);
+          unsigned int samples = space / sizeof(int16_t);
+          pa_sconv_s16le_from_f32ne_neon(samples, src, dst);
+          m_sinkbuffer->CommitWrite(space);
+          src  += samples;
+          left -= space;
+        }
         m_wake.Set();
         break;
+      }
 #endif
       default:
         break;
@@ -328,13 +336,7 @@ void CAESinkAUDIOTRACK::Process()
     }
     if (m_draining)
     {
-      unsigned char byte_drain[1024];
-      unsigned int  byte_drain_size = m_sinkbuffer->GetReadSize() % 1024;
-      while (byte_drain_size)
-      {
-        m_sinkbuffer->Read(byte_drain, byte_drain_size);
-        byte_drain_size = m_sinkbuffer->GetReadSize() % 1024;
-      }
+      m_sinkbuffer->Reset();
       jenv->CallVoidMethod(joAudioTrack, jmStop);
       jenv->CallVoidMethod(joAudioTrack, jmFlush);
     }
@@ -121,7 +121,8 @@ CAESinkDirectSound::CAESinkDirectSound() :
   m_CacheLen      (0    ),
   m_dwChunkSize   (0    ),
   m_dwBufferLen   (0    ),
-  m_BufferTimeouts(0    )
+  m_BufferTimeouts(0    ),
+  m_underruns     (0    )
 {
   m_channelLayout.Reset();
 }
@@ -719,6 +720,7 @@ bool CAESinkDirectSound::UpdateCacheStatus()
   {
     CLog::Log(LOGWARNING, "CWin32DirectSound::GetSpace - buffer underrun - W:%u, P:%u, O:%u.", writeCursor, playCursor, m_BufferOffset);
     m_BufferOffset = writeCursor; // Catch up
+    m_underruns++;
     //m_pBuffer->Stop(); // Wait until someone gives us some data to restart playback (prevents glitches)
     m_BufferTimeouts++;
     if (m_BufferTimeouts > 10)
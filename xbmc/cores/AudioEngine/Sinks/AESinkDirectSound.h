@@ -45,6 +45,7 @@ public:
   virtual unsigned int AddPackets         (uint8_t *data, unsigned int frames, bool hasAudio);
   virtual bool         SoftSuspend        ();
   virtual bool         SoftResume         ();
+  virtual unsigned int GetUnderruns       () { return m_underruns; }
   static  std::string  GetDefaultDevice   ();
   static  void         EnumerateDevicesEx (AEDeviceInfoList &deviceInfoList, bool force = false);
 private:
@@ -75,6 +76,7 @@ private:
   unsigned int        m_CacheLen;
   unsigned int        m_LastCacheCheck;
   unsigned int        m_BufferTimeouts;
+  unsigned int        m_underruns;
 
   bool                m_running;
   bool                m_initialized;
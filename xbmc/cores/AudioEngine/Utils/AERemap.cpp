@@ -26,11 +26,17 @@
 #include "utils/log.h"
 #include "settings/GUISettings.h"
 
+#if defined(__ARM_NEON__)
+#include <arm_neon.h>
+#include "utils/CPUInfo.h"
+#endif
+
 using namespace std;
 
-CAERemap::CAERemap() : m_inChannels(0), m_outChannels(0) 
+CAERemap::CAERemap() : m_inChannels(0), m_outChannels(0), m_stride(0)
 {
   memset(m_mixInfo, 0, sizeof(m_mixInfo));
+  memset(m_matrix, 0, sizeof(m_matrix));
 }
 
 CAERemap::~CAERemap()
@@ -87,7 +93,10 @@ bool CAERemap::Initialize(CAEChannelInfo input, CAEChannelInfo output, bool fina
 
   /* the final stage does not need any down/upmix */
   if (finalStage)
+  {
+    BuildMatrix();
     return true;
+  }
 
   /* downmix from the specified channel to the specified list of channels */
   #define RM(from, ...) \
@@ -253,6 +262,7 @@ bool CAERemap::Initialize(CAEChannelInfo input, CAEChannelInfo output, bool fina
   CLog::Log(LOGINFO, "====================\n");
 #endif
 
+  BuildMatrix();
   return true;
 }
 
@@ -293,8 +303,56 @@ void CAERemap::ResolveMix(const AEChannel from, CAEChannelInfo to)
   fromInfo->in_src   = false;
 }
 
-/* This method has unrolled loop for higher performance */
+void CAERemap::BuildMatrix()
+{
+  /*
+    flatten the mix info into a dense matrix stored per input channel, so
+    every input sample is multiplied against a contiguous vector holding
+    its contribution to each output channel
+  */
+  m_stride = (m_outChannels + 3) & ~0x3;
+  memset(m_matrix, 0, sizeof(m_matrix));
+
+  for (int o = 0; o < m_outChannels; ++o)
+  {
+    const AEMixInfo *info = &m_mixInfo[m_output[o]];
+    if (!info->in_dst)
+      continue;
+
+    /* if there is only 1 source, just copy it so we dont break DPL */
+    if (info->srcCount == 1)
+    {
+      m_matrix[info->srcIndex[0].index * m_stride + o] = 1.0f;
+      continue;
+    }
+
+    for (int i = 0; i < info->srcCount; ++i)
+      m_matrix[info->srcIndex[i].index * m_stride + o] += info->srcIndex[i].level;
+  }
+}
+
 void CAERemap::Remap(float * const in, float * const out, const unsigned int frames) const
+{
+#if defined(__SSE__)
+  if (m_outChannels <= 8)
+  {
+    RemapSSE(in, out, frames);
+    return;
+  }
+#elif defined(__ARM_NEON__)
+  if (m_outChannels <= 8 && (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_NEON))
+  {
+    RemapNEON(in, out, frames);
+    return;
+  }
+#endif
+
+  /* no kernel for this build or layout */
+  RemapSparse(in, out, frames);
+}
+
+/* This method has unrolled loop for higher performance */
+void CAERemap::RemapSparse(float * const in, float * const out, const unsigned int frames) const
 {
   const unsigned int frameBlocks = frames & ~0x3;
 
@@ -380,6 +438,81 @@ void CAERemap::Remap(float * const in, float * const out, const unsigned int fra
   }
 }
 
+#if defined(__SSE__)
+void CAERemap::RemapSSE(float * const in, float * const out, const unsigned int frames) const
+{
+  MEMALIGN(16, float frame[8]);
+  const float *src = in;
+  float       *dst = out;
+
+  for (unsigned int f = 0; f < frames; ++f, src += m_inChannels, dst += m_outChannels)
+  {
+    __m128 lo = _mm_setzero_ps();
+    __m128 hi = _mm_setzero_ps();
+    const float *mtx = m_matrix;
+    for (int i = 0; i < m_inChannels; ++i, mtx += m_stride)
+    {
+      const __m128 sample = _mm_set1_ps(src[i]);
+      lo = _mm_add_ps(lo, _mm_mul_ps(sample, _mm_loadu_ps(mtx)));
+      if (m_stride > 4)
+        hi = _mm_add_ps(hi, _mm_mul_ps(sample, _mm_loadu_ps(mtx + 4)));
+    }
+
+    switch (m_outChannels)
+    {
+      case 2:
+        _mm_storel_pi((__m64*)dst, lo);
+        break;
+      case 4:
+        _mm_storeu_ps(dst, lo);
+        break;
+      case 8:
+        _mm_storeu_ps(dst    , lo);
+        _mm_storeu_ps(dst + 4, hi);
+        break;
+      default:
+        _mm_store_ps(frame    , lo);
+        _mm_store_ps(frame + 4, hi);
+        memcpy(dst, frame, m_outChannels * sizeof(float));
+        break;
+    }
+  }
+}
+#endif
+
+#if defined(__ARM_NEON__)
+void CAERemap::RemapNEON(float * const in, float * const out, const unsigned int frames) const
+{
+  float frame[8];
+  const float *src = in;
+  float       *dst = out;
+
+  for (unsigned int f = 0; f < frames; ++f, src += m_inChannels, dst += m_outChannels)
+  {
+    float32x4_t lo = vdupq_n_f32(0.0f);
+    float32x4_t hi = vdupq_n_f32(0.0f);
+    const float *mtx = m_matrix;
+    for (int i = 0; i < m_inChannels; ++i, mtx += m_stride)
+    {
+      /* separate multiply and add (not vmla) to stay bit exact with the scalar path */
+      const float32x4_t sample = vdupq_n_f32(src[i]);
+      lo = vaddq_f32(lo, vmulq_f32(sample, vld1q_f32(mtx)));
+      if (m_stride > 4)
+        hi = vaddq_f32(hi, vmulq_f32(sample, vld1q_f32(mtx + 4)));
+    }
+
+    if (m_outChannels == 2)
+      vst1_f32(dst, vget_low_f32(lo));
+    else
+    {
+      vst1q_f32(frame    , lo);
+      vst1q_f32(frame + 4, hi);
+      memcpy(dst, frame, m_outChannels * sizeof(float));
+    }
+  }
+}
+#endif
+
 inline void CAERemap::BuildUpmixMatrix(const CAEChannelInfo& input, const CAEChannelInfo& output)
 {
   #define UM(from, to) \
@@ -20,6 +20,7 @@
  */
 
 #include "cores/AudioEngine/AEAudioFormat.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
 
 class CAERemap {
 public:
@@ -29,6 +30,10 @@ public:
   bool Initialize(CAEChannelInfo input, CAEChannelInfo output, bool finalStage, bool forceNormalize = false, enum AEStdChLayout stdChLayout = AE_CH_LAYOUT_INVALID);
   void Remap(float * const in, float * const out, const unsigned int frames) const;
 
+  /* plain C implementation over the sparse mix info, used when the build has
+     no vector kernel or there are more than 8 output channels */
+  void RemapSparse(float * const in, float * const out, const unsigned int frames) const;
+
 private:
   typedef struct {
     int       index;
@@ -49,7 +54,18 @@ private:
   int            m_inChannels;
   int            m_outChannels;
 
+  /* dense mix matrix, one row of m_stride output levels per input channel */
+  float          m_matrix[AE_CH_MAX * ((AE_CH_MAX + 3) & ~0x3)];
+  int            m_stride;
+
   void ResolveMix(const AEChannel from, CAEChannelInfo to);
   void BuildUpmixMatrix(const CAEChannelInfo& input, const CAEChannelInfo& output);
+  void BuildMatrix();
+#if defined(__SSE__)
+  void RemapSSE (float * const in, float * const out, const unsigned int frames) const;
+#endif
+#if defined(__ARM_NEON__)
+  void RemapNEON(float * const in, float * const out, const unsigned int frames) const;
+#endif
 };
 
@@ -0,0 +1,341 @@
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "AEResampler.h"
+#include "AEUtil.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+
+#include <math.h>
+#include <string.h>
+#include <stdlib.h>
+#include <algorithm>
+
+#if defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+/* filter length in input frames, must be a multiple of 4 */
+#define SINC_TAPS   32
+/* number of precomputed fractional positions */
+#define SINC_PHASES 256
+
+IAEResampler* CAEResamplerFactory::Create(enum AEResampleQuality quality)
+{
+  switch (quality)
+  {
+    case AE_RESAMPLE_LINEAR    : return new CAEResamplerLinear();
+    case AE_RESAMPLE_SINC      : return new CAEResamplerSinc();
+    case AE_RESAMPLE_SRC_FAST  : return new CAEResamplerSRC(SRC_SINC_FASTEST);
+    case AE_RESAMPLE_SRC_BEST  : return new CAEResamplerSRC(SRC_SINC_BEST_QUALITY);
+    case AE_RESAMPLE_SRC_MEDIUM:
+    default:
+      return new CAEResamplerSRC(SRC_SINC_MEDIUM_QUALITY);
+  }
+}
+
+AEResampleQuality CAEResamplerFactory::GetQuality(const std::string &name, enum AEResampleQuality fallback)
+{
+  if (StringUtils::EqualsNoCase(name, "linear")) return AE_RESAMPLE_LINEAR;
+  if (StringUtils::EqualsNoCase(name, "sinc"  )) return AE_RESAMPLE_SINC;
+  if (StringUtils::EqualsNoCase(name, "fast"  )) return AE_RESAMPLE_SRC_FAST;
+  if (StringUtils::EqualsNoCase(name, "medium")) return AE_RESAMPLE_SRC_MEDIUM;
+  if (StringUtils::EqualsNoCase(name, "best"  )) return AE_RESAMPLE_SRC_BEST;
+
+  if (!name.empty())
+    CLog::Log(LOGWARNING, "CAEResamplerFactory::GetQuality - Unknown resampler \"%s\"", name.c_str());
+  return fallback;
+}
+
+/* libsamplerate */
+
+CAEResamplerSRC::CAEResamplerSRC(int converter) :
+  m_converter(converter),
+  m_state    (NULL)
+{
+  memset(&m_data, 0, sizeof(m_data));
+}
+
+CAEResamplerSRC::~CAEResamplerSRC()
+{
+  if (m_state)
+    src_delete(m_state);
+}
+
+bool CAEResamplerSRC::Initialize(unsigned int channels, double ratio)
+{
+  int err;
+  m_state = src_new(m_converter, channels, &err);
+  if (!m_state)
+  {
+    CLog::Log(LOGERROR, "CAEResamplerSRC::Initialize - src_new failed: %s", src_strerror(err));
+    return false;
+  }
+
+  m_data.src_ratio    = ratio;
+  m_data.end_of_input = 0;
+  return true;
+}
+
+void CAEResamplerSRC::SetRatio(double ratio)
+{
+  src_set_ratio(m_state, ratio);
+  m_data.src_ratio = ratio;
+}
+
+bool CAEResamplerSRC::Process(float *in, unsigned int inFrames, float *out, unsigned int outFrames, unsigned int &inUsed, unsigned int &outGenerated)
+{
+  m_data.data_in       = in;
+  m_data.input_frames  = inFrames;
+  m_data.data_out      = out;
+  m_data.output_frames = outFrames;
+  if (src_process(m_state, &m_data) != 0)
+    return false;
+
+  inUsed       = m_data.input_frames_used;
+  outGenerated = m_data.output_frames_gen;
+  return true;
+}
+
+void CAEResamplerSRC::Reset()
+{
+  m_data.end_of_input = 0;
+  src_reset(m_state);
+}
+
+/* linear */
+
+CAEResamplerLinear::CAEResamplerLinear() :
+  m_channels(0  ),
+  m_ratio   (1.0),
+  m_pos     (0.0)
+{
+}
+
+bool CAEResamplerLinear::Initialize(unsigned int channels, double ratio)
+{
+  m_channels = channels;
+  m_ratio    = ratio;
+  Reset();
+  return true;
+}
+
+bool CAEResamplerLinear::Process(float *in, unsigned int inFrames, float *out, unsigned int outFrames, unsigned int &inUsed, unsigned int &outGenerated)
+{
+  const double step = 1.0 / m_ratio;
+
+  /* m_pos counts from the last frame of the previous call */
+  outGenerated = 0;
+  while (outGenerated < outFrames && m_pos < inFrames)
+  {
+    const unsigned int i    = (unsigned int)m_pos;
+    const float        frac = (float)(m_pos - i);
+    const float       *a    = i == 0 ? &m_last[0] : in + (i - 1) * m_channels;
+    const float       *b    = in + i * m_channels;
+
+    for (unsigned int c = 0; c < m_channels; ++c)
+      *out++ = a[c] + (b[c] - a[c]) * frac;
+
+    m_pos += step;
+    ++outGenerated;
+  }
+
+  inUsed = std::min(inFrames, (unsigned int)m_pos);
+  if (inUsed > 0)
+  {
+    memcpy(&m_last[0], in + (inUsed - 1) * m_channels, m_channels * sizeof(float));
+    m_pos -= inUsed;
+  }
+
+  return true;
+}
+
+void CAEResamplerLinear::Reset()
+{
+  m_last.assign(m_channels, 0.0f);
+  m_pos = 0.0;
+}
+
+/* polyphase windowed sinc */
+
+CAEResamplerSinc::CAEResamplerSinc() :
+  m_channels(0   ),
+  m_ratio   (1.0 ),
+  m_pos     (0.0 ),
+  m_table   (NULL),
+  m_history (NULL),
+  m_histSize(0   ),
+  m_histLen (0   )
+{
+}
+
+CAEResamplerSinc::~CAEResamplerSinc()
+{
+  _aligned_free(m_table);
+  _aligned_free(m_history);
+}
+
+bool CAEResamplerSinc::Initialize(unsigned int channels, double ratio)
+{
+  m_channels = channels;
+  m_ratio    = ratio;
+
+  /* when downsampling the cutoff has to follow the output nyquist */
+  BuildTable(std::min(1.0, ratio) * 0.95);
+
+  m_histSize = SINC_TAPS * 2;
+  m_history  = (float*)_aligned_malloc(m_histSize * m_channels * sizeof(float), 16);
+  Reset();
+  return m_table && m_history;
+}
+
+void CAEResamplerSinc::BuildTable(double cutoff)
+{
+  m_table = (float*)_aligned_malloc((SINC_PHASES + 1) * SINC_TAPS * sizeof(float), 16);
+  if (!m_table)
+    return;
+
+  const double half = SINC_TAPS / 2;
+  for (unsigned int p = 0; p <= SINC_PHASES; ++p)
+  {
+    float  *row = m_table + p * SINC_TAPS;
+    double  sum = 0.0;
+    for (unsigned int k = 0; k < SINC_TAPS; ++k)
+    {
+      /* distance from the output position to the input frame this tap covers */
+      const double x = (double)p / SINC_PHASES + half - 1.0 - k;
+      const double u = x / half;
+      const double w = 0.42 + 0.5 * cos(M_PI * u) + 0.08 * cos(2.0 * M_PI * u);
+      const double s = x == 0.0 ? 1.0 : sin(M_PI * cutoff * x) / (M_PI * cutoff * x);
+      row[k] = (float)(cutoff * s * w);
+      sum   += row[k];
+    }
+
+    /* normalize each phase for unity gain at DC */
+    for (unsigned int k = 0; k < SINC_TAPS; ++k)
+      row[k] = (float)(row[k] / sum);
+  }
+}
+
+inline float CAEResamplerSinc::Convolve(const float *src, const float *coef) const
+{
+#if defined(__SSE__)
+  __m128 acc = _mm_setzero_ps();
+  for (unsigned int k = 0; k < SINC_TAPS; k += 4)
+    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(src + k), _mm_load_ps(coef + k)));
+  MEMALIGN(16, float sum[4]);
+  _mm_store_ps(sum, acc);
+  return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+#elif defined(__ARM_NEON__)
+  float32x4_t acc = vdupq_n_f32(0.0f);
+  for (unsigned int k = 0; k < SINC_TAPS; k += 4)
+    acc = vmlaq_f32(acc, vld1q_f32(src + k), vld1q_f32(coef + k));
+  float32x2_t sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+  return vget_lane_f32(vpadd_f32(sum, sum), 0);
+#else
+  float sum = 0.0f;
+  for (unsigned int k = 0; k < SINC_TAPS; ++k)
+    sum += src[k] * coef[k];
+  return sum;
+#endif
+}
+
+bool CAEResamplerSinc::Process(float *in, unsigned int inFrames, float *out, unsigned int outFrames, unsigned int &inUsed, unsigned int &outGenerated)
+{
+  /* grow the history if the caller hands us more than we have seen before */
+  if (m_histLen + inFrames > m_histSize)
+  {
+    unsigned int size    = m_histLen + inFrames + SINC_TAPS;
+    float       *history = (float*)_aligned_malloc(size * m_channels * sizeof(float), 16);
+    if (!history)
+      return false;
+
+    for (unsigned int c = 0; c < m_channels; ++c)
+      memcpy(history + c * size, m_history + c * m_histSize, m_histLen * sizeof(float));
+
+    _aligned_free(m_history);
+    m_history  = history;
+    m_histSize = size;
+  }
+
+  /* deinterleave the input so each channel convolves over contiguous memory */
+  for (unsigned int c = 0; c < m_channels; ++c)
+  {
+    float       *dst = m_history + c * m_histSize + m_histLen;
+    const float *src = in + c;
+    for (unsigned int f = 0; f < inFrames; ++f, src += m_channels)
+      dst[f] = *src;
+  }
+  m_histLen += inFrames;
+  inUsed     = inFrames;
+
+  MEMALIGN(16, float coef[SINC_TAPS]);
+  const double step = 1.0 / m_ratio;
+
+  outGenerated = 0;
+  while (outGenerated < outFrames)
+  {
+    const unsigned int base = (unsigned int)m_pos;
+    if (base + SINC_TAPS / 2 >= m_histLen)
+      break;
+
+    /* interpolate the filter between the two nearest phases */
+    const double       phase = (m_pos - base) * SINC_PHASES;
+    const unsigned int p     = (unsigned int)phase;
+    const float        frac  = (float)(phase - p);
+    const float       *row0  = m_table + p * SINC_TAPS;
+    const float       *row1  = row0 + SINC_TAPS;
+    for (unsigned int k = 0; k < SINC_TAPS; ++k)
+      coef[k] = row0[k] + (row1[k] - row0[k]) * frac;
+
+    const unsigned int first = base + 1 - SINC_TAPS / 2;
+    for (unsigned int c = 0; c < m_channels; ++c)
+      *out++ = Convolve(m_history + c * m_histSize + first, coef);
+
+    m_pos += step;
+    ++outGenerated;
+  }
+
+  /* drop the frames that no future output can reach */
+  const unsigned int base = (unsigned int)m_pos;
+  if (base + 1 > SINC_TAPS / 2)
+  {
+    const unsigned int drop = std::min(base + 1 - SINC_TAPS / 2, m_histLen);
+    for (unsigned int c = 0; c < m_channels; ++c)
+    {
+      float *row = m_history + c * m_histSize;
+      memmove(row, row + drop, (m_histLen - drop) * sizeof(float));
+    }
+    m_histLen -= drop;
+    m_pos     -= drop;
+  }
+
+  return true;
+}
+
+void CAEResamplerSinc::Reset()
+{
+  /* prime with silence so the first output lands on the first input frame */
+  m_histLen = SINC_TAPS / 2 - 1;
+  m_pos     = m_histLen;
+  if (m_history)
+    memset(m_history, 0, m_histSize * m_channels * sizeof(float));
+}
@@ -0,0 +1,147 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2012 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <samplerate.h>
+#include <string>
+#include <vector>
+
+/**
+ * Resampler engines available to the audio streams, ordered from
+ * cheapest to most expensive
+ */
+enum AEResampleQuality
+{
+  AE_RESAMPLE_LINEAR = 0, /* linear interpolation, for low end ARM boxes */
+  AE_RESAMPLE_SINC,       /* table driven polyphase windowed sinc */
+  AE_RESAMPLE_SRC_FAST,   /* libsamplerate SRC_SINC_FASTEST */
+  AE_RESAMPLE_SRC_MEDIUM, /* libsamplerate SRC_SINC_MEDIUM_QUALITY */
+  AE_RESAMPLE_SRC_BEST    /* libsamplerate SRC_SINC_BEST_QUALITY */
+};
+
+/**
+ * IAEResampler converts interleaved float frames at a continuously
+ * adjustable ratio (output rate / input rate)
+ */
+class IAEResampler
+{
+public:
+  virtual ~IAEResampler() {}
+
+  /**
+   * Prepares the resampler
+   * @param channels the number of interleaved channels
+   * @param ratio the initial output/input rate ratio, filters are designed for this ratio
+   */
+  virtual bool Initialize(unsigned int channels, double ratio) = 0;
+
+  /**
+   * Changes the ratio without reinitializing, used for small A/V sync adjustments
+   */
+  virtual void SetRatio(double ratio) = 0;
+  virtual double GetRatio() const = 0;
+
+  /**
+   * Resamples up to inFrames of input into at most outFrames of output
+   * @param inUsed returns the number of input frames consumed
+   * @param outGenerated returns the number of output frames written
+   */
+  virtual bool Process(float *in, unsigned int inFrames, float *out, unsigned int outFrames, unsigned int &inUsed, unsigned int &outGenerated) = 0;
+
+  /**
+   * Drops any history, used on flush
+   */
+  virtual void Reset() = 0;
+};
+
+class CAEResamplerFactory
+{
+public:
+  static IAEResampler*     Create(enum AEResampleQuality quality);
+  static AEResampleQuality GetQuality(const std::string &name, enum AEResampleQuality fallback);
+};
+
+/* libsamplerate backed engine, this is what the streams always used */
+class CAEResamplerSRC : public IAEResampler
+{
+public:
+  CAEResamplerSRC(int converter);
+  virtual ~CAEResamplerSRC();
+
+  virtual bool   Initialize(unsigned int channels, double ratio);
+  virtual void   SetRatio(double ratio);
+  virtual double GetRatio() const { return m_data.src_ratio; }
+  virtual bool   Process(float *in, unsigned int inFrames, float *out, unsigned int outFrames, unsigned int &inUsed, unsigned int &outGenerated);
+  virtual void   Reset();
+
+private:
+  int        m_converter;
+  SRC_STATE *m_state;
+  SRC_DATA   m_data;
+};
+
+/* two point linear interpolation, cheap but aliases on downsampling */
+class CAEResamplerLinear : public IAEResampler
+{
+public:
+  CAEResamplerLinear();
+
+  virtual bool   Initialize(unsigned int channels, double ratio);
+  virtual void   SetRatio(double ratio) { m_ratio = ratio; }
+  virtual double GetRatio() const       { return m_ratio;  }
+  virtual bool   Process(float *in, unsigned int inFrames, float *out, unsigned int outFrames, unsigned int &inUsed, unsigned int &outGenerated);
+  virtual void   Reset();
+
+private:
+  unsigned int       m_channels;
+  double             m_ratio;
+  double             m_pos;   /* position of the next output, 0 is m_last */
+  std::vector<float> m_last;  /* the last consumed input frame */
+};
+
+/*
+  polyphase windowed sinc, the filter is precomputed for SINC_PHASES
+  fractional positions and interpolated between neighbouring phases,
+  which lets the ratio drift freely without recomputing the table
+*/
+class CAEResamplerSinc : public IAEResampler
+{
+public:
+  CAEResamplerSinc();
+  virtual ~CAEResamplerSinc();
+
+  virtual bool   Initialize(unsigned int channels, double ratio);
+  virtual void   SetRatio(double ratio) { m_ratio = ratio; }
+  virtual double GetRatio() const       { return m_ratio;  }
+  virtual bool   Process(float *in, unsigned int inFrames, float *out, unsigned int outFrames, unsigned int &inUsed, unsigned int &outGenerated);
+  virtual void   Reset();
+
+private:
+  unsigned int  m_channels;
+  double        m_ratio;
+  double        m_pos;      /* position of the next output in the history */
+  float        *m_table;    /* (SINC_PHASES + 1) rows of SINC_TAPS coefficients */
+  float        *m_history;  /* planar history, one row of m_histSize frames per channel */
+  unsigned int  m_histSize;
+  unsigned int  m_histLen;
+
+  void  BuildTable(double cutoff);
+  float Convolve(const float *src, const float *coef) const;
+};
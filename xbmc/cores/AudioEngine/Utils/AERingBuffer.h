@@ -24,35 +24,49 @@
 #define AE_RING_BUFFER_FULL 2;
 #define AE_RING_BUFFER_NOTAVAILABLE 3;
 
+/* keep the reader and writer state on separate cache lines */
+#define AE_RING_BUFFER_CACHELINE 64
+
+/* orders the position updates against the data copies */
+#if defined(TARGET_WINDOWS)
+  #define AE_RING_BUFFER_BARRIER() MemoryBarrier()
+#else
+  #define AE_RING_BUFFER_BARRIER() __sync_synchronize()
+#endif
+
 //#define AE_RING_BUFFER_DEBUG
 
 #include "utils/log.h"  //CLog
 #include <string.h>     //memset, memcpy
+#include <algorithm>
 
 /**
- * This buffer can be used by one read and one write thread at any one time
- * without the risk of data corruption.
- * If you intend to call the Reset() method, please use Locks.
- * All other operations are thread-safe.
+ * Lock-free single producer / single consumer ring buffer.
+ *
+ * One thread may write and one thread may read at any one time without
+ * locks. The writer only ever advances m_iWritePos and the reader only ever
+ * advances m_iReadPos, both run modulo twice the buffer size (so a full
+ * buffer can be told from an empty one) and are published behind a memory
+ * barrier once the data has been copied.
+ *
+ * Besides Write()/Read(), callers can work in place: GetWritePtr() returns
+ * the next contiguous writable region which is published with
+ * CommitWrite(), and GetReadPtr()/CommitRead() do the same for reading.
  */
 class AERingBuffer {
 
 public:
   AERingBuffer() :
-    m_iReadPos(0),
     m_iWritePos(0),
-    m_iRead(0),
-    m_iWritten(0),
+    m_iReadPos(0),
     m_iSize(0),
     m_Buffer(NULL)
   {
   }
 
   AERingBuffer(unsigned int size) :
-    m_iReadPos(0),
     m_iWritePos(0),
-    m_iRead(0),
-    m_iWritten(0),
+    m_iReadPos(0),
     m_iSize(0),
     m_Buffer(NULL)
   {
@@ -85,18 +99,15 @@ public:
   }
 
   /**
-   * Fills the buffer with zeros and resets the pointers.
-   * This method is not thread-safe, so before using this method
-   * please acquire a Lock()
+   * Discards all data currently in the buffer.
+   * This must be called from the reading thread, it is safe to run
+   * while the writer is active.
    */
   void Reset() {
 #ifdef AE_RING_BUFFER_DEBUG
     CLog::Log(LOGDEBUG, "AERingBuffer::Reset: Buffer reset.");
 #endif
-    m_iWritten = 0;
-    m_iRead = 0;
-    m_iReadPos = 0;
-    m_iWritePos = 0;
+    CommitRead(GetReadSize());
   }
 
   /**
@@ -117,30 +128,21 @@ public:
       return AE_RING_BUFFER_FULL;
     }
 
-    //no wrapping?
-    if ( m_iSize > size + m_iWritePos )
-    {
-#ifdef AE_RING_BUFFER_DEBUG
-      CLog::Log(LOGDEBUG, "AERingBuffer: Written to: %u size: %u space before: %u\n", m_iWritePos, size, space);
-#endif
-      memcpy(&(m_Buffer[m_iWritePos]), src, size);
-      m_iWritePos+=size;
-    }
-    //need to wrap
-    else
+    //copy in at most two contiguous pieces
+    unsigned int done = 0;
+    while (done < size)
     {
-      unsigned int first = m_iSize - m_iWritePos;
-      unsigned int second = size - first;
+      unsigned int chunk;
+      unsigned char *dst = GetWritePtr(chunk);
+      chunk = std::min(chunk, size - done);
 #ifdef AE_RING_BUFFER_DEBUG
-      CLog::Log(LOGDEBUG, "AERingBuffer: Written to (split) first: %u second: %u size: %u space before: %u\n", first, second, size, space);
+      CLog::Log(LOGDEBUG, "AERingBuffer: Written to: %u size: %u space before: %u\n", (unsigned int)(dst - m_Buffer), chunk, space);
 #endif
-      memcpy(&(m_Buffer[m_iWritePos]), src, first);
-      memcpy(&(m_Buffer[0]), &src[first], second);
-      m_iWritePos = second;
+      memcpy(dst, &src[done], chunk);
+      CommitWrite(chunk);
+      done += chunk;
     }
 
-    //we can increase the write count now
-    m_iWritten+=size;
     return AE_RING_BUFFER_OK;
   }
 
@@ -173,41 +175,91 @@ public:
       return AE_RING_BUFFER_NOTAVAILABLE;
     }
 
-    //no wrapping?
-    if ( size + m_iReadPos < m_iSize )
+    //copy out in at most two contiguous pieces
+    unsigned int done = 0;
+    while (done < size)
     {
+      unsigned int chunk;
+      const unsigned char *src = GetReadPtr(chunk);
+      chunk = std::min(chunk, size - done);
 #ifdef AE_RING_BUFFER_DEBUG
-      CLog::Log(LOGDEBUG, "AERingBuffer: Reading from: %u size: %u space before: %u\n", m_iWritePos, size, space);
+      CLog::Log(LOGDEBUG, "AERingBuffer: Reading from: %u size: %u space before: %u\n", (unsigned int)(src - m_Buffer), chunk, space);
 #endif
-      memcpy(dest, &(m_Buffer[m_iReadPos]), size);
-      m_iReadPos+=size;
+      memcpy(&dest[done], src, chunk);
+      CommitRead(chunk);
+      done += chunk;
     }
-    //need to wrap
-    else
-    {
-      unsigned int first = m_iSize - m_iReadPos;
-      unsigned int second = size - first;
-#ifdef AE_RING_BUFFER_DEBUG
-      CLog::Log(LOGDEBUG, "AERingBuffer: Reading from (split) first: %u second: %u size: %u space before: %u\n", first, second, size, space);
-#endif
-      memcpy(dest, &(m_Buffer[m_iReadPos]), first);
-      memcpy(&dest[first], &(m_Buffer[0]), second);
-      m_iReadPos = second;
-    }
-    //we can increase the read count now
-    m_iRead+=size;
 
     return AE_RING_BUFFER_OK;
   }
 
+  /**
+   * Returns the next contiguous region that can be written in place.
+   * Only the writing thread may call this.
+   *
+   * @param size returns the number of bytes available at the returned pointer
+   */
+  unsigned char *GetWritePtr(unsigned int &size)
+  {
+    unsigned int writePos = m_iWritePos;
+    unsigned int readPos  = m_iReadPos;
+    AE_RING_BUFFER_BARRIER();
+
+    unsigned int pos = Offset(writePos);
+    size = std::min(m_iSize - Used(writePos, readPos), m_iSize - pos);
+    return &m_Buffer[pos];
+  }
+
+  /**
+   * Publishes size bytes written through GetWritePtr() to the reader.
+   */
+  void CommitWrite(unsigned int size)
+  {
+    unsigned int writePos = m_iWritePos;
+    AE_RING_BUFFER_BARRIER();
+    m_iWritePos = Advance(writePos, size);
+  }
+
+  /**
+   * Returns the next contiguous region that can be read in place.
+   * Only the reading thread may call this.
+   *
+   * @param size returns the number of bytes available at the returned pointer
+   */
+  const unsigned char *GetReadPtr(unsigned int &size)
+  {
+    unsigned int writePos = m_iWritePos;
+    unsigned int readPos  = m_iReadPos;
+    AE_RING_BUFFER_BARRIER();
+
+    unsigned int pos = Offset(readPos);
+    size = std::min(Used(writePos, readPos), m_iSize - pos);
+    return &m_Buffer[pos];
+  }
+
+  /**
+   * Hands size bytes consumed through GetReadPtr() back to the writer.
+   */
+  void CommitRead(unsigned int size)
+  {
+    unsigned int readPos = m_iReadPos;
+    AE_RING_BUFFER_BARRIER();
+    m_iReadPos = Advance(readPos, size);
+  }
+
   /**
    * Dumps the buffer.
    */
   void Dump()
   {
+    unsigned int writePos = m_iWritePos;
+    unsigned int readPos  = m_iReadPos;
+    AE_RING_BUFFER_BARRIER();
+    writePos = Offset(writePos);
+    readPos  = Offset(readPos);
     unsigned char* bufferContents =  (unsigned char *)_aligned_malloc(m_iSize + 1,16);
     for (unsigned int i=0; i<m_iSize; i++) {
-      if (i >= m_iReadPos && i<m_iWritePos)
+      if (i >= readPos && i<writePos)
         bufferContents[i] = m_Buffer[i];
       else
         bufferContents[i] = '_';
@@ -223,7 +275,7 @@ public:
    */
   unsigned int GetWriteSize()
   {
-    return m_iSize - ( m_iWritten - m_iRead );
+    return m_iSize - GetReadSize();
   }
 
   /**
@@ -232,7 +284,10 @@ public:
    */
   unsigned int GetReadSize()
   {
-    return m_iWritten - m_iRead;
+    unsigned int writePos = m_iWritePos;
+    unsigned int readPos  = m_iReadPos;
+    AE_RING_BUFFER_BARRIER();
+    return Used(writePos, readPos);
   }
 
   /**
@@ -244,10 +299,30 @@ public:
   }
 
 private:
-  unsigned int m_iReadPos;
-  unsigned int m_iWritePos;
-  unsigned int m_iRead;
-  unsigned int m_iWritten;
-  unsigned int m_iSize;
+  /* each position must be read only once per call, the other side may wrap
+   * it between two reads, so this works on copies */
+  inline unsigned int Used(unsigned int writePos, unsigned int readPos) const
+  {
+    return writePos >= readPos ? writePos - readPos : writePos + 2 * m_iSize - readPos;
+  }
+
+  inline unsigned int Offset(unsigned int pos) const
+  {
+    return pos >= m_iSize ? pos - m_iSize : pos;
+  }
+
+  inline unsigned int Advance(unsigned int pos, unsigned int size) const
+  {
+    pos += size;
+    return pos >= 2 * m_iSize ? pos - 2 * m_iSize : pos;
+  }
+
+  /* written by the producer only */
+  volatile unsigned int m_iWritePos;
+  char                  m_writerPad[AE_RING_BUFFER_CACHELINE - sizeof(unsigned int)];
+  /* written by the consumer only */
+  volatile unsigned int m_iReadPos;
+  char                  m_readerPad[AE_RING_BUFFER_CACHELINE - sizeof(unsigned int)];
+  unsigned int   m_iSize;
   unsigned char *m_Buffer;
 };
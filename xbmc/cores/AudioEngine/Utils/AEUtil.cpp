@@ -26,6 +26,10 @@
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 
+#if defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
 using namespace std;
 
 /* declare the rng seed and initialize it */
@@ -256,6 +260,38 @@ void CAEUtil::SSEMulAddArray(float *data, float *add, const float mul, uint32_t
 }
 #endif
 
+void CAEUtil::MulArray(float *data, const float mul, uint32_t count)
+{
+#if defined(__SSE__)
+  SSEMulArray(data, mul, count);
+#else
+  uint32_t i = 0;
+#if defined(__ARM_NEON__)
+  const float32x4_t m = vdupq_n_f32(mul);
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), m));
+#endif
+  for (; i < count; ++i)
+    data[i] *= mul;
+#endif
+}
+
+void CAEUtil::MulAddArray(float *data, float *add, const float mul, uint32_t count)
+{
+#if defined(__SSE__)
+  SSEMulAddArray(data, add, mul, count);
+#else
+  uint32_t i = 0;
+#if defined(__ARM_NEON__)
+  const float32x4_t m = vdupq_n_f32(mul);
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vaddq_f32(vld1q_f32(data + i), vmulq_f32(vld1q_f32(add + i), m)));
+#endif
+  for (; i < count; ++i)
+    data[i] += add[i] * mul;
+#endif
+}
+
 inline float CAEUtil::SoftClamp(const float x)
 {
 #if 1
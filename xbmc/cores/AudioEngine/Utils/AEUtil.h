@@ -110,6 +110,9 @@ public:
   static void SSEMulArray     (float *data, const float mul, uint32_t count);
   static void SSEMulAddArray  (float *data, float *add, const float mul, uint32_t count);
   #endif
+  /* gain helpers, these pick the SSE/NEON kernels when the build has them */
+  static void MulArray        (float *data, const float mul, uint32_t count);
+  static void MulAddArray     (float *data, float *add, const float mul, uint32_t count);
   static void ClampArray(float *data, uint32_t count);
 
   /*
@@ -0,0 +1,92 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AERemap.h"
+
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#define REMAP_FRAMES 1027
+
+static void FillRandom(std::vector<float> &buffer)
+{
+  srand(1234);
+  for (size_t i = 0; i < buffer.size(); ++i)
+    buffer[i] = ((float)rand() / RAND_MAX) * 2.0f - 1.0f;
+}
+
+/* the vector kernels sum in another order than the sparse loop did, so they
+   match it to within rounding rather than bit for bit */
+static void CheckMatchesSparse(enum AEStdChLayout from, enum AEStdChLayout to)
+{
+  CAEChannelInfo input  = from;
+  CAEChannelInfo output = to;
+
+  CAERemap remap;
+  ASSERT_TRUE(remap.Initialize(input, output, false, true));
+
+  std::vector<float> in(REMAP_FRAMES * input.Count());
+  std::vector<float> out(REMAP_FRAMES * output.Count());
+  std::vector<float> ref(REMAP_FRAMES * output.Count());
+  FillRandom(in);
+
+  remap.Remap      (&in[0], &out[0], REMAP_FRAMES);
+  remap.RemapSparse(&in[0], &ref[0], REMAP_FRAMES);
+
+  for (size_t i = 0; i < out.size(); ++i)
+  {
+    ASSERT_NEAR(ref[i], out[i], 1e-6f)
+      << "layout " << CAEUtil::GetStdChLayoutName(from) << " -> " << CAEUtil::GetStdChLayoutName(to)
+      << " sample " << i;
+  }
+}
+
+TEST(TestAERemap, Passthrough)
+{
+  CAEChannelInfo layout = AE_CH_LAYOUT_2_0;
+
+  CAERemap remap;
+  ASSERT_TRUE(remap.Initialize(layout, layout, true));
+
+  std::vector<float> in(REMAP_FRAMES * 2);
+  std::vector<float> out(REMAP_FRAMES * 2);
+  FillRandom(in);
+
+  remap.Remap(&in[0], &out[0], REMAP_FRAMES);
+  EXPECT_EQ(0, memcmp(&in[0], &out[0], in.size() * sizeof(float)));
+}
+
+TEST(TestAERemap, Downmix)
+{
+  CheckMatchesSparse(AE_CH_LAYOUT_5_1, AE_CH_LAYOUT_2_0);
+  CheckMatchesSparse(AE_CH_LAYOUT_7_1, AE_CH_LAYOUT_2_0);
+  CheckMatchesSparse(AE_CH_LAYOUT_7_1, AE_CH_LAYOUT_5_1);
+  CheckMatchesSparse(AE_CH_LAYOUT_5_0, AE_CH_LAYOUT_3_0);
+}
+
+TEST(TestAERemap, Upmix)
+{
+  CheckMatchesSparse(AE_CH_LAYOUT_1_0, AE_CH_LAYOUT_2_0);
+  CheckMatchesSparse(AE_CH_LAYOUT_2_0, AE_CH_LAYOUT_5_1);
+  CheckMatchesSparse(AE_CH_LAYOUT_5_1, AE_CH_LAYOUT_7_1);
+}
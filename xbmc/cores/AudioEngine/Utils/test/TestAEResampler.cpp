@@ -0,0 +1,195 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AEResampler.h"
+
+#include "gtest/gtest.h"
+
+#include <math.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define RESAMPLE_CHANNELS 2
+#define RESAMPLE_FRAMES   48000
+#define RESAMPLE_CHUNK    1024
+
+/* a sine of the given frequency, a fraction of the sample rate, on every channel */
+static void FillSine(std::vector<float> &buffer, double frequency)
+{
+  for (size_t f = 0; f < buffer.size() / RESAMPLE_CHANNELS; ++f)
+  {
+    const float v = (float)sin(2.0 * M_PI * frequency * f);
+    for (unsigned int c = 0; c < RESAMPLE_CHANNELS; ++c)
+      buffer[f * RESAMPLE_CHANNELS + c] = v;
+  }
+}
+
+/* feeds the input in chunks like a stream does, returns the output */
+static std::vector<float> Resample(IAEResampler &resampler, std::vector<float> &in)
+{
+  std::vector<float> out;
+  std::vector<float> chunk(RESAMPLE_CHUNK * 4 * RESAMPLE_CHANNELS);
+
+  unsigned int frames = in.size() / RESAMPLE_CHANNELS;
+  unsigned int pos    = 0;
+  while (pos < frames)
+  {
+    unsigned int used, generated;
+    unsigned int inFrames = std::min((unsigned int)RESAMPLE_CHUNK, frames - pos);
+    EXPECT_TRUE(resampler.Process(&in[pos * RESAMPLE_CHANNELS], inFrames,
+                                  &chunk[0], chunk.size() / RESAMPLE_CHANNELS, used, generated));
+    if (used == 0 && generated == 0)
+      break;
+    out.insert(out.end(), chunk.begin(), chunk.begin() + generated * RESAMPLE_CHANNELS);
+    pos += used;
+  }
+  EXPECT_EQ(frames, pos);
+  return out;
+}
+
+/* rms of the first channel, leaving out the edges where the filters settle */
+static double RMS(const std::vector<float> &buffer)
+{
+  size_t frames = buffer.size() / RESAMPLE_CHANNELS;
+  double sum    = 0.0;
+  for (size_t f = frames / 10; f < frames - frames / 10; ++f)
+    sum += buffer[f * RESAMPLE_CHANNELS] * buffer[f * RESAMPLE_CHANNELS];
+  return sqrt(sum / (frames - 2 * (frames / 10)));
+}
+
+static void CheckLength(enum AEResampleQuality quality, double ratio)
+{
+  std::auto_ptr<IAEResampler> resampler(CAEResamplerFactory::Create(quality));
+  ASSERT_TRUE(resampler->Initialize(RESAMPLE_CHANNELS, ratio));
+  EXPECT_DOUBLE_EQ(ratio, resampler->GetRatio());
+
+  std::vector<float> in(RESAMPLE_FRAMES * RESAMPLE_CHANNELS);
+  FillSine(in, 0.01);
+  std::vector<float> out = Resample(*resampler, in);
+
+  /* the filters hold back a few frames of history */
+  EXPECT_NEAR(RESAMPLE_FRAMES * ratio, out.size() / RESAMPLE_CHANNELS, 32.0) << "ratio " << ratio;
+}
+
+TEST(TestAEResampler, Factory)
+{
+  EXPECT_EQ(AE_RESAMPLE_LINEAR    , CAEResamplerFactory::GetQuality("linear", AE_RESAMPLE_SRC_MEDIUM));
+  EXPECT_EQ(AE_RESAMPLE_SINC      , CAEResamplerFactory::GetQuality("Sinc"  , AE_RESAMPLE_SRC_MEDIUM));
+  EXPECT_EQ(AE_RESAMPLE_SRC_FAST  , CAEResamplerFactory::GetQuality("fast"  , AE_RESAMPLE_SRC_MEDIUM));
+  EXPECT_EQ(AE_RESAMPLE_SRC_BEST  , CAEResamplerFactory::GetQuality("BEST"  , AE_RESAMPLE_SRC_MEDIUM));
+  EXPECT_EQ(AE_RESAMPLE_SRC_MEDIUM, CAEResamplerFactory::GetQuality(""      , AE_RESAMPLE_SRC_MEDIUM));
+  EXPECT_EQ(AE_RESAMPLE_LINEAR    , CAEResamplerFactory::GetQuality("bogus" , AE_RESAMPLE_LINEAR));
+
+  std::auto_ptr<IAEResampler> linear(CAEResamplerFactory::Create(AE_RESAMPLE_LINEAR));
+  std::auto_ptr<IAEResampler> sinc  (CAEResamplerFactory::Create(AE_RESAMPLE_SINC));
+  std::auto_ptr<IAEResampler> src   (CAEResamplerFactory::Create(AE_RESAMPLE_SRC_MEDIUM));
+  EXPECT_TRUE(dynamic_cast<CAEResamplerLinear*>(linear.get()) != NULL);
+  EXPECT_TRUE(dynamic_cast<CAEResamplerSinc*>  (sinc.get()  ) != NULL);
+  EXPECT_TRUE(dynamic_cast<CAEResamplerSRC*>   (src.get()   ) != NULL);
+}
+
+TEST(TestAEResampler, LinearLength)
+{
+  CheckLength(AE_RESAMPLE_LINEAR, 48000.0 / 44100.0);
+  CheckLength(AE_RESAMPLE_LINEAR, 44100.0 / 48000.0);
+  CheckLength(AE_RESAMPLE_LINEAR, 2.0);
+  CheckLength(AE_RESAMPLE_LINEAR, 0.5);
+}
+
+TEST(TestAEResampler, SincLength)
+{
+  CheckLength(AE_RESAMPLE_SINC, 48000.0 / 44100.0);
+  CheckLength(AE_RESAMPLE_SINC, 44100.0 / 48000.0);
+  CheckLength(AE_RESAMPLE_SINC, 2.0);
+  CheckLength(AE_RESAMPLE_SINC, 0.5);
+}
+
+TEST(TestAEResampler, LinearPassthrough)
+{
+  std::auto_ptr<IAEResampler> resampler(CAEResamplerFactory::Create(AE_RESAMPLE_LINEAR));
+  ASSERT_TRUE(resampler->Initialize(RESAMPLE_CHANNELS, 1.0));
+
+  std::vector<float> in(RESAMPLE_FRAMES * RESAMPLE_CHANNELS);
+  FillSine(in, 0.01);
+  std::vector<float> out = Resample(*resampler, in);
+
+  /* one frame late, behind the silence it starts from */
+  ASSERT_EQ(in.size(), out.size());
+  for (size_t i = RESAMPLE_CHANNELS; i < out.size(); ++i)
+    ASSERT_FLOAT_EQ(in[i - RESAMPLE_CHANNELS], out[i]) << "sample " << i;
+}
+
+TEST(TestAEResampler, SincPassthrough)
+{
+  std::auto_ptr<IAEResampler> resampler(CAEResamplerFactory::Create(AE_RESAMPLE_SINC));
+  ASSERT_TRUE(resampler->Initialize(RESAMPLE_CHANNELS, 1.0));
+
+  std::vector<float> in(RESAMPLE_FRAMES * RESAMPLE_CHANNELS);
+  FillSine(in, 0.01);
+  std::vector<float> out = Resample(*resampler, in);
+
+  /* the filter is symmetric, so a tone well below the cutoff comes out in place */
+  ASSERT_LE(out.size(), in.size());
+  for (size_t f = 100; f < out.size() / RESAMPLE_CHANNELS - 100; ++f)
+    ASSERT_NEAR(in[f * RESAMPLE_CHANNELS], out[f * RESAMPLE_CHANNELS], 0.01) << "frame " << f;
+}
+
+TEST(TestAEResampler, SincAttenuation)
+{
+  std::auto_ptr<IAEResampler> resampler(CAEResamplerFactory::Create(AE_RESAMPLE_SINC));
+  ASSERT_TRUE(resampler->Initialize(RESAMPLE_CHANNELS, 0.5));
+
+  /* below the new nyquist the tone passes */
+  std::vector<float> in(RESAMPLE_FRAMES * RESAMPLE_CHANNELS);
+  FillSine(in, 0.05);
+  EXPECT_NEAR(sqrt(0.5), RMS(Resample(*resampler, in)), 0.02);
+
+  /* above it, it would alias, so it has to be filtered out */
+  resampler->Reset();
+  FillSine(in, 0.4);
+  EXPECT_LT(RMS(Resample(*resampler, in)), 0.05);
+}
+
+TEST(TestAEResampler, SetRatio)
+{
+  /* a sync adjustment changes the rate without reinitializing */
+  AEResampleQuality engines[] = { AE_RESAMPLE_LINEAR, AE_RESAMPLE_SINC };
+  for (unsigned int e = 0; e < sizeof(engines) / sizeof(engines[0]); ++e)
+  {
+    std::auto_ptr<IAEResampler> resampler(CAEResamplerFactory::Create(engines[e]));
+    ASSERT_TRUE(resampler->Initialize(RESAMPLE_CHANNELS, 1.0));
+
+    std::vector<float> in(RESAMPLE_FRAMES * RESAMPLE_CHANNELS);
+    FillSine(in, 0.01);
+    size_t before = Resample(*resampler, in).size() / RESAMPLE_CHANNELS;
+
+    resampler->SetRatio(1.01);
+    EXPECT_DOUBLE_EQ(1.01, resampler->GetRatio());
+    size_t after = Resample(*resampler, in).size() / RESAMPLE_CHANNELS;
+
+    EXPECT_NEAR(RESAMPLE_FRAMES, before, 32.0) << "engine " << engines[e];
+    EXPECT_NEAR(RESAMPLE_FRAMES * 1.01, after, 32.0) << "engine " << engines[e];
+  }
+}
@@ -0,0 +1,202 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "cores/AudioEngine/Utils/AERingBuffer.h"
+#include "threads/Thread.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestAERingBuffer, WriteRead)
+{
+  AERingBuffer a(10);
+  unsigned char in[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+  unsigned char out[8];
+
+  EXPECT_EQ((unsigned int)10, a.GetWriteSize());
+  EXPECT_EQ(0, a.Write(in, 8));
+  EXPECT_EQ(2, a.Write(in, 8));
+  EXPECT_EQ((unsigned int)8, a.GetReadSize());
+
+  EXPECT_EQ(0, a.Read(out, 6));
+  EXPECT_EQ(0, memcmp(in, out, 6));
+
+  /* this write wraps around the end of the buffer */
+  EXPECT_EQ(0, a.Write(in, 8));
+  EXPECT_EQ((unsigned int)10, a.GetReadSize());
+  EXPECT_EQ((unsigned int)0, a.GetWriteSize());
+
+  EXPECT_EQ(0, a.Read(out, 2));
+  EXPECT_EQ(0, memcmp(&in[6], out, 2));
+  EXPECT_EQ(0, a.Read(out, 8));
+  EXPECT_EQ(0, memcmp(in, out, 8));
+  EXPECT_EQ(1, a.Read(out, 1));
+}
+
+TEST(TestAERingBuffer, InPlace)
+{
+  AERingBuffer a(16);
+  unsigned int size;
+
+  unsigned char *dst = a.GetWritePtr(size);
+  EXPECT_EQ((unsigned int)16, size);
+  memset(dst, 'a', 12);
+  a.CommitWrite(12);
+  EXPECT_EQ((unsigned int)12, a.GetReadSize());
+
+  const unsigned char *src = a.GetReadPtr(size);
+  EXPECT_EQ((unsigned int)12, size);
+  EXPECT_EQ('a', src[11]);
+  a.CommitRead(12);
+
+  /* only the tail is contiguous now */
+  dst = a.GetWritePtr(size);
+  EXPECT_EQ((unsigned int)4, size);
+  a.CommitWrite(size);
+  dst = a.GetWritePtr(size);
+  EXPECT_EQ((unsigned int)12, size);
+
+  a.Reset();
+  EXPECT_EQ((unsigned int)0, a.GetReadSize());
+  EXPECT_EQ((unsigned int)16, a.GetWriteSize());
+}
+
+class AERingBufferReader : public CThread
+{
+public:
+  AERingBufferReader(AERingBuffer &buffer, unsigned int total) :
+    CThread("AERingBufferReader"), m_buffer(buffer), m_total(total), m_errors(0) {}
+
+  virtual void Process()
+  {
+    unsigned int expected = 0;
+    while (expected < m_total)
+    {
+      unsigned int size;
+      const unsigned char *src = m_buffer.GetReadPtr(size);
+      for (unsigned int i = 0; i < size; ++i, ++expected)
+        if (src[i] != (unsigned char)expected)
+          ++m_errors;
+      m_buffer.CommitRead(size);
+    }
+  }
+
+  AERingBuffer &m_buffer;
+  unsigned int  m_total;
+  unsigned int  m_errors;
+};
+
+TEST(TestAERingBuffer, ProducerConsumer)
+{
+  const unsigned int total = 1 << 20;
+  AERingBuffer a(4093);
+  AERingBufferReader reader(a, total);
+  reader.Create();
+
+  unsigned int written = 0;
+  while (written < total)
+  {
+    unsigned int size;
+    unsigned char *dst = a.GetWritePtr(size);
+    size = std::min(size, total - written);
+    for (unsigned int i = 0; i < size; ++i)
+      dst[i] = (unsigned char)(written + i);
+    a.CommitWrite(size);
+    written += size;
+  }
+
+  reader.StopThread(true);
+  EXPECT_EQ((unsigned int)0, reader.m_errors);
+  EXPECT_EQ((unsigned int)0, a.GetReadSize());
+}
+
+class AERingBufferStressReader : public CThread
+{
+public:
+  AERingBufferStressReader(AERingBuffer &buffer, unsigned int total) :
+    CThread("AERingBufferStressReader"), m_buffer(buffer), m_total(total), m_errors(0), m_overruns(0) {}
+
+  virtual void Process()
+  {
+    unsigned int  expected = 0;
+    unsigned char out[5];
+    while (expected < m_total)
+    {
+      unsigned int space = m_buffer.GetReadSize();
+      if (space > m_buffer.GetMaxSize())
+        ++m_overruns;
+
+      /* odd read sizes so every split of a wrap is hit */
+      unsigned int size = std::min(std::min(space, (unsigned int)sizeof(out)), m_total - expected);
+      size = std::min(size, 1 + expected % 5);
+      if (size == 0 || m_buffer.Read(out, size) != 0)
+      {
+        /* let the writer in on a single core */
+        Sleep(0);
+        continue;
+      }
+      for (unsigned int i = 0; i < size; ++i, ++expected)
+        if (out[i] != (unsigned char)expected)
+          ++m_errors;
+    }
+  }
+
+  AERingBuffer &m_buffer;
+  unsigned int  m_total;
+  unsigned int  m_errors;
+  unsigned int  m_overruns;
+};
+
+TEST(TestAERingBuffer, StressWrap)
+{
+  /* a tiny buffer so both positions pass 2 * size over and over */
+  const unsigned int total = 1 << 18;
+  AERingBuffer a(7);
+  AERingBufferStressReader reader(a, total);
+  reader.Create();
+
+  unsigned int  written = 0;
+  unsigned int  overruns = 0;
+  unsigned char in[6];
+  while (written < total)
+  {
+    unsigned int space = a.GetWriteSize();
+    if (space > a.GetMaxSize())
+      ++overruns;
+
+    unsigned int size = std::min(std::min(space, (unsigned int)sizeof(in)), total - written);
+    size = std::min(size, 1 + written % 6);
+    if (size == 0)
+    {
+      reader.Sleep(0);
+      continue;
+    }
+    for (unsigned int i = 0; i < size; ++i)
+      in[i] = (unsigned char)(written + i);
+    if (a.Write(in, size) == 0)
+      written += size;
+  }
+
+  reader.StopThread(true);
+  EXPECT_EQ((unsigned int)0, overruns);
+  EXPECT_EQ((unsigned int)0, reader.m_overruns);
+  EXPECT_EQ((unsigned int)0, reader.m_errors);
+  EXPECT_EQ((unsigned int)0, a.GetReadSize());
+}
@@ -26,6 +26,7 @@
 
 #define MAX_PLANES 3
 #define MAX_FIELDS 3
+#define MAX_RENDER_BUFFERS 5 /* deepest render queue a renderer may offer */
 
 typedef struct YV12Image
 {
@@ -85,6 +86,13 @@ public:
 
   virtual unsigned int GetProcessorSize() { return 0; }
 
+  /**
+   * Number of picture buffers the render manager may queue ahead of the
+   * one on screen, 0 if the renderer only supports a plain double buffered flip
+   */
+  virtual int  GetMaxBufferSize() { return 0; }
+  virtual void SetBufferSize(int numBuffers) {}
+
   virtual bool Supports(ERENDERFEATURE feature) { return false; }
 
   // Supported pixel formats, can be called before configure
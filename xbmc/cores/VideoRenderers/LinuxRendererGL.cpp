@@ -132,7 +132,11 @@ CLinuxRendererGL::YUVBUFFER::YUVBUFFER()
   memset(&fields, 0, sizeof(fields));
   memset(&image , 0, sizeof(image));
   memset(&pbo   , 0, sizeof(pbo));
+  memset(&pboptr, 0, sizeof(pboptr));
   flipindex = 0;
+#ifdef HAS_GL_PERSISTENT_PBO
+  fence = 0;
+#endif
 #ifdef HAVE_LIBVDPAU
   vdpau = NULL;
 #endif
@@ -162,6 +166,8 @@ CLinuxRendererGL::CLinuxRendererGL()
   m_format = RENDER_FMT_NONE;
 
   m_iYV12RenderBuffer = 0;
+  m_iWriteBuffer = 0;
+  m_NumYV12Buffers = 2;
   m_flipindex = 0;
   m_currentField = FIELD_FULL;
   m_reloadShaders = 0;
@@ -179,6 +185,8 @@ CLinuxRendererGL::CLinuxRendererGL()
   m_rgbBufferSize = 0;
   m_context = NULL;
   m_rgbPbo = 0;
+  m_pboUsed = false;
+  m_pboPersistent = false;
 
   m_dllSwScale = new DllSwScale;
 
@@ -261,11 +269,22 @@ bool CLinuxRendererGL::ValidateRenderer()
 
 void CLinuxRendererGL::ManageTextures()
 {
-  m_NumYV12Buffers = 2;
   //m_iYV12RenderBuffer = 0;
   return;
 }
 
+void CLinuxRendererGL::SetBufferSize(int numBuffers)
+{
+  numBuffers = CLAMP(numBuffers, 2, NUM_BUFFERS);
+  if (numBuffers == m_NumYV12Buffers)
+    return;
+
+  CLog::Log(LOGDEBUG, "CLinuxRendererGL::SetBufferSize - using %d buffers", numBuffers);
+  m_NumYV12Buffers = numBuffers;
+  /* textures are created per buffer, so have them recreated */
+  m_bValidated = false;
+}
+
 bool CLinuxRendererGL::ValidateRenderTarget()
 {
   if (!m_bValidated)
@@ -282,7 +301,7 @@ bool CLinuxRendererGL::ValidateRenderTarget()
     // function pointer for texture might change in
     // call to LoadShaders
     glFinish();
-    for (int i = 0 ; i < m_NumYV12Buffers ; i++)
+    for (int i = 0 ; i < NUM_BUFFERS ; i++)
       (this->*m_textureDelete)(i);
 
     // trigger update of video filters
@@ -388,6 +407,7 @@ int CLinuxRendererGL::GetImage(YV12Image *image, int source, bool readonly)
       CLog::Log(LOGWARNING, "%s - Timeout waiting for texture %d", __FUNCTION__, source);
 
     im.flags |= IMAGE_FLAG_WRITING;
+    m_iWriteBuffer = source;
   }
 
   // copy the image - should be operator of YV12Image
@@ -649,7 +669,7 @@ void CLinuxRendererGL::Flush()
 
   glFinish();
 
-  for (int i = 0 ; i < m_NumYV12Buffers ; i++)
+  for (int i = 0 ; i < NUM_BUFFERS ; i++)
     (this->*m_textureDelete)(i);
 
   glFinish();
@@ -842,6 +862,7 @@ unsigned int CLinuxRendererGL::PreInit()
     m_resolution = RES_DESKTOP;
 
   m_iYV12RenderBuffer = 0;
+  m_iWriteBuffer = 0;
   m_NumYV12Buffers = 2;
 
   m_formats.push_back(RENDER_FMT_YUV420P);
@@ -1145,6 +1166,15 @@ void CLinuxRendererGL::LoadShaders(int field)
   else
     m_pboUsed = false;
 
+  m_pboPersistent = false;
+#ifdef HAS_GL_PERSISTENT_PBO
+  if (m_pboUsed && glewIsSupported("GL_ARB_buffer_storage") && glewIsSupported("GL_ARB_sync"))
+  {
+    CLog::Log(LOGNOTICE, "GL: Using persistently mapped pixel buffers");
+    m_pboPersistent = true;
+  }
+#endif
+
   // Now that we now the render method, setup texture function handlers
   if (m_format == RENDER_FMT_NV12)
   {
@@ -1241,6 +1271,7 @@ void CLinuxRendererGL::Render(DWORD flags, int renderBuffer)
 
   // call texture load function
   (this->*m_textureUpload)(renderBuffer);
+  FencePbo(m_buffers[renderBuffer]);
 
   if (m_renderMethod & RENDER_GLSL)
   {
@@ -1857,6 +1888,8 @@ void CLinuxRendererGL::DeleteYV12Texture(int index)
 
   if( fields[FIELD_FULL][0].id == 0 ) return;
 
+  WaitPbo(m_buffers[index]);
+
   /* finish up all textures, and delete them */
   g_graphicsContext.BeginPaint();  //FIXME
   for(int f = 0;f<MAX_FIELDS;f++)
@@ -1937,9 +1970,7 @@ bool CLinuxRendererGL::CreateYV12Texture(int index)
 
     for (int i = 0; i < 3; i++)
     {
-      glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, pbo[i]);
-      glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, im.planesize[i] + PBO_OFFSET, 0, GL_STREAM_DRAW_ARB);
-      void* pboPtr = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+      void* pboPtr = MapPbo(pbo[i], im.planesize[i] + PBO_OFFSET);
       if (pboPtr)
       {
         im.plane[i] = (BYTE*) pboPtr + PBO_OFFSET;
@@ -2183,9 +2214,7 @@ bool CLinuxRendererGL::CreateNV12Texture(int index)
 
     for (int i = 0; i < 2; i++)
     {
-      glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, pbo[i]);
-      glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, im.planesize[i] + PBO_OFFSET, 0, GL_STREAM_DRAW_ARB);
-      void* pboPtr = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+      void* pboPtr = MapPbo(pbo[i], im.planesize[i] + PBO_OFFSET);
       if (pboPtr)
       {
         im.plane[i] = (BYTE*)pboPtr + PBO_OFFSET;
@@ -2312,6 +2341,8 @@ void CLinuxRendererGL::DeleteNV12Texture(int index)
 
   if( fields[FIELD_FULL][0].id == 0 ) return;
 
+  WaitPbo(m_buffers[index]);
+
   // finish up all textures, and delete them
   g_graphicsContext.BeginPaint();  //FIXME
   for(int f = 0;f<MAX_FIELDS;f++)
@@ -2738,6 +2769,8 @@ void CLinuxRendererGL::DeleteYUV422PackedTexture(int index)
 
   if( fields[FIELD_FULL][0].id == 0 ) return;
 
+  WaitPbo(m_buffers[index]);
+
   // finish up all textures, and delete them
   g_graphicsContext.BeginPaint();  //FIXME
   for(int f = 0;f<MAX_FIELDS;f++)
@@ -2814,9 +2847,7 @@ bool CLinuxRendererGL::CreateYUV422PackedTexture(int index)
     pboSetup = true;
     glGenBuffersARB(1, pbo);
 
-    glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, pbo[0]);
-    glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, im.planesize[0] + PBO_OFFSET, 0, GL_STREAM_DRAW_ARB);
-    void* pboPtr = glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+    void* pboPtr = MapPbo(pbo[0], im.planesize[0] + PBO_OFFSET);
     if (pboPtr)
     {
       im.plane[0] = (BYTE*)pboPtr + PBO_OFFSET;
@@ -2976,14 +3007,22 @@ void CLinuxRendererGL::ToRGBFrame(YV12Image* im, unsigned flipIndexPlane, unsign
     m_rgbBuffer = (BYTE*)glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB) + PBO_OFFSET;
   }
 
-  m_context = m_dllSwScale->sws_getCachedContext(m_context,
-                                                 im->width, im->height, srcFormat,
-                                                 im->width, im->height, PIX_FMT_BGRA,
-                                                 SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
+  if (CYUV2RGBConverter::Supports(m_format))
+  {
+    SetupRGBConverter();
+    m_rgbConverter.Convert(m_format, src, srcStride, im->width, im->height, m_rgbBuffer, m_sourceWidth * 4);
+  }
+  else
+  {
+    m_context = m_dllSwScale->sws_getCachedContext(m_context,
+                                                   im->width, im->height, srcFormat,
+                                                   im->width, im->height, PIX_FMT_BGRA,
+                                                   SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
 
-  uint8_t *dst[]       = { m_rgbBuffer, 0, 0, 0 };
-  int      dstStride[] = { (int)m_sourceWidth * 4, 0, 0, 0 };
-  m_dllSwScale->sws_scale(m_context, src, srcStride, 0, im->height, dst, dstStride);
+    uint8_t *dst[]       = { m_rgbBuffer, 0, 0, 0 };
+    int      dstStride[] = { (int)m_sourceWidth * 4, 0, 0, 0 };
+    m_dllSwScale->sws_scale(m_context, src, srcStride, 0, im->height, dst, dstStride);
+  }
 
   if (m_rgbPbo)
   {
@@ -3056,18 +3095,27 @@ void CLinuxRendererGL::ToRGBFields(YV12Image* im, unsigned flipIndexPlaneTop, un
     m_rgbBuffer = (BYTE*)glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB) + PBO_OFFSET;
   }
 
-  m_context = m_dllSwScale->sws_getCachedContext(m_context,
-                                                 im->width, im->height >> 1, srcFormat,
-                                                 im->width, im->height >> 1, PIX_FMT_BGRA,
-                                                 SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
   uint8_t *dstTop[]    = { m_rgbBuffer, 0, 0, 0 };
   uint8_t *dstBot[]    = { m_rgbBuffer + m_sourceWidth * m_sourceHeight * 2, 0, 0, 0 };
   int      dstStride[] = { (int)m_sourceWidth * 4, 0, 0, 0 };
 
   //convert each YUV field to an RGB field, the top field is placed at the top of the rgb buffer
   //the bottom field is placed at the bottom of the rgb buffer
-  m_dllSwScale->sws_scale(m_context, srcTop, srcStrideTop, 0, im->height >> 1, dstTop, dstStride);
-  m_dllSwScale->sws_scale(m_context, srcBot, srcStrideBot, 0, im->height >> 1, dstBot, dstStride);
+  if (CYUV2RGBConverter::Supports(m_format))
+  {
+    SetupRGBConverter();
+    m_rgbConverter.Convert(m_format, srcTop, srcStrideTop, im->width, im->height >> 1, dstTop[0], dstStride[0]);
+    m_rgbConverter.Convert(m_format, srcBot, srcStrideBot, im->width, im->height >> 1, dstBot[0], dstStride[0]);
+  }
+  else
+  {
+    m_context = m_dllSwScale->sws_getCachedContext(m_context,
+                                                   im->width, im->height >> 1, srcFormat,
+                                                   im->width, im->height >> 1, PIX_FMT_BGRA,
+                                                   SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
+    m_dllSwScale->sws_scale(m_context, srcTop, srcStrideTop, 0, im->height >> 1, dstTop, dstStride);
+    m_dllSwScale->sws_scale(m_context, srcBot, srcStrideBot, 0, im->height >> 1, dstBot, dstStride);
+  }
 
   if (m_rgbPbo)
   {
@@ -3077,6 +3125,14 @@ void CLinuxRendererGL::ToRGBFields(YV12Image* im, unsigned flipIndexPlaneTop, un
   }
 }
 
+void CLinuxRendererGL::SetupRGBConverter()
+{
+  /* same matrix the shaders use, so switching render method keeps the colours */
+  TransformMatrix matrix;
+  CalculateYUVMatrix(matrix, m_iFlags, m_format, 0.0f, 1.0f);
+  m_rgbConverter.SetMatrix(matrix.m);
+}
+
 void CLinuxRendererGL::SetupRGBBuffer()
 {
   m_rgbBufferSize = m_sourceWidth * m_sourceHeight * 4;
@@ -3460,16 +3516,34 @@ void CLinuxRendererGL::BindPbo(YUVBUFFER& buff)
       continue;
     pbo = true;
 
-    glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, buff.pbo[plane]);
-    glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
+    /* a persistent mapping is coherent, the gpu sees the data without unmapping */
+    if(m_pboPersistent)
+      buff.pboptr[plane] = buff.image.plane[plane];
+    else
+    {
+      glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, buff.pbo[plane]);
+      glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
+    }
     buff.image.plane[plane] = (BYTE*)PBO_OFFSET;
   }
-  if(pbo)
+  if(pbo && !m_pboPersistent)
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
 }
 
 void CLinuxRendererGL::UnBindPbo(YUVBUFFER& buff)
 {
+  /* the decoder may write to the buffer after this, so the upload has to be done */
+  if(m_pboPersistent)
+  {
+    WaitPbo(buff);
+    for(int plane = 0; plane < MAX_PLANES; plane++)
+    {
+      if(buff.pbo[plane] && buff.image.plane[plane] == (BYTE*)PBO_OFFSET)
+        buff.image.plane[plane] = buff.pboptr[plane];
+    }
+    return;
+  }
+
   bool pbo = false;
   for(int plane = 0; plane < MAX_PLANES; plane++)
   {
@@ -3485,10 +3559,52 @@ void CLinuxRendererGL::UnBindPbo(YUVBUFFER& buff)
     glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
 }
 
+void* CLinuxRendererGL::MapPbo(GLuint pbo, int size)
+{
+  glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, pbo);
+#ifdef HAS_GL_PERSISTENT_PBO
+  if(m_pboPersistent)
+  {
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(GL_PIXEL_UNPACK_BUFFER_ARB, size, NULL, flags);
+    return glMapBufferRange(GL_PIXEL_UNPACK_BUFFER_ARB, 0, size, flags);
+  }
+#endif
+  glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, size, 0, GL_STREAM_DRAW_ARB);
+  return glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+}
+
+void CLinuxRendererGL::FencePbo(YUVBUFFER& buff)
+{
+#ifdef HAS_GL_PERSISTENT_PBO
+  if(!m_pboPersistent || !buff.pbo[0] || buff.image.plane[0] != (BYTE*)PBO_OFFSET)
+    return;
+
+  /* field textures may be loaded later from the same pbo, so always fence the latest use */
+  if(buff.fence)
+    glDeleteSync(buff.fence);
+  buff.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
+}
+
+void CLinuxRendererGL::WaitPbo(YUVBUFFER& buff)
+{
+#ifdef HAS_GL_PERSISTENT_PBO
+  if(!buff.fence)
+    return;
+
+  /* normally signalled long ago, the upload was queued a frame or more back */
+  if(glClientWaitSync(buff.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000) == GL_TIMEOUT_EXPIRED)
+    CLog::Log(LOGWARNING, "CLinuxRendererGL::WaitPbo - timeout waiting for texture upload");
+  glDeleteSync(buff.fence);
+  buff.fence = 0;
+#endif
+}
+
 #ifdef HAVE_LIBVDPAU
 void CLinuxRendererGL::AddProcessor(CVDPAU* vdpau)
 {
-  YUVBUFFER &buf = m_buffers[NextYV12Texture()];
+  YUVBUFFER &buf = m_buffers[m_iWriteBuffer];
   SAFE_RELEASE(buf.vdpau);
   buf.vdpau = (CVDPAU*)vdpau->Acquire();
 }
@@ -3497,7 +3613,7 @@ void CLinuxRendererGL::AddProcessor(CVDPAU* vdpau)
 #ifdef HAVE_LIBVA
 void CLinuxRendererGL::AddProcessor(VAAPI::CHolder& holder)
 {
-  YUVBUFFER &buf = m_buffers[NextYV12Texture()];
+  YUVBUFFER &buf = m_buffers[m_iWriteBuffer];
   buf.vaapi.surface = holder.surface;
 }
 #endif
@@ -3505,7 +3621,7 @@ void CLinuxRendererGL::AddProcessor(VAAPI::CHolder& holder)
 #ifdef TARGET_DARWIN
 void CLinuxRendererGL::AddProcessor(struct __CVBuffer *cvBufferRef)
 {
-  YUVBUFFER &buf = m_buffers[NextYV12Texture()];
+  YUVBUFFER &buf = m_buffers[m_iWriteBuffer];
   if (buf.cvBufferRef)
     CVBufferRelease(buf.cvBufferRef);
   buf.cvBufferRef = cvBufferRef;
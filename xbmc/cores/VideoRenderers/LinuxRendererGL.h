@@ -33,9 +33,15 @@
 #include "guilib/GraphicContext.h"
 #include "BaseRenderer.h"
 #include "RenderFormats.h"
+#include "YUV2RGBConverter.h"
 
 #include "threads/Event.h"
 
+/* persistently mapped pixel buffers need a glew that knows ARB_buffer_storage */
+#if defined(GL_ARB_buffer_storage) && defined(GL_ARB_sync)
+#define HAS_GL_PERSISTENT_PBO
+#endif
+
 class CRenderCapture;
 
 class CVDPAU;
@@ -44,7 +50,7 @@ namespace Shaders { class BaseYUV2RGBShader; }
 namespace Shaders { class BaseVideoFilterShader; }
 namespace VAAPI   { struct CHolder; }
 
-#define NUM_BUFFERS 3
+#define NUM_BUFFERS MAX_RENDER_BUFFERS
 
 
 #undef ALIGN
@@ -138,6 +144,8 @@ public:
   virtual void         UnInit();
   virtual void         Reset(); /* resets renderer after seek for example */
   virtual void         Flush();
+  virtual int          GetMaxBufferSize() { return NUM_BUFFERS; }
+  virtual void         SetBufferSize(int numBuffers);
 
 #ifdef HAVE_LIBVDPAU
   virtual void         AddProcessor(CVDPAU* vdpau);
@@ -211,6 +219,7 @@ protected:
   void ToRGBFrame(YV12Image* im, unsigned flipIndexPlane, unsigned flipIndexBuf);
   void ToRGBFields(YV12Image* im, unsigned flipIndexPlaneTop, unsigned flipIndexPlaneBot, unsigned flipIndexBuf);
   void SetupRGBBuffer();
+  void SetupRGBConverter();
 
   void CalculateTextureSourceRects(int source, int num_planes);
 
@@ -232,6 +241,7 @@ protected:
   int m_iYV12RenderBuffer;
   int m_NumYV12Buffers;
   int m_iLastRenderBuffer;
+  int m_iWriteBuffer; /* buffer handed out by the last writable GetImage */
 
   bool m_bConfigured;
   bool m_bValidated;
@@ -279,6 +289,10 @@ protected:
     YV12Image image;
     unsigned  flipindex; /* used to decide if this has been uploaded */
     GLuint    pbo[MAX_PLANES];
+    BYTE*     pboptr[MAX_PLANES]; /* persistent mapping, kept while the planes are bound */
+#ifdef HAS_GL_PERSISTENT_PBO
+    GLsync    fence;              /* signalled once the gpu is done reading the pbos */
+#endif
 
 #ifdef HAVE_LIBVDPAU
     CVDPAU*   vdpau;
@@ -316,13 +330,18 @@ protected:
   unsigned int       m_rgbBufferSize;
   GLuint             m_rgbPbo;
   struct SwsContext *m_context;
+  CYUV2RGBConverter  m_rgbConverter; // replaces swscale for the 4:2:0 formats
 
   CEvent* m_eventTexturesDone[NUM_BUFFERS];
 
-  void BindPbo(YUVBUFFER& buff);
-  void UnBindPbo(YUVBUFFER& buff);
+  void  BindPbo(YUVBUFFER& buff);
+  void  UnBindPbo(YUVBUFFER& buff);
+  void* MapPbo(GLuint pbo, int size);
+  void  FencePbo(YUVBUFFER& buff);
+  void  WaitPbo(YUVBUFFER& buff);
   bool m_pboSupported;
   bool m_pboUsed;
+  bool m_pboPersistent; /* pbos stay mapped, uploads are tracked with fences */
 
   bool  m_nonLinStretch;
   bool  m_nonLinStretchGui;
@@ -0,0 +1,292 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "OverlayPrerender.h"
+#include "cores/dvdplayer/DVDCodecs/Overlay/DVDOverlaySSA.h"
+#include "threads/Atomics.h"
+#include "threads/SingleLock.h"
+
+using namespace OVERLAY;
+
+/* frames kept ahead of the playhead, a little more than the deepest render queue */
+#define MAX_PENDING 16
+#define MAX_DONE    16
+
+CSSAGlyphs::CSSAGlyphs()
+{
+  m_valid      = false;
+  m_references = 1;
+}
+
+CSSAGlyphs* CSSAGlyphs::Acquire()
+{
+  AtomicIncrement(&m_references);
+  return this;
+}
+
+long CSSAGlyphs::Release()
+{
+  long count = AtomicDecrement(&m_references);
+  if (count == 0)
+    delete this;
+
+  return count;
+}
+
+CSSAPrerender::CSSAPrerender()
+{
+  m_worker      = NULL;
+  m_lastOverlay = NULL;
+  m_lastWidth   = 0;
+  m_lastHeight  = 0;
+  m_lastGlyphs  = NULL;
+}
+
+CSSAPrerender::~CSSAPrerender()
+{
+  Stop();
+
+  /* destroying a worker waits for it to end */
+  for(std::vector<CWorker*>::iterator it = m_stopped.begin(); it != m_stopped.end(); ++it)
+    delete *it;
+  m_stopped.clear();
+  Flush();
+
+  CSingleLock lock(m_rasterize);
+  if(m_lastGlyphs)
+    m_lastGlyphs->Release();
+  if(m_lastOverlay)
+    m_lastOverlay->Release();
+}
+
+void CSSAPrerender::Request(CDVDOverlaySSA* o, double pts, int width, int height)
+{
+  if(width <= 0 || height <= 0)
+    return;
+
+  CSingleLock lock(m_section);
+
+  /* a worker stopped at the end of the last file may still be finishing its
+   * frame, and that may need the lock our caller holds, so never wait for it */
+  Reap();
+  if(!m_worker)
+  {
+    m_worker = new CWorker(*this);
+    m_worker->Create();
+  }
+
+  SEntry e;
+  e.overlay = (CDVDOverlaySSA*)o->Acquire();
+  e.pts     = pts;
+  e.width   = width;
+  e.height  = height;
+  e.glyphs  = NULL;
+  m_pending.push_back(e);
+
+  /* the renderer has fallen behind, it will render these on demand */
+  while(m_pending.size() > MAX_PENDING)
+  {
+    Release(m_pending.front());
+    m_pending.pop_front();
+  }
+
+  m_wakeup.Set();
+}
+
+CSSAGlyphs* CSSAPrerender::Get(CDVDOverlaySSA* o, double pts, int width, int height)
+{
+  SEntry e;
+  e.overlay = o;
+  e.pts     = pts;
+  e.width   = width;
+  e.height  = height;
+  e.glyphs  = NULL;
+
+  {
+    CSingleLock lock(m_section);
+
+    /* presentation only moves forward between flushes */
+    while(!m_pending.empty() && m_pending.front().pts < pts)
+    {
+      Release(m_pending.front());
+      m_pending.pop_front();
+    }
+
+    for(SEntryQ::iterator it = m_done.begin(); it != m_done.end();)
+    {
+      if(it->pts < pts)
+      {
+        Release(*it);
+        it = m_done.erase(it);
+        continue;
+      }
+
+      if(it->overlay == o
+      && it->pts     == pts
+      && it->width   == width
+      && it->height  == height)
+        return it->glyphs->Acquire();
+
+      ++it;
+    }
+  }
+
+  return Rasterize(e);
+}
+
+void CSSAPrerender::Flush()
+{
+  CSingleLock lock(m_section);
+  Release(m_pending);
+  Release(m_done);
+}
+
+void CSSAPrerender::Stop()
+{
+  /* don't wait for the worker, it may be releasing an overlay, which needs
+   * the render manager lock our caller holds. It drops what it finishes. */
+  {
+    CSingleLock lock(m_section);
+    if(m_worker)
+    {
+      m_worker->StopThread(false);
+      m_stopped.push_back(m_worker);
+      m_worker = NULL;
+    }
+  }
+  Flush();
+}
+
+bool CSSAPrerender::IsRunning()
+{
+  CSingleLock lock(m_section);
+  Reap();
+  return m_worker || !m_stopped.empty();
+}
+
+void CSSAPrerender::Reap()
+{
+  for(std::vector<CWorker*>::iterator it = m_stopped.begin(); it != m_stopped.end();)
+  {
+    if((*it)->IsRunning())
+    {
+      ++it;
+      continue;
+    }
+    delete *it;
+    it = m_stopped.erase(it);
+  }
+}
+
+CSSAGlyphs* CSSAPrerender::Rasterize(const SEntry& e)
+{
+  CDVDOverlaySSA* previous = NULL;
+  CSSAGlyphs*     glyphs;
+  {
+    CSingleLock lock(m_rasterize);
+    glyphs = Rasterize(e, previous);
+  }
+
+  /* releasing an overlay may take the overlay renderer lock, never do that
+   * while the worker holds one of ours */
+  if(previous)
+    previous->Release();
+  return glyphs;
+}
+
+CSSAGlyphs* CSSAPrerender::Rasterize(const SEntry& e, CDVDOverlaySSA*& previous)
+{
+  int changes = 0;
+  ASS_Image* images = e.overlay->m_libass->RenderImage(e.width, e.height, e.pts, &changes);
+
+  /* the change flag is relative to the previous call on the same library,
+   * whichever thread made it, and that call produced m_lastGlyphs */
+  if(changes == 0
+  && m_lastGlyphs
+  && m_lastOverlay->m_libass == e.overlay->m_libass
+  && m_lastWidth  == e.width
+  && m_lastHeight == e.height)
+    return m_lastGlyphs->Acquire();
+
+  CSSAGlyphs* glyphs = new CSSAGlyphs();
+  glyphs->m_valid = convert_quad(images, glyphs->m_quads);
+
+  if(m_lastGlyphs)
+    m_lastGlyphs->Release();
+  previous = m_lastOverlay;
+
+  m_lastGlyphs  = glyphs->Acquire();
+  m_lastOverlay = (CDVDOverlaySSA*)e.overlay->Acquire();
+  m_lastWidth   = e.width;
+  m_lastHeight  = e.height;
+
+  return glyphs;
+}
+
+void CSSAPrerender::Release(SEntry& e)
+{
+  if(e.glyphs)
+    e.glyphs->Release();
+  e.overlay->Release();
+}
+
+void CSSAPrerender::Release(SEntryQ& list)
+{
+  for(SEntryQ::iterator it = list.begin(); it != list.end(); ++it)
+    Release(*it);
+  list.clear();
+}
+
+void CSSAPrerender::Process(CWorker& worker)
+{
+  while(!worker.Stopping())
+  {
+    SEntry e;
+    {
+      CSingleLock lock(m_section);
+      if(m_pending.empty())
+      {
+        lock.Leave();
+        worker.Wait(m_wakeup);
+        continue;
+      }
+      e = m_pending.front();
+      m_pending.pop_front();
+    }
+
+    e.glyphs = Rasterize(e);
+
+    SEntryQ expired;
+    {
+      CSingleLock lock(m_section);
+      if(worker.Stopping())
+        expired.push_back(e);
+      else
+        m_done.push_back(e);
+      while(m_done.size() > MAX_DONE)
+      {
+        expired.push_back(m_done.front());
+        m_done.pop_front();
+      }
+    }
+    Release(expired);
+  }
+}
@@ -0,0 +1,128 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+#include "OverlayRendererUtil.h"
+
+#include <deque>
+#include <vector>
+
+class CDVDOverlaySSA;
+
+namespace OVERLAY {
+
+  /* glyphs of one libass frame, packed into an alpha atlas */
+  class CSSAGlyphs
+  {
+  public:
+    CSSAGlyphs();
+
+    CSSAGlyphs* Acquire();
+    long        Release();
+
+    SQuads m_quads;
+    bool   m_valid; /* false when nothing is visible */
+
+  private:
+   ~CSSAGlyphs() {}
+    long m_references;
+  };
+
+  /**
+   * Rasterizes ASS subtitles on a worker thread. Overlays are queued from
+   * the decoder as they are attached to a picture, so libass has run by the
+   * time the picture is presented and the render thread only has to upload
+   * the atlas. Frames the worker hasn't reached are rendered on demand.
+   * The worker is started by the first request, sleeps while nothing is
+   * queued and is stopped at the end of playback.
+   */
+  class CSSAPrerender
+  {
+  public:
+    CSSAPrerender();
+    virtual ~CSSAPrerender();
+
+    /* queues a frame at the given size to be rendered ahead of time */
+    void        Request(CDVDOverlaySSA* o, double pts, int width, int height);
+
+    /* returns the glyphs for a frame, the same object is returned for
+     * consecutive frames libass reports as unchanged. Caller releases. */
+    CSSAGlyphs* Get(CDVDOverlaySSA* o, double pts, int width, int height);
+
+    void        Flush();
+
+    /* ends the worker and drops all frames, the next request starts a new one */
+    void        Stop();
+
+    /* true while a worker, also one that is still finishing after Stop, runs */
+    bool        IsRunning();
+
+  protected:
+    class CWorker : public CThread
+    {
+    public:
+      CWorker(CSSAPrerender& owner) : CThread("CSSAPrerender"), m_owner(owner) {}
+      bool Stopping() const      { return m_bStop; }
+      void Wait(CEvent& event)   { AbortableWait(event); }
+    protected:
+      virtual void Process()     { m_owner.Process(*this); }
+      CSSAPrerender& m_owner;
+    };
+
+    void        Process(CWorker& worker);
+    void        Reap();
+
+    struct SEntry
+    {
+      CDVDOverlaySSA* overlay;
+      double          pts;
+      int             width;
+      int             height;
+      CSSAGlyphs*     glyphs;
+    };
+    typedef std::deque<SEntry> SEntryQ;
+
+    /* virtual so tests can stand in for libass */
+    virtual CSSAGlyphs* Rasterize(const SEntry& e);
+    CSSAGlyphs* Rasterize(const SEntry& e, CDVDOverlaySSA*& previous);
+    void        Release(SEntry& e);
+    void        Release(SEntryQ& list);
+
+    CCriticalSection m_section;
+    CCriticalSection m_rasterize; /* keeps libass images valid while packing */
+    CEvent           m_wakeup;
+    CWorker*         m_worker;
+    /* stopped workers, never joined while an overlay lock may be held */
+    std::vector<CWorker*> m_stopped;
+    SEntryQ          m_pending;
+    SEntryQ          m_done;
+
+    /* last rasterized frame, reused when libass reports no change */
+    CDVDOverlaySSA*  m_lastOverlay;
+    int              m_lastWidth;
+    int              m_lastHeight;
+    CSSAGlyphs*      m_lastGlyphs;
+  };
+
+}
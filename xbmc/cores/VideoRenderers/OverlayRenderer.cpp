@@ -90,32 +90,49 @@ CRenderer::CRenderer()
 {
   m_render = 0;
   m_decode = (m_render + 1) % 2;
+  m_ssaWidth   = 0;
+  m_ssaHeight  = 0;
+  m_ssaGlyphs  = NULL;
+  m_ssaOverlay = NULL;
 }
 
 CRenderer::~CRenderer()
 {
-  for(int i = 0; i < 2; i++)
+  for(int i = 0; i < MAX_RENDER_BUFFERS; i++)
     Release(m_buffers[i]);
+  ReleaseSSA();
 }
 
-void CRenderer::AddOverlay(CDVDOverlay* o, double pts)
+void CRenderer::AddOverlay(CDVDOverlay* o, double pts, int index)
 {
   CSingleLock lock(m_section);
 
+  if(index < 0)
+    index = m_decode;
+
   SElement   e;
   e.pts = pts;
   e.overlay_dvd = o->Acquire();
-  m_buffers[m_decode].push_back(e);
+  m_buffers[index].push_back(e);
+
+#if defined(HAS_GL) || defined(HAS_GLES)
+  /* start rasterizing now, the picture is presented a few frames later */
+  if(o->IsOverlayType(DVDOVERLAY_TYPE_SSA))
+    m_prerender.Request((CDVDOverlaySSA*)o, pts, m_ssaWidth, m_ssaHeight);
+#endif
 }
 
-void CRenderer::AddOverlay(COverlay* o, double pts)
+void CRenderer::AddOverlay(COverlay* o, double pts, int index)
 {
   CSingleLock lock(m_section);
 
+  if(index < 0)
+    index = m_decode;
+
   SElement   e;
   e.pts = pts;
   e.overlay = o->Acquire();
-  m_buffers[m_decode].push_back(e);
+  m_buffers[index].push_back(e);
 }
 
 void CRenderer::AddCleanup(COverlay* o)
@@ -151,22 +168,47 @@ void CRenderer::Flush()
 {
   CSingleLock lock(m_section);
 
-  for(int i = 0; i < 2; i++)
+  for(int i = 0; i < MAX_RENDER_BUFFERS; i++)
     Release(m_buffers[i]);
 
   Release(m_cleanup);
+  m_prerender.Stop();
+  ReleaseSSA();
 }
 
-void CRenderer::Flip()
+void CRenderer::ReleaseSSA()
+{
+  if(m_ssaGlyphs)
+    m_ssaGlyphs->Release();
+  if(m_ssaOverlay)
+    m_ssaOverlay->Release();
+  m_ssaGlyphs  = NULL;
+  m_ssaOverlay = NULL;
+}
+
+void CRenderer::Flip(int source)
 {
   CSingleLock lock(m_section);
 
+  /* with a render queue the manager owns the buffer cycle */
+  if(source >= 0)
+  {
+    m_render = source;
+    return;
+  }
+
   m_render = m_decode;
   m_decode =(m_decode + 1) % 2;
 
   Release(m_buffers[m_decode]);
 }
 
+void CRenderer::Discard(int index)
+{
+  CSingleLock lock(m_section);
+  Release(m_buffers[index]);
+}
+
 void CRenderer::Render()
 {
   CSingleLock lock(m_section);
@@ -290,6 +332,22 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
   int width  = MathUtils::round_int(dst.Width());
   int height = MathUtils::round_int(dst.Height());
 
+#if defined(HAS_GL) || defined(HAS_GLES)
+  m_ssaWidth  = width;
+  m_ssaHeight = height;
+
+  CSSAGlyphs* glyphs = m_prerender.Get(o, pts, width, height);
+  if(glyphs == m_ssaGlyphs && m_ssaOverlay)
+  {
+    glyphs->Release();
+    return m_ssaOverlay->Acquire();
+  }
+
+  ReleaseSSA();
+  m_ssaGlyphs  = glyphs;
+  m_ssaOverlay = new COverlayGlyphGL(glyphs->m_valid ? &glyphs->m_quads : NULL, width, height);
+  return m_ssaOverlay->Acquire();
+#else
   int changes = 0;
   ASS_Image* images = o->m_libass->RenderImage(width, height, pts, &changes);
 
@@ -299,12 +357,11 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
       return o->m_overlay->Acquire();
   }
 
-#if defined(HAS_GL) || defined(HAS_GLES)
-  return new COverlayGlyphGL(images, width, height);
-#elif defined(HAS_DX)
+#if defined(HAS_DX)
   return new COverlayQuadsDX(images, width, height);
 #endif
   return NULL;
+#endif
 }
 
 
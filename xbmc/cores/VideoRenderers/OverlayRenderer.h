@@ -23,6 +23,8 @@
 #pragma once
 
 #include "threads/CriticalSection.h"
+#include "BaseRenderer.h"
+#include "OverlayPrerender.h"
 
 #include <vector>
 
@@ -92,10 +94,12 @@ namespace OVERLAY {
      CRenderer();
     ~CRenderer();
 
-    void AddOverlay(CDVDOverlay* o, double pts);
-    void AddOverlay(COverlay*    o, double pts);
+    /* index is the picture buffer the overlay belongs to, -1 for the next flip */
+    void AddOverlay(CDVDOverlay* o, double pts, int index = -1);
+    void AddOverlay(COverlay*    o, double pts, int index = -1);
     void AddCleanup(COverlay*    o);
-    void Flip();
+    void Flip(int source = -1);
+    void Discard(int index);
     void Render();
     void Flush();
 
@@ -122,12 +126,19 @@ namespace OVERLAY {
 
     void      Release(COverlayV& list);
     void      Release(SElementV& list);
+    void      ReleaseSSA();
 
     CCriticalSection m_section;
-    SElementV        m_buffers[2];
+    SElementV        m_buffers[MAX_RENDER_BUFFERS];
     int              m_decode;
     int              m_render;
 
     COverlayV        m_cleanup;
+
+    CSSAPrerender    m_prerender;
+    int              m_ssaWidth;   /* size the last ass frame was rendered at */
+    int              m_ssaHeight;
+    CSSAGlyphs*      m_ssaGlyphs;  /* glyphs m_ssaOverlay was built from */
+    COverlay*        m_ssaOverlay;
   };
 }
@@ -260,7 +260,7 @@ COverlayTextureGL::COverlayTextureGL(CDVDOverlaySpu* o)
   m_pma    = !!USE_PREMULTIPLIED_ALPHA;
 }
 
-COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
+COverlayGlyphGL::COverlayGlyphGL(const SQuads* quads, int width, int height)
 {
   m_vertex = NULL;
   m_width  = 1.0;
@@ -270,9 +270,9 @@ COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
   m_x      = 0.0f;
   m_y      = 0.0f;
   m_texture = 0;
+  m_count   = 0;
 
-  SQuads quads;
-  if(!convert_quad(images, quads))
+  if(!quads)
     return;
 
   glGenTextures(1, &m_texture);
@@ -280,28 +280,28 @@ COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
   glBindTexture(GL_TEXTURE_2D, m_texture);
 
   LoadTexture(GL_TEXTURE_2D
-            , quads.size_x
-            , quads.size_y
-            , quads.size_x
+            , quads->size_x
+            , quads->size_y
+            , quads->size_x
             , &m_u, &m_v
             , GL_ALPHA
             , GL_ALPHA
-            , quads.data);
+            , quads->data);
 
 
-  float scale_u = m_u / quads.size_x;
-  float scale_v = m_v / quads.size_y;
+  float scale_u = m_u / quads->size_x;
+  float scale_v = m_v / quads->size_y;
 
   float scale_x = 1.0f / width;
   float scale_y = 1.0f / height;
 
-  m_count  = quads.count;
+  m_count  = quads->count;
   m_vertex = (VERTEX*)calloc(m_count * 4, sizeof(VERTEX));
 
   VERTEX* vt = m_vertex;
-  SQuad*  vs = quads.quad;
+  SQuad*  vs = quads->quad;
 
-  for(int i=0; i < quads.count; i++)
+  for(int i=0; i < quads->count; i++)
   {
     for(int s = 0; s < 4; s++)
     {
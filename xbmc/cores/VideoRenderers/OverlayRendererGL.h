@@ -34,6 +34,8 @@ typedef struct ass_image ASS_Image;
 
 namespace OVERLAY {
 
+  struct SQuads;
+
   class COverlayTextureGL
       : public COverlayMainThread
   {
@@ -54,7 +56,7 @@ namespace OVERLAY {
      : public COverlayMainThread
   {
   public:
-   COverlayGlyphGL(ASS_Image* images, int width, int height);
+   COverlayGlyphGL(const SQuads* quads, int width, int height);
 
    virtual ~COverlayGlyphGL();
 
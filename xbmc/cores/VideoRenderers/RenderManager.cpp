@@ -227,6 +227,29 @@ CStdString CXBMCRenderManager::GetVSyncState()
   return state;
 }
 
+CStdString CXBMCRenderManager::GetRenderStatsState()
+{
+  SRenderStatsSummary stats;
+  m_stats.GetSummary(stats);
+
+  CStdString state;
+  state.Format("frames:%u drop:%u missed:%u err:%.1f/%.1fms lat:%.0fms q:%.1f held:%u/%u/%u/%u"
+              , stats.frames, stats.dropped, stats.missedVsyncs
+              , stats.avgError, stats.maxError, stats.avgLatency, stats.avgQueue
+              , stats.durations[1], stats.durations[2], stats.durations[3], stats.durations[4]);
+  return state;
+}
+
+double CXBMCRenderManager::GetRefreshPeriod()
+{
+  double frametime;
+  if (g_VideoReferenceClock.GetRefreshRate(&frametime) > 0)
+    return frametime;
+
+  float fps = g_graphicsContext.GetFPS();
+  return fps > 0.0f ? 1.0 / fps : 0.0;
+}
+
 bool CXBMCRenderManager::Configure(unsigned int width, unsigned int height, unsigned int d_width, unsigned int d_height, float fps, unsigned flags, ERenderFormat format, unsigned extended_format, unsigned int orientation)
 {
   /* make sure any queued frame was fully presented */
@@ -247,9 +270,14 @@ bool CXBMCRenderManager::Configure(unsigned int width, unsigned int height, unsi
     return false;
   }
 
+  /* the renderer recreates its buffers on configure, so this is the place to resize the queue */
+  int queuesize = std::min(g_advancedSettings.m_videoRenderBuffers, m_pRenderer->GetMaxBufferSize());
+  m_pRenderer->SetBufferSize(queuesize);
+
   bool result = m_pRenderer->Configure(width, height, d_width, d_height, fps, flags, format, extended_format, orientation);
   if(result)
   {
+    ResetQueue(queuesize);
     if( flags & CONF_FLAGS_FULLSCREEN )
     {
       lock.Leave();
@@ -292,15 +320,11 @@ void CXBMCRenderManager::RenderUpdate(bool clear, DWORD flags, DWORD alpha)
     if (!m_pRenderer)
       return;
 
-    if(m_presentstep == PRESENT_FLIP)
-    {
-      m_overlays.Flip();
-      m_pRenderer->FlipPage(m_presentsource);
-      m_presentstep = PRESENT_FRAME;
-      m_presentevent.Set();
-    }
+    PrepareNextRender();
   }
 
+  bool newframe = m_presentstep == PRESENT_FRAME;
+
   if (g_advancedSettings.m_videoDisableBackgroundDeinterlace)
   {
     CSharedLock lock(m_sharedSection);
@@ -309,6 +333,9 @@ void CXBMCRenderManager::RenderUpdate(bool clear, DWORD flags, DWORD alpha)
   else
     Render(clear, flags, alpha);
 
+  if (newframe)
+    m_stats.Presented(GetPresentTime(), m_presenttime, GetRefreshPeriod());
+
   m_presentevent.Set();
 }
 
@@ -320,9 +347,11 @@ unsigned int CXBMCRenderManager::PreInit()
   m_presenterr  = 0.0;
   m_errorindex  = 0;
   memset(m_errorbuff, 0, sizeof(m_errorbuff));
+  m_stats.Reset();
 
   m_bIsStarted = false;
   m_bPauseDrawing = false;
+  ResetQueue(0);
   if (!m_pRenderer)
   {
 #if defined(HAS_GL)
@@ -539,13 +568,17 @@ void CXBMCRenderManager::FlipPage(volatile bool& bStop, double timestamp /* = 0L
   if(timestamp - GetPresentTime() > MAXPRESENTDELAY)
     timestamp =  GetPresentTime() + MAXPRESENTDELAY;
 
+  /* with a render queue the render thread picks the picture due, *
+   * the single slot flip has to wait for the previous frame      */
+  bool queued = IsQueued();
+
   /* can't flip, untill timestamp */
-  if(!g_graphicsContext.IsFullScreenVideo())
+  if(!queued && !g_graphicsContext.IsFullScreenVideo())
     WaitPresentTime(timestamp);
 
   /* make sure any queued frame was fully presented */
   double timeout = m_presenttime + 1.0;
-  while(m_presentstep != PRESENT_IDLE && !bStop)
+  while(!queued && m_presentstep != PRESENT_IDLE && !bStop)
   {
     if(!m_presentevent.WaitMSec(100) && GetPresentTime() > timeout && !bStop)
     {
@@ -560,50 +593,87 @@ void CXBMCRenderManager::FlipPage(volatile bool& bStop, double timestamp /* = 0L
   { CRetakeLock<CExclusiveLock> lock(m_sharedSection);
     if(!m_pRenderer) return;
 
-    m_presenttime  = timestamp;
-    m_presentfield = sync;
-    m_presentstep  = PRESENT_FLIP;
-    m_presentsource = source;
+    EFIELDSYNC presentfield = sync;
+    EPRESENTMETHOD presentmethod;
     EDEINTERLACEMODE deinterlacemode = g_settings.m_currentVideoSettings.m_DeinterlaceMode;
     EINTERLACEMETHOD interlacemethod = AutoInterlaceMethodInternal(g_settings.m_currentVideoSettings.m_InterlaceMethod);
 
     bool invert = false;
 
     if (deinterlacemode == VS_DEINTERLACEMODE_OFF)
-      m_presentmethod = PRESENT_METHOD_SINGLE;
+      presentmethod = PRESENT_METHOD_SINGLE;
     else
     {
-      if (deinterlacemode == VS_DEINTERLACEMODE_AUTO && m_presentfield == FS_NONE)
-        m_presentmethod = PRESENT_METHOD_SINGLE;
+      if (deinterlacemode == VS_DEINTERLACEMODE_AUTO && presentfield == FS_NONE)
+        presentmethod = PRESENT_METHOD_SINGLE;
       else
       {
-        if      (interlacemethod == VS_INTERLACEMETHOD_RENDER_BLEND)            m_presentmethod = PRESENT_METHOD_BLEND;
-        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_WEAVE)            m_presentmethod = PRESENT_METHOD_WEAVE;
-        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_WEAVE_INVERTED) { m_presentmethod = PRESENT_METHOD_WEAVE ; invert = true; }
-        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_BOB)              m_presentmethod = PRESENT_METHOD_BOB;
-        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_BOB_INVERTED)   { m_presentmethod = PRESENT_METHOD_BOB; invert = true; }
-        else if (interlacemethod == VS_INTERLACEMETHOD_DXVA_BOB)                m_presentmethod = PRESENT_METHOD_BOB;
-        else if (interlacemethod == VS_INTERLACEMETHOD_DXVA_BEST)               m_presentmethod = PRESENT_METHOD_BOB;
-        else                                                                    m_presentmethod = PRESENT_METHOD_SINGLE;
+        if      (interlacemethod == VS_INTERLACEMETHOD_RENDER_BLEND)            presentmethod = PRESENT_METHOD_BLEND;
+        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_WEAVE)            presentmethod = PRESENT_METHOD_WEAVE;
+        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_WEAVE_INVERTED) { presentmethod = PRESENT_METHOD_WEAVE ; invert = true; }
+        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_BOB)              presentmethod = PRESENT_METHOD_BOB;
+        else if (interlacemethod == VS_INTERLACEMETHOD_RENDER_BOB_INVERTED)   { presentmethod = PRESENT_METHOD_BOB; invert = true; }
+        else if (interlacemethod == VS_INTERLACEMETHOD_DXVA_BOB)                presentmethod = PRESENT_METHOD_BOB;
+        else if (interlacemethod == VS_INTERLACEMETHOD_DXVA_BEST)               presentmethod = PRESENT_METHOD_BOB;
+        else                                                                    presentmethod = PRESENT_METHOD_SINGLE;
 
         /* default to odd field if we want to deinterlace and don't know better */
-        if (deinterlacemode == VS_DEINTERLACEMODE_FORCE && m_presentfield == FS_NONE)
-          m_presentfield = FS_TOP;
+        if (deinterlacemode == VS_DEINTERLACEMODE_FORCE && presentfield == FS_NONE)
+          presentfield = FS_TOP;
 
         /* invert present field */
         if(invert)
         {
-          if( m_presentfield == FS_BOT )
-            m_presentfield = FS_TOP;
+          if( presentfield == FS_BOT )
+            presentfield = FS_TOP;
           else
-            m_presentfield = FS_BOT;
+            presentfield = FS_BOT;
         }
       }
     }
 
+    if(queued)
+    {
+      /* the picture was written to the front free buffer by AddVideoPicture */
+      int index = m_queue.Queue(timestamp);
+      if(index < 0)
+        return;
+
+      m_Queue[index].presentfield  = presentfield;
+      m_Queue[index].presentmethod = presentmethod;
+    }
+    else
+    {
+      m_presenttime   = timestamp;
+      m_presentfield  = presentfield;
+      m_presentmethod = presentmethod;
+      m_presentstep   = PRESENT_FLIP;
+      m_presentsource = source;
+    }
+    m_stats.Queued(GetPresentTime(), timestamp, m_queue.GetQueued());
   }
 
   g_application.NewFrame();
+
+  if(queued)
+  {
+    /* decode may run ahead, but needs a buffer for the next picture */
+    timeout = timestamp + 1.0;
+    while(!bStop)
+    {
+      { CSharedLock lock(m_sharedSection);
+        if(m_queue.HasFree())
+          break;
+      }
+      if(!m_presentevent.WaitMSec(100) && GetPresentTime() > timeout && !bStop)
+      {
+        CLog::Log(LOGWARNING, "CRenderManager::FlipPage - timeout waiting for a free buffer");
+        return;
+      }
+    }
+    return;
+  }
+
   /* wait untill render thread have flipped buffers */
   timeout = m_presenttime + 1.0;
   while(m_presentstep == PRESENT_FLIP && !bStop)
@@ -616,6 +686,67 @@ void CXBMCRenderManager::FlipPage(volatile bool& bStop, double timestamp /* = 0L
   }
 }
 
+void CXBMCRenderManager::ResetQueue(int size)
+{
+  m_queue.Reset(size);
+  m_presentsource = IsQueued() ? -1 : 0;
+}
+
+void CXBMCRenderManager::ReleaseBuffers(const std::vector<int> &released)
+{
+  for(unsigned int i = 0; i < released.size(); i++)
+    m_overlays.Discard(released[i]);
+}
+
+void CXBMCRenderManager::DiscardQueue()
+{
+  CRetakeLock<CExclusiveLock> lock(m_sharedSection);
+
+  std::vector<int> released;
+  m_queue.Discard(released);
+  ReleaseBuffers(released);
+  m_stats.Discard();
+  m_presentevent.Set();
+}
+
+/* called from the render thread with the exclusive lock held */
+void CXBMCRenderManager::PrepareNextRender()
+{
+  if(!IsQueued())
+  {
+    if(m_presentstep == PRESENT_FLIP)
+    {
+      m_overlays.Flip();
+      m_pRenderer->FlipPage(m_presentsource);
+      m_presentstep = PRESENT_FRAME;
+      m_presentevent.Set();
+    }
+    return;
+  }
+
+  /* let the frame on screen finish all its fields first */
+  if(m_presentstep != PRESENT_IDLE)
+    return;
+
+  /* in fullscreen Present() waits for the timestamp, in the gui *
+   * we keep showing the current picture until the next is due  */
+  std::vector<int> released;
+  int index = m_queue.Next(GetPresentTime(), !g_graphicsContext.IsFullScreenVideo(), released);
+  ReleaseBuffers(released);
+  if(index < 0)
+    return;
+
+  m_presenttime   = m_queue.GetTimestamp(index);
+  m_presentfield  = m_Queue[index].presentfield;
+  m_presentmethod = m_Queue[index].presentmethod;
+
+  m_overlays.Flip(index);
+  m_pRenderer->FlipPage(index);
+  m_presentstep = PRESENT_FRAME;
+  m_presentsource = index;
+  m_presentevent.Set();
+}
+
 void CXBMCRenderManager::Reset()
 {
   CSharedLock lock(m_sharedSection);
@@ -675,21 +806,21 @@ void CXBMCRenderManager::Present()
     if (!m_pRenderer)
       return;
 
-    if(m_presentstep == PRESENT_FLIP)
-    {
-      m_overlays.Flip();
-      m_pRenderer->FlipPage(m_presentsource);
-      m_presentstep = PRESENT_FRAME;
-      m_presentevent.Set();
-    }
+    PrepareNextRender();
   }
 
+  /* fields are presented twice, only the first one counts */
+  bool newframe = m_presentstep == PRESENT_FRAME;
+
   Render(true, 0, 255);
 
   /* wait for this present to be valid */
   if(g_graphicsContext.IsFullScreenVideo())
     WaitPresentTime(m_presenttime);
 
+  if(newframe)
+    m_stats.Presented(GetPresentTime(), m_presenttime, GetRefreshPeriod());
+
   m_presentevent.Set();
 }
 
@@ -800,11 +931,21 @@ int CXBMCRenderManager::AddVideoPicture(DVDVideoPicture& pic)
   if (!m_pRenderer)
     return -1;
 
+  m_stats.Decoded(GetPresentTime());
+
   if(m_pRenderer->AddVideoPicture(&pic))
     return 1;
 
+  int source = AUTOSOURCE;
+  if(IsQueued())
+  {
+    source = m_queue.GetWriteBuffer();
+    if(source < 0)
+      return -1;
+  }
+
   YV12Image image;
-  int index = m_pRenderer->GetImage(&image);
+  int index = m_pRenderer->GetImage(&image, source);
 
   if(index < 0)
     return index;
@@ -29,6 +29,8 @@
 #include "threads/Thread.h"
 #include "settings/VideoSettings.h"
 #include "OverlayRenderer.h"
+#include "RenderQueue.h"
+#include "RenderStats.h"
 
 /* PLEX */
 #ifdef TARGET_WINDOWS
@@ -87,10 +89,15 @@ public:
   void UnInit();
   bool Flush();
 
+  /* drops pictures queued for presentation, used after a seek */
+  void DiscardQueue();
+  /* number of buffers in the render queue, 0 for a plain double buffered flip */
+  int  GetQueueSize() { return m_queue.GetSize(); }
+
   void AddOverlay(CDVDOverlay* o, double pts)
   {
     CSharedLock lock(m_sharedSection);
-    m_overlays.AddOverlay(o, pts);
+    m_overlays.AddOverlay(o, pts, m_queue.GetWriteBuffer());
   }
 
   void AddCleanup(OVERLAY::COverlay* o)
@@ -120,6 +127,10 @@ public:
 
   CStdString GetVSyncState();
 
+  /* frame pacing of the pictures presented since playback started */
+  void GetRenderStats(SRenderStatsSummary &summary) { m_stats.GetSummary(summary); }
+  CStdString GetRenderStatsState();
+
   void UpdateResolution();
 
 #ifdef HAS_GL
@@ -204,6 +215,22 @@ protected:
   CEvent     m_presentevent;
   CEvent     m_flushEvent;
 
+  /* render queue, the field state of each queued picture is kept alongside */
+  struct SPresent
+  {
+    EFIELDSYNC     presentfield;
+    EPRESENTMETHOD presentmethod;
+  };
+  CRenderQueue    m_queue;
+  SPresent        m_Queue[MAX_RENDER_BUFFERS];
+
+  bool IsQueued() const { return m_queue.IsEnabled(); }
+  void ResetQueue(int size);
+  void ReleaseBuffers(const std::vector<int> &released);
+  void PrepareNextRender();
+  double GetRefreshPeriod();
+
+  CRenderStats    m_stats;
 
   OVERLAY::CRenderer m_overlays;
 
@@ -0,0 +1,89 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RenderQueue.h"
+
+CRenderQueue::CRenderQueue()
+{
+  Reset(0);
+}
+
+void CRenderQueue::Reset(int size)
+{
+  m_size = size > 2 ? size : 0;
+
+  m_timestamp.assign(m_size, 0.0);
+  m_free.clear();
+  m_queued.clear();
+  for (int i = 0; i < m_size; i++)
+    m_free.push_back(i);
+
+  m_source = -1;
+}
+
+int CRenderQueue::Queue(double timestamp)
+{
+  if (m_free.empty())
+    return -1;
+
+  int index = m_free.front();
+  m_free.pop_front();
+  m_timestamp[index] = timestamp;
+  m_queued.push_back(index);
+  return index;
+}
+
+int CRenderQueue::Next(double now, bool waitForDue, std::vector<int> &released)
+{
+  if (m_queued.empty())
+    return -1;
+
+  /* if we fell behind, skip pictures whose successor is already due */
+  while (m_queued.size() > 1 && m_timestamp[m_queued[1]] <= now)
+  {
+    released.push_back(m_queued.front());
+    m_free.push_back(m_queued.front());
+    m_queued.pop_front();
+  }
+
+  int index = m_queued.front();
+  if (waitForDue && m_timestamp[index] > now)
+    return -1;
+  m_queued.pop_front();
+
+  /* the picture we flipped away from can be decoded into again */
+  if (m_source >= 0)
+  {
+    released.push_back(m_source);
+    m_free.push_back(m_source);
+  }
+  m_source = index;
+  return index;
+}
+
+void CRenderQueue::Discard(std::vector<int> &released)
+{
+  while (!m_queued.empty())
+  {
+    released.push_back(m_queued.front());
+    m_free.push_back(m_queued.front());
+    m_queued.pop_front();
+  }
+}
@@ -0,0 +1,74 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <deque>
+#include <vector>
+
+/**
+ * Bookkeeping of the render queue, used when the renderer offers more than
+ * two buffers. Every buffer is either free (or being written by the decoder
+ * at the front of the free list), queued with the time it should be
+ * presented at, or on screen. Decode may run ahead of presentation until it
+ * runs out of free buffers. It does no locking and knows nothing about the
+ * renderer, the render manager does both.
+ */
+class CRenderQueue
+{
+public:
+  CRenderQueue();
+
+  /* two buffers is what the single slot flip already gives us, so anything
+   * less than three disables the queue */
+  void Reset(int size);
+
+  bool IsEnabled() const { return m_size > 0; }
+  int  GetSize() const   { return m_size; }
+  int  GetQueued() const { return (int)m_queued.size(); }
+  bool HasFree() const   { return !m_free.empty(); }
+  /* buffer the decoder writes the next picture into, -1 if none is free */
+  int  GetWriteBuffer() const { return IsEnabled() && HasFree() ? m_free.front() : -1; }
+  /* buffer on screen, -1 before the first flip */
+  int  GetSource() const { return m_source; }
+  double GetTimestamp(int index) const { return m_timestamp[index]; }
+
+  /* queues the write buffer to be presented at timestamp, returns its index
+   * or -1 if no buffer was free */
+  int Queue(double timestamp);
+
+  /**
+   * Picks the picture to put on screen at now. Pictures whose successor is
+   * already due are skipped. With waitForDue a picture is only taken once
+   * its time has come, otherwise the next one is taken right away.
+   * Returns the index now on screen, or -1 if it stays as is. Buffers
+   * that became free are appended to released.
+   */
+  int Next(double now, bool waitForDue, std::vector<int> &released);
+
+  /* frees all queued pictures, the one on screen stays */
+  void Discard(std::vector<int> &released);
+
+private:
+  std::vector<double> m_timestamp;
+  int                 m_size;
+  int                 m_source;
+  std::deque<int>     m_free;
+  std::deque<int>     m_queued;
+};
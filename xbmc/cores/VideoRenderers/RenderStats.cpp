@@ -0,0 +1,170 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RenderStats.h"
+#include "threads/SingleLock.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+/* a producer that stops presenting must not grow the pending list forever */
+#define MAX_PENDING 64
+
+CRenderStats::CRenderStats()
+{
+  Reset();
+}
+
+void CRenderStats::Reset()
+{
+  CSingleLock lock(m_section);
+  m_pending.clear();
+  memset(m_frames, 0, sizeof(m_frames));
+  m_decoded       = 0.0;
+  m_index         = 0;
+  m_count         = 0;
+  m_presented     = 0;
+  m_dropped       = 0;
+  m_missed        = 0;
+  m_refreshPeriod = 0.0;
+}
+
+void CRenderStats::Decoded(double time)
+{
+  CSingleLock lock(m_section);
+  m_decoded = time;
+}
+
+void CRenderStats::Queued(double time, double intended, int queueLevel)
+{
+  CSingleLock lock(m_section);
+
+  SRenderFrameTiming frame = {};
+  frame.decoded    = m_decoded > 0.0 ? m_decoded : time;
+  frame.queued     = time;
+  frame.intended   = intended;
+  frame.queueLevel = queueLevel;
+  m_decoded = 0.0;
+
+  if (m_pending.size() >= MAX_PENDING)
+  {
+    m_pending.pop_front();
+    m_dropped++;
+  }
+  m_pending.push_back(frame);
+}
+
+void CRenderStats::Discard()
+{
+  CSingleLock lock(m_section);
+  m_pending.clear();
+}
+
+void CRenderStats::Presented(double time, double intended, double refreshPeriod)
+{
+  CSingleLock lock(m_section);
+
+  /* the render manager never presents out of order, anything ahead was skipped */
+  while (!m_pending.empty() && m_pending.front().intended < intended)
+  {
+    m_pending.pop_front();
+    m_dropped++;
+  }
+  if (m_pending.empty() || m_pending.front().intended != intended)
+    return;
+
+  SRenderFrameTiming frame = m_pending.front();
+  m_pending.pop_front();
+
+  frame.presented = time;
+  if (refreshPeriod > 0.0)
+  {
+    frame.vsync = (int64_t)floor(time / refreshPeriod);
+
+    /* the picture belongs on the first vertical blank after its timestamp */
+    int64_t expected = (int64_t)floor(intended / refreshPeriod) + 1;
+    if (frame.vsync > expected)
+      m_missed += (unsigned int)(frame.vsync - expected);
+  }
+  m_refreshPeriod = refreshPeriod;
+
+  m_frames[m_index] = frame;
+  m_index = (m_index + 1) % RENDERSTATS_FRAMES;
+  m_count = std::min(m_count + 1, (unsigned int)RENDERSTATS_FRAMES);
+  m_presented++;
+}
+
+unsigned int CRenderStats::GetFrames(SRenderFrameTiming *frames, unsigned int count) const
+{
+  CSingleLock lock(m_section);
+
+  count = std::min(count, m_count);
+  unsigned int first = (m_index + RENDERSTATS_FRAMES - count) % RENDERSTATS_FRAMES;
+  for (unsigned int i = 0; i < count; i++)
+    frames[i] = m_frames[(first + i) % RENDERSTATS_FRAMES];
+  return count;
+}
+
+void CRenderStats::GetSummary(SRenderStatsSummary &summary) const
+{
+  SRenderFrameTiming frames[RENDERSTATS_FRAMES];
+  unsigned int count = GetFrames(frames, RENDERSTATS_FRAMES);
+
+  memset(&summary, 0, sizeof(summary));
+  { CSingleLock lock(m_section);
+    summary.frames        = m_presented;
+    summary.dropped       = m_dropped;
+    summary.missedVsyncs  = m_missed;
+    summary.refreshPeriod = m_refreshPeriod;
+  }
+  summary.window = count;
+  if (count == 0)
+    return;
+
+  double period = summary.refreshPeriod;
+  summary.maxError = frames[0].presented - frames[0].intended;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    double error = frames[i].presented - frames[i].intended;
+    summary.avgError   += error;
+    summary.maxError    = std::max(summary.maxError, error);
+    summary.avgLatency += frames[i].presented - frames[i].decoded;
+    summary.avgQueue   += frames[i].queueLevel;
+
+    if (period > 0.0)
+    {
+      int bucket = (int)floor(error / period * 2.0) + 2;
+      summary.errors[std::max(0, std::min(bucket, RENDERSTATS_BUCKETS - 1))]++;
+
+      /* the last frame is still on screen, its duration isn't known yet */
+      if (i + 1 < count)
+      {
+        int64_t held = frames[i + 1].vsync - frames[i].vsync;
+        summary.durations[std::max((int64_t)0, std::min(held, (int64_t)RENDERSTATS_BUCKETS - 1))]++;
+      }
+    }
+  }
+
+  summary.avgError   = summary.avgError   / count * 1000.0;
+  summary.maxError   = summary.maxError   * 1000.0;
+  summary.avgLatency = summary.avgLatency / count * 1000.0;
+  summary.avgQueue   = summary.avgQueue   / count;
+}
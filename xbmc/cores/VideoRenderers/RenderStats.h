@@ -0,0 +1,96 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+
+#include <stdint.h>
+#include <deque>
+
+/* number of presented frames kept for the histograms */
+#define RENDERSTATS_FRAMES  256
+#define RENDERSTATS_BUCKETS 8
+
+/* timeline of one picture, all times in seconds on the present clock */
+struct SRenderFrameTiming
+{
+  double  decoded;     // picture handed to the render manager
+  double  queued;      // FlipPage queued it for presentation
+  double  intended;    // time it was supposed to be shown at
+  double  presented;   // time the present returned
+  int64_t vsync;       // index of the vertical blank it was shown on
+  int     queueLevel;  // pictures waiting in the render queue after it was queued
+};
+
+struct SRenderStatsSummary
+{
+  unsigned int frames;         // presented since the last reset
+  unsigned int dropped;        // queued but never presented
+  unsigned int missedVsyncs;   // vertical blanks frames landed late by
+  double       refreshPeriod;  // seconds
+  unsigned int window;         // frames the values below are computed over
+  double       avgError;       // presented - intended, ms
+  double       maxError;
+  double       avgLatency;     // decoded to presented, ms
+  double       avgQueue;
+  /* frames that stayed on screen for n vertical blanks, the last bucket holds n or more */
+  unsigned int durations[RENDERSTATS_BUCKETS];
+  /* present error in half refresh periods, bucket 0 is -1 period or earlier and the last 2.5 or later */
+  unsigned int errors[RENDERSTATS_BUCKETS];
+};
+
+/**
+ * Records when each picture passes through the render manager so judder
+ * and missed vertical blanks can be measured. It has no dependency on
+ * the renderer or the clocks, the caller passes all times in, which lets
+ * it run headless.
+ */
+class CRenderStats
+{
+public:
+  CRenderStats();
+
+  void Reset();
+
+  /* picture was handed over by the decoder */
+  void Decoded(double time);
+  /* picture was queued to be shown at intended */
+  void Queued(double time, double intended, int queueLevel);
+  /* queued pictures were thrown away, e.g. after a seek */
+  void Discard();
+  /* the picture meant for intended went to screen, earlier pending pictures count as dropped */
+  void Presented(double time, double intended, double refreshPeriod);
+
+  void GetSummary(SRenderStatsSummary &summary) const;
+  /* copies up to count of the most recent frames, oldest first */
+  unsigned int GetFrames(SRenderFrameTiming *frames, unsigned int count) const;
+
+private:
+  CCriticalSection               m_section;
+  std::deque<SRenderFrameTiming> m_pending;
+  double                         m_decoded;
+  SRenderFrameTiming             m_frames[RENDERSTATS_FRAMES];
+  unsigned int                   m_index;       // next slot of m_frames to write
+  unsigned int                   m_count;
+  unsigned int                   m_presented;
+  unsigned int                   m_dropped;
+  unsigned int                   m_missed;
+  double                         m_refreshPeriod;
+};
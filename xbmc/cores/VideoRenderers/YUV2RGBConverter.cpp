@@ -0,0 +1,360 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "YUV2RGBConverter.h"
+#include "threads/Thread.h"
+#include "threads/Event.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+/* fixed point precision of the colour matrix */
+#define COEF_BITS 13
+/* bands smaller than this are not worth waking a thread for */
+#define MIN_BAND_ROWS 32
+
+class CYUV2RGBWorker : public CThread
+{
+public:
+  CYUV2RGBWorker(const CYUV2RGBConverter &converter) :
+    CThread("YUV2RGBWorker"), m_converter(converter) {}
+
+  void Start(const CYUV2RGBConverter::SBand &band)
+  {
+    m_band = band;
+    m_start.Set();
+  }
+
+  void Wait() { m_done.Wait(); }
+
+  void Stop()
+  {
+    m_bStop = true;
+    m_start.Set();
+    StopThread();
+  }
+
+protected:
+  virtual void Process()
+  {
+    while (!m_bStop)
+    {
+      m_start.Wait();
+      if (m_bStop)
+        break;
+      m_converter.ConvertBand(m_band);
+      m_done.Set();
+    }
+  }
+
+  const CYUV2RGBConverter &m_converter;
+  CYUV2RGBConverter::SBand m_band;
+  CEvent                   m_start;
+  CEvent                   m_done;
+};
+
+static inline uint8_t ClampByte(int value)
+{
+  return value < 0 ? 0 : (value > 255 ? 255 : (uint8_t)value);
+}
+
+/* reference kernel, the vector kernels must match it bit for bit */
+static void ConvertRowScalar(const uint8_t *py, const uint8_t *pu, const uint8_t *pv, int step,
+                             uint8_t *out, unsigned int x, unsigned int width,
+                             const int coef[3][3], const int offset[3])
+{
+  for (; x < width; ++x)
+  {
+    const int y = py[x];
+    const int u = pu[(x >> 1) * step];
+    const int v = pv[(x >> 1) * step];
+
+    out[x * 4 + 0] = ClampByte((coef[2][0] * y + coef[2][1] * u + coef[2][2] * v + offset[2]) >> COEF_BITS);
+    out[x * 4 + 1] = ClampByte((coef[1][0] * y + coef[1][1] * u + coef[1][2] * v + offset[1]) >> COEF_BITS);
+    out[x * 4 + 2] = ClampByte((coef[0][0] * y + coef[0][1] * u + coef[0][2] * v + offset[0]) >> COEF_BITS);
+    out[x * 4 + 3] = 0xFF;
+  }
+}
+
+#if defined(__SSE2__)
+static inline __m128i ChannelSSE2(__m128i yu_lo, __m128i yu_hi, __m128i v_lo, __m128i v_hi,
+                                  __m128i cyu, __m128i cv, __m128i off)
+{
+  __m128i lo = _mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(yu_lo, cyu), _mm_madd_epi16(v_lo, cv)), off);
+  __m128i hi = _mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(yu_hi, cyu), _mm_madd_epi16(v_hi, cv)), off);
+  return _mm_packs_epi32(_mm_srai_epi32(lo, COEF_BITS), _mm_srai_epi32(hi, COEF_BITS));
+}
+
+/* eight pixels per iteration, returns the number of pixels converted */
+static unsigned int ConvertRowSIMD(const uint8_t *py, const uint8_t *pu, const uint8_t *pv, int step,
+                                   uint8_t *out, unsigned int width,
+                                   const int coef[3][3], const int offset[3])
+{
+  const __m128i zero  = _mm_setzero_si128();
+  const __m128i alpha = _mm_set1_epi8((char)0xFF);
+  const __m128i low16 = _mm_set1_epi32(0x0000FFFF);
+
+  /* madd pairs, y and u share one multiply, v is paired with zero */
+  __m128i cyu[3], cv[3], off[3];
+  for (int c = 0; c < 3; ++c)
+  {
+    cyu[c] = _mm_set1_epi32((int)(((unsigned int)coef[c][1] << 16) | ((unsigned int)coef[c][0] & 0xFFFF)));
+    cv [c] = _mm_set1_epi32(coef[c][2] & 0xFFFF);
+    off[c] = _mm_set1_epi32(offset[c]);
+  }
+
+  unsigned int x = 0;
+  for (; x + 8 <= width; x += 8)
+  {
+    __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(py + x)), zero);
+    __m128i u, v;
+    if (step == 2)
+    {
+      /* four interleaved u/v pairs, one per 32 bit lane */
+      __m128i uv = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(pu + x)), zero);
+      u = _mm_and_si128(uv, low16);
+      v = _mm_srli_epi32(uv, 16);
+      u = _mm_or_si128(u, _mm_slli_epi32(u, 16));
+      v = _mm_or_si128(v, _mm_slli_epi32(v, 16));
+    }
+    else
+    {
+      int u4, v4;
+      memcpy(&u4, pu + (x >> 1), 4);
+      memcpy(&v4, pv + (x >> 1), 4);
+      u = _mm_unpacklo_epi8(_mm_cvtsi32_si128(u4), zero);
+      v = _mm_unpacklo_epi8(_mm_cvtsi32_si128(v4), zero);
+      u = _mm_unpacklo_epi16(u, u);
+      v = _mm_unpacklo_epi16(v, v);
+    }
+
+    __m128i yu_lo = _mm_unpacklo_epi16(y, u);
+    __m128i yu_hi = _mm_unpackhi_epi16(y, u);
+    __m128i v_lo  = _mm_unpacklo_epi16(v, zero);
+    __m128i v_hi  = _mm_unpackhi_epi16(v, zero);
+
+    __m128i r = ChannelSSE2(yu_lo, yu_hi, v_lo, v_hi, cyu[0], cv[0], off[0]);
+    __m128i g = ChannelSSE2(yu_lo, yu_hi, v_lo, v_hi, cyu[1], cv[1], off[1]);
+    __m128i b = ChannelSSE2(yu_lo, yu_hi, v_lo, v_hi, cyu[2], cv[2], off[2]);
+
+    __m128i bg = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), _mm_packus_epi16(g, g));
+    __m128i ra = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), alpha);
+    _mm_storeu_si128((__m128i*)(out + x * 4)     , _mm_unpacklo_epi16(bg, ra));
+    _mm_storeu_si128((__m128i*)(out + x * 4 + 16), _mm_unpackhi_epi16(bg, ra));
+  }
+  return x;
+}
+#elif defined(__ARM_NEON__)
+static inline uint8x8_t ChannelNEON(int16x8_t y, int16x8_t u, int16x8_t v, const int coef[3], int offset)
+{
+  int32x4_t lo = vdupq_n_s32(offset);
+  int32x4_t hi = vdupq_n_s32(offset);
+  lo = vmlal_n_s16(lo, vget_low_s16 (y), (int16_t)coef[0]);
+  hi = vmlal_n_s16(hi, vget_high_s16(y), (int16_t)coef[0]);
+  lo = vmlal_n_s16(lo, vget_low_s16 (u), (int16_t)coef[1]);
+  hi = vmlal_n_s16(hi, vget_high_s16(u), (int16_t)coef[1]);
+  lo = vmlal_n_s16(lo, vget_low_s16 (v), (int16_t)coef[2]);
+  hi = vmlal_n_s16(hi, vget_high_s16(v), (int16_t)coef[2]);
+  return vqmovun_s16(vcombine_s16(vqmovn_s32(vshrq_n_s32(lo, COEF_BITS)),
+                                  vqmovn_s32(vshrq_n_s32(hi, COEF_BITS))));
+}
+
+/* sixteen pixels per iteration, returns the number of pixels converted */
+static unsigned int ConvertRowSIMD(const uint8_t *py, const uint8_t *pu, const uint8_t *pv, int step,
+                                   uint8_t *out, unsigned int width,
+                                   const int coef[3][3], const int offset[3])
+{
+  unsigned int x = 0;
+  for (; x + 16 <= width; x += 16)
+  {
+    uint8x16_t y8 = vld1q_u8(py + x);
+    uint8x8_t  u8, v8;
+    if (step == 2)
+    {
+      uint8x8x2_t uv = vld2_u8(pu + x);
+      u8 = uv.val[0];
+      v8 = uv.val[1];
+    }
+    else
+    {
+      u8 = vld1_u8(pu + (x >> 1));
+      v8 = vld1_u8(pv + (x >> 1));
+    }
+    uint8x8x2_t uu = vzip_u8(u8, u8);
+    uint8x8x2_t vv = vzip_u8(v8, v8);
+
+    for (int h = 0; h < 2; ++h)
+    {
+      int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(h ? vget_high_u8(y8) : vget_low_u8(y8)));
+      int16x8_t u = vreinterpretq_s16_u16(vmovl_u8(uu.val[h]));
+      int16x8_t v = vreinterpretq_s16_u16(vmovl_u8(vv.val[h]));
+
+      uint8x8x4_t px;
+      px.val[0] = ChannelNEON(y, u, v, coef[2], offset[2]);
+      px.val[1] = ChannelNEON(y, u, v, coef[1], offset[1]);
+      px.val[2] = ChannelNEON(y, u, v, coef[0], offset[0]);
+      px.val[3] = vdup_n_u8(0xFF);
+      vst4_u8(out + (x + h * 8) * 4, px);
+    }
+  }
+  return x;
+}
+#else
+static unsigned int ConvertRowSIMD(const uint8_t *py, const uint8_t *pu, const uint8_t *pv, int step,
+                                   uint8_t *out, unsigned int width,
+                                   const int coef[3][3], const int offset[3])
+{
+  return 0;
+}
+#endif
+
+CYUV2RGBConverter::CYUV2RGBConverter(unsigned int threads, bool simd) :
+  m_threads(threads),
+  m_simd   (simd)
+{
+  if (m_threads == 0)
+    m_threads = std::max(1, std::min(g_cpuInfo.getCPUCount(), 4));
+
+  /* bt601 limited range, what swscale picks by default */
+  const float bt601[3][4] =
+  {
+    { 1.164f,  0.000f,  1.596f, -0.8742f },
+    { 1.164f, -0.392f, -0.813f,  0.5318f },
+    { 1.164f,  2.017f,  0.000f, -1.0855f }
+  };
+  SetMatrix(bt601);
+}
+
+CYUV2RGBConverter::~CYUV2RGBConverter()
+{
+  for (unsigned int i = 0; i < m_workers.size(); ++i)
+  {
+    m_workers[i]->Stop();
+    delete m_workers[i];
+  }
+}
+
+void CYUV2RGBConverter::SetMatrix(const float matrix[3][4])
+{
+  const float scale = (float)(1 << COEF_BITS);
+  for (int row = 0; row < 3; ++row)
+  {
+    /* the vector kernels multiply in 16 bits */
+    for (int col = 0; col < 3; ++col)
+      m_coef[row][col] = std::max(-32768, std::min(32767, (int)floorf(matrix[row][col] * scale + 0.5f)));
+    m_offset[row] = (int)floorf(matrix[row][3] * 255.0f * scale + 0.5f) + (1 << (COEF_BITS - 1));
+  }
+}
+
+bool CYUV2RGBConverter::Supports(ERenderFormat format)
+{
+  return format == RENDER_FMT_YUV420P
+      || format == RENDER_FMT_NV12;
+}
+
+void CYUV2RGBConverter::StartWorkers()
+{
+  for (unsigned int i = 1; i < m_threads; ++i)
+  {
+    CYUV2RGBWorker *worker = new CYUV2RGBWorker(*this);
+    worker->Create();
+    m_workers.push_back(worker);
+  }
+  CLog::Log(LOGDEBUG, "CYUV2RGBConverter - converting with %u threads", m_threads);
+}
+
+bool CYUV2RGBConverter::Convert(ERenderFormat format, uint8_t *src[], const int srcStride[],
+                                unsigned int width, unsigned int height, uint8_t *dst, int dstStride)
+{
+  if (!Supports(format))
+    return false;
+
+  if (m_workers.empty() && m_threads > 1)
+    StartWorkers();
+
+  SBand band;
+  band.format    = format;
+  band.width     = width;
+  band.dst       = dst;
+  band.dstStride = dstStride;
+  for (int i = 0; i < 3; ++i)
+  {
+    band.src[i]       = src[i];
+    band.srcStride[i] = srcStride[i];
+  }
+
+  /* even band heights keep chroma rows within one band */
+  unsigned int bands = std::max(1u, std::min(m_threads, height / MIN_BAND_ROWS));
+  unsigned int rows  = ((height + bands - 1) / bands + 1) & ~1u;
+
+  unsigned int started = 0;
+  for (unsigned int i = 1; i < bands && i * rows < height; ++i, ++started)
+  {
+    band.first = i * rows;
+    band.last  = std::min(height, band.first + rows);
+    m_workers[i - 1]->Start(band);
+  }
+
+  band.first = 0;
+  band.last  = std::min(height, rows);
+  ConvertBand(band);
+
+  for (unsigned int i = 0; i < started; ++i)
+    m_workers[i]->Wait();
+
+  return true;
+}
+
+void CYUV2RGBConverter::ConvertBand(const SBand &band) const
+{
+  for (unsigned int y = band.first; y < band.last; ++y)
+  {
+    const uint8_t *py = band.src[0] + y * band.srcStride[0];
+    const uint8_t *pu = band.src[1] + (y >> 1) * band.srcStride[1];
+    const uint8_t *pv;
+    int            step;
+    if (band.format == RENDER_FMT_NV12)
+    {
+      pv   = pu + 1;
+      step = 2;
+    }
+    else
+    {
+      pv   = band.src[2] + (y >> 1) * band.srcStride[2];
+      step = 1;
+    }
+
+    uint8_t     *out = band.dst + y * band.dstStride;
+    unsigned int x   = 0;
+    if (m_simd)
+      x = ConvertRowSIMD(py, pu, pv, step, out, band.width, m_coef, m_offset);
+    ConvertRowScalar(py, pu, pv, step, out, x, band.width, m_coef, m_offset);
+  }
+}
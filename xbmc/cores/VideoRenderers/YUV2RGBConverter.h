@@ -0,0 +1,83 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RenderFormats.h"
+
+#include <stdint.h>
+#include <vector>
+
+class CYUV2RGBWorker;
+
+/**
+ * CPU conversion of 8 bit YUV 4:2:0 pictures to BGRA, used by the
+ * software render method instead of swscale. Rows are split in bands
+ * across a few worker threads, each band runs a SSE2 or NEON kernel
+ * with a scalar tail that produces identical results.
+ */
+class CYUV2RGBConverter
+{
+public:
+  /**
+   * @param threads number of threads to split the rows across, 0 picks one from the cpu count
+   * @param simd use the vectorized kernels when the build has them
+   */
+  CYUV2RGBConverter(unsigned int threads = 0, bool simd = true);
+  ~CYUV2RGBConverter();
+
+  /**
+   * Sets the colour matrix, rows are r, g and b as computed by
+   * CalculateYUVMatrix for normalized (y, u, v, 1) input
+   */
+  void SetMatrix(const float matrix[3][4]);
+
+  /**
+   * Converts a picture, returns false if the format has no fast path
+   * and the caller has to fall back to swscale
+   */
+  bool Convert(ERenderFormat format, uint8_t *src[], const int srcStride[],
+               unsigned int width, unsigned int height, uint8_t *dst, int dstStride);
+
+  static bool Supports(ERenderFormat format);
+
+  /* one band of rows of the picture passed to Convert */
+  struct SBand
+  {
+    ERenderFormat  format;
+    const uint8_t *src[3];
+    int            srcStride[3];
+    unsigned int   width;
+    unsigned int   first;
+    unsigned int   last;
+    uint8_t       *dst;
+    int            dstStride;
+  };
+
+  void ConvertBand(const SBand &band) const;
+
+private:
+  void StartWorkers();
+
+  unsigned int                  m_threads;
+  bool                          m_simd;
+  int                           m_coef[3][3]; /* Q13 fixed point, rows r g b, columns y u v */
+  int                           m_offset[3];  /* Q13 constant term including rounding */
+  std::vector<CYUV2RGBWorker*>  m_workers;
+};
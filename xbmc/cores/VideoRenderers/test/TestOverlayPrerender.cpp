@@ -0,0 +1,201 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoRenderers/OverlayPrerender.h"
+#include "cores/dvdplayer/DVDCodecs/Overlay/DVDOverlaySSA.h"
+#include "threads/SystemClock.h"
+
+#include "gtest/gtest.h"
+
+using namespace OVERLAY;
+
+/* counts frames instead of running libass */
+class CTestPrerender : public CSSAPrerender
+{
+public:
+  CTestPrerender() : m_unblocked(true), m_blocking(false), m_count(0) {}
+
+  /* the worker mustn't call into us once we are gone */
+  ~CTestPrerender()
+  {
+    Unblock();
+    Stop();
+    WaitStopped();
+  }
+
+  int Count()
+  {
+    CSingleLock lock(m_countSection);
+    return m_count;
+  }
+
+  /* waits for the worker to have rendered count frames */
+  bool WaitCount(int count)
+  {
+    XbmcThreads::EndTime timeout(5000);
+    while (Count() < count)
+    {
+      if (timeout.IsTimePast())
+        return false;
+      m_rendered.WaitMSec(100);
+    }
+    return true;
+  }
+
+  /* holds the worker inside the next frames until Unblock */
+  void Block()
+  {
+    m_unblocked.Reset();
+    m_blocking = true;
+  }
+
+  void Unblock()
+  {
+    m_blocking = false;
+    m_unblocked.Set();
+  }
+
+  /* waits for the worker to have ended after Stop */
+  bool WaitStopped()
+  {
+    XbmcThreads::EndTime timeout(5000);
+    CEvent never;
+    while (IsRunning())
+    {
+      if (timeout.IsTimePast())
+        return false;
+      never.WaitMSec(10);
+    }
+    return true;
+  }
+
+protected:
+  virtual CSSAGlyphs* Rasterize(const SEntry& e)
+  {
+    {
+      CSingleLock lock(m_countSection);
+      m_count++;
+    }
+    m_rendered.Set();
+    if (m_blocking)
+      m_unblocked.Wait();
+    return new CSSAGlyphs();
+  }
+
+private:
+  CCriticalSection m_countSection;
+  CEvent           m_rendered;
+  CEvent           m_unblocked;
+  volatile bool    m_blocking;
+  int              m_count;
+};
+
+class TestOverlayPrerender : public testing::Test
+{
+protected:
+  TestOverlayPrerender()
+  {
+    m_libass  = new CDVDSubtitlesLibass();
+    m_overlay = new CDVDOverlaySSA(m_libass);
+  }
+
+  ~TestOverlayPrerender()
+  {
+    m_overlay->Release();
+    m_libass->Release();
+  }
+
+  CDVDSubtitlesLibass* m_libass;
+  CDVDOverlaySSA*      m_overlay;
+};
+
+TEST_F(TestOverlayPrerender, RendersAhead)
+{
+  CTestPrerender prerender;
+  EXPECT_FALSE(prerender.IsRunning());
+
+  prerender.Request(m_overlay, 1000.0, 1920, 1080);
+  prerender.Request(m_overlay, 2000.0, 1920, 1080);
+  prerender.Request(m_overlay, 3000.0, 1920, 1080);
+  ASSERT_TRUE(prerender.WaitCount(3));
+
+  /* frames the worker finished are handed out without rendering again,
+   * the worker has stored a frame by the time it starts the next one */
+  CSSAGlyphs* glyphs = prerender.Get(m_overlay, 1000.0, 1920, 1080);
+  ASSERT_TRUE(glyphs != NULL);
+  glyphs->Release();
+  glyphs = prerender.Get(m_overlay, 2000.0, 1920, 1080);
+  glyphs->Release();
+  EXPECT_EQ(3, prerender.Count());
+
+  /* a size the worker didn't render at is rendered on demand */
+  glyphs = prerender.Get(m_overlay, 2000.0, 1280, 720);
+  glyphs->Release();
+  EXPECT_EQ(4, prerender.Count());
+}
+
+TEST_F(TestOverlayPrerender, StopsAndRestarts)
+{
+  CTestPrerender prerender;
+  prerender.Request(m_overlay, 1000.0, 1920, 1080);
+  ASSERT_TRUE(prerender.WaitCount(1));
+  EXPECT_TRUE(prerender.IsRunning());
+
+  /* the end of playback ends the worker */
+  prerender.Stop();
+  EXPECT_TRUE(prerender.WaitStopped());
+
+  /* and the next file starts it again */
+  prerender.Request(m_overlay, 1000.0, 1920, 1080);
+  EXPECT_TRUE(prerender.WaitCount(2));
+}
+
+TEST_F(TestOverlayPrerender, StopReleasesFrames)
+{
+  CTestPrerender prerender;
+  prerender.Request(m_overlay, 1000.0, 1920, 1080);
+  prerender.Request(m_overlay, 2000.0, 1920, 1080);
+  ASSERT_TRUE(prerender.WaitCount(2));
+  prerender.Stop();
+  ASSERT_TRUE(prerender.WaitStopped());
+
+  /* only our own reference is left once nothing is queued */
+  CDVDOverlay* overlay = m_overlay->Acquire();
+  EXPECT_EQ(1, overlay->Release());
+}
+
+TEST_F(TestOverlayPrerender, RestartsWithoutWaiting)
+{
+  CTestPrerender prerender;
+  prerender.Block();
+  prerender.Request(m_overlay, 1000.0, 1920, 1080);
+  ASSERT_TRUE(prerender.WaitCount(1));
+
+  /* the stopped worker is still busy, a new file must not wait for it, as
+   * it may need the overlay lock the caller of Request holds */
+  prerender.Stop();
+  prerender.Request(m_overlay, 2000.0, 1920, 1080);
+  EXPECT_TRUE(prerender.IsRunning());
+
+  prerender.Unblock();
+  EXPECT_TRUE(prerender.WaitCount(2));
+  prerender.Stop();
+  EXPECT_TRUE(prerender.WaitStopped());
+}
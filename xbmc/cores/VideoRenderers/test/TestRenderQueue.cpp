@@ -0,0 +1,122 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "cores/VideoRenderers/RenderQueue.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestRenderQueue, TwoBuffersDisable)
+{
+  CRenderQueue queue;
+  queue.Reset(2);
+  EXPECT_FALSE(queue.IsEnabled());
+  EXPECT_EQ(-1, queue.GetWriteBuffer());
+
+  queue.Reset(3);
+  EXPECT_TRUE(queue.IsEnabled());
+  EXPECT_EQ(0, queue.GetWriteBuffer());
+}
+
+TEST(TestRenderQueue, PresentsInOrder)
+{
+  CRenderQueue queue;
+  queue.Reset(3);
+  std::vector<int> released;
+
+  /* decode runs ahead until every buffer is queued */
+  EXPECT_EQ(0, queue.Queue(1.0));
+  EXPECT_EQ(1, queue.Queue(2.0));
+  EXPECT_EQ(2, queue.Queue(3.0));
+  EXPECT_FALSE(queue.HasFree());
+  EXPECT_EQ(-1, queue.Queue(4.0));
+
+  /* nothing is due yet, the screen stays as is */
+  EXPECT_EQ(-1, queue.Next(0.5, true, released));
+  EXPECT_EQ(-1, queue.GetSource());
+
+  EXPECT_EQ(0, queue.Next(1.0, true, released));
+  EXPECT_TRUE(released.empty());
+  EXPECT_FALSE(queue.HasFree());
+
+  /* flipping away from a picture frees its buffer */
+  EXPECT_EQ(1, queue.Next(2.0, true, released));
+  ASSERT_EQ(1u, released.size());
+  EXPECT_EQ(0, released[0]);
+  EXPECT_EQ(0, queue.GetWriteBuffer());
+  EXPECT_EQ(1, queue.GetSource());
+}
+
+TEST(TestRenderQueue, SkipsLatePictures)
+{
+  CRenderQueue queue;
+  queue.Reset(4);
+  std::vector<int> released;
+
+  queue.Queue(1.0);
+  queue.Queue(2.0);
+  queue.Queue(3.0);
+  queue.Queue(4.0);
+
+  /* at 3.5 the first two pictures' successors are already due */
+  EXPECT_EQ(2, queue.Next(3.5, true, released));
+  ASSERT_EQ(2u, released.size());
+  EXPECT_EQ(0, released[0]);
+  EXPECT_EQ(1, released[1]);
+  EXPECT_EQ(1, queue.GetQueued());
+  EXPECT_EQ(3.0, queue.GetTimestamp(queue.GetSource()));
+}
+
+TEST(TestRenderQueue, TakesNextWithoutWaiting)
+{
+  CRenderQueue queue;
+  queue.Reset(3);
+  std::vector<int> released;
+
+  queue.Queue(5.0);
+  queue.Queue(6.0);
+
+  /* fullscreen leaves the wait for the timestamp to the present */
+  EXPECT_EQ(-1, queue.Next(1.0, true, released));
+  EXPECT_EQ(0, queue.Next(1.0, false, released));
+  EXPECT_TRUE(released.empty());
+}
+
+TEST(TestRenderQueue, DiscardKeepsScreen)
+{
+  CRenderQueue queue;
+  queue.Reset(3);
+  std::vector<int> released;
+
+  queue.Queue(1.0);
+  queue.Queue(2.0);
+  queue.Queue(3.0);
+  EXPECT_EQ(0, queue.Next(1.0, true, released));
+
+  queue.Discard(released);
+  ASSERT_EQ(2u, released.size());
+  EXPECT_EQ(0, queue.GetQueued());
+  EXPECT_EQ(0, queue.GetSource());
+
+  /* the freed buffers are written again, the one on screen is not */
+  EXPECT_EQ(1, queue.Queue(10.0));
+  EXPECT_EQ(2, queue.Queue(11.0));
+  EXPECT_EQ(-1, queue.Queue(12.0));
+}
@@ -0,0 +1,111 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoRenderers/RenderStats.h"
+
+#include "gtest/gtest.h"
+
+#include <math.h>
+
+/* plays count frames at fps on a display refreshing every period,
+ * each frame lands on the first vertical blank after its timestamp
+ * plus late extra blanks when the frame number is a multiple of 10 */
+static void Play(CRenderStats &stats, double fps, double period, int count, int late = 0)
+{
+  for (int i = 0; i < count; i++)
+  {
+    double intended = 1.0 + i / fps;
+    stats.Decoded(intended - 0.050);
+    stats.Queued(intended - 0.040, intended, 2);
+
+    double vsync = floor(intended / period) + 1 + (i % 10 == 9 ? late : 0);
+    stats.Presented(vsync * period + 0.0001, intended, period);
+  }
+}
+
+TEST(TestRenderStats, MatchedRefresh)
+{
+  CRenderStats stats;
+  Play(stats, 24000.0 / 1001.0, 1001.0 / 24000.0, 100);
+
+  SRenderStatsSummary summary;
+  stats.GetSummary(summary);
+  EXPECT_EQ(100u, summary.frames);
+  EXPECT_EQ(0u, summary.dropped);
+  EXPECT_EQ(0u, summary.missedVsyncs);
+  EXPECT_EQ(100u, summary.window);
+  EXPECT_EQ(99u, summary.durations[1]);
+  EXPECT_NEAR(2.0, summary.avgQueue, 0.001);
+  EXPECT_GT(summary.avgLatency, 40.0);
+}
+
+TEST(TestRenderStats, Pulldown)
+{
+  /* 23.976 on a 60 Hz display alternates between 2 and 3 blanks per frame */
+  CRenderStats stats;
+  Play(stats, 24000.0 / 1001.0, 1.0 / 60.0, 200);
+
+  SRenderStatsSummary summary;
+  stats.GetSummary(summary);
+  EXPECT_EQ(0u, summary.durations[1]);
+  EXPECT_EQ(0u, summary.durations[4]);
+  EXPECT_NEAR(summary.durations[2], summary.durations[3], 4u);
+  EXPECT_EQ(199u, summary.durations[2] + summary.durations[3]);
+}
+
+TEST(TestRenderStats, MissedAndDropped)
+{
+  CRenderStats stats;
+  Play(stats, 25.0, 1.0 / 50.0, 50, 1);
+
+  /* a frame queued but overtaken by the next one */
+  stats.Queued(3.0, 3.00, 1);
+  stats.Queued(3.0, 3.041, 1);
+  stats.Presented(3.0601, 3.041, 1.0 / 50.0);
+
+  SRenderStatsSummary summary;
+  stats.GetSummary(summary);
+  EXPECT_EQ(51u, summary.frames);
+  EXPECT_EQ(1u, summary.dropped);
+  EXPECT_EQ(5u, summary.missedVsyncs);
+  EXPECT_GT(summary.maxError, 20.0);
+
+  /* discarded frames are not drops */
+  stats.Queued(4.0, 4.00, 1);
+  stats.Discard();
+  stats.GetSummary(summary);
+  EXPECT_EQ(1u, summary.dropped);
+
+  stats.Reset();
+  stats.GetSummary(summary);
+  EXPECT_EQ(0u, summary.frames);
+  EXPECT_EQ(0u, summary.window);
+}
+
+TEST(TestRenderStats, Window)
+{
+  CRenderStats stats;
+  Play(stats, 50.0, 1.0 / 50.0, RENDERSTATS_FRAMES + 10);
+
+  SRenderFrameTiming frames[RENDERSTATS_FRAMES + 10];
+  EXPECT_EQ((unsigned int)RENDERSTATS_FRAMES, stats.GetFrames(frames, RENDERSTATS_FRAMES + 10));
+  EXPECT_NEAR(1.0 + 10 / 50.0, frames[0].intended, 0.0001);
+  EXPECT_LT(frames[0].vsync, frames[1].vsync);
+}
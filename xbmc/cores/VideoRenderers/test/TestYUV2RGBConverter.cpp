@@ -0,0 +1,166 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "cores/VideoRenderers/YUV2RGBConverter.h"
+#include "DllSwScale.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <vector>
+
+/* a picture with random planes, the strides are padded like the decoders do */
+class YUV2RGBPicture
+{
+public:
+  YUV2RGBPicture(ERenderFormat format, unsigned int width, unsigned int height) :
+    m_width(width), m_height(height)
+  {
+    unsigned int chroma = (width + 1) / 2;
+    m_stride[0] = (width + 31) & ~31;
+    m_stride[1] = format == RENDER_FMT_NV12 ? m_stride[0] : ((chroma + 31) & ~31);
+    m_stride[2] = format == RENDER_FMT_NV12 ? 0 : m_stride[1];
+
+    for (int i = 0; i < 3; ++i)
+    {
+      unsigned int rows = i == 0 ? height : (height + 1) / 2;
+      m_data[i].resize(m_stride[i] * rows + 16);
+      for (unsigned int j = 0; j < m_data[i].size(); ++j)
+        m_data[i][j] = (uint8_t)rand();
+      m_plane[i] = m_stride[i] ? &m_data[i][0] : NULL;
+    }
+  }
+
+  std::vector<uint8_t> Convert(CYUV2RGBConverter &converter, ERenderFormat format)
+  {
+    std::vector<uint8_t> out(m_width * m_height * 4);
+    converter.Convert(format, m_plane, m_stride, m_width, m_height, &out[0], m_width * 4);
+    return out;
+  }
+
+  unsigned int          m_width;
+  unsigned int          m_height;
+  uint8_t              *m_plane[3];
+  int                   m_stride[3];
+  std::vector<uint8_t>  m_data[3];
+};
+
+TEST(TestYUV2RGBConverter, Supports)
+{
+  EXPECT_TRUE (CYUV2RGBConverter::Supports(RENDER_FMT_YUV420P));
+  EXPECT_TRUE (CYUV2RGBConverter::Supports(RENDER_FMT_NV12));
+  EXPECT_FALSE(CYUV2RGBConverter::Supports(RENDER_FMT_YUYV422));
+
+  CYUV2RGBConverter converter(1);
+  uint8_t *src[3]    = {};
+  int      stride[3] = {};
+  uint8_t  dst[4];
+  EXPECT_FALSE(converter.Convert(RENDER_FMT_UYVY422, src, stride, 1, 1, dst, 4));
+}
+
+TEST(TestYUV2RGBConverter, Levels)
+{
+  /* limited range black and white */
+  uint8_t y[2] = { 16, 235 }, u = 128, v = 128;
+  uint8_t *src[3]    = { y, &u, &v };
+  int      stride[3] = { 2, 1, 1 };
+  uint8_t  dst[12];
+
+  CYUV2RGBConverter converter(1);
+  ASSERT_TRUE(converter.Convert(RENDER_FMT_YUV420P, src, stride, 2, 1, dst, 8));
+  for (int c = 0; c < 3; ++c)
+  {
+    EXPECT_EQ(0  , dst[c]);
+    EXPECT_EQ(255, dst[4 + c]);
+  }
+  EXPECT_EQ(255, dst[3]);
+  EXPECT_EQ(255, dst[7]);
+}
+
+TEST(TestYUV2RGBConverter, SIMDMatchesScalar)
+{
+  CYUV2RGBConverter simd(1, true);
+  CYUV2RGBConverter scalar(1, false);
+
+  /* odd width so the scalar tail runs after the vector loop */
+  YUV2RGBPicture yv12(RENDER_FMT_YUV420P, 723, 65);
+  EXPECT_TRUE(yv12.Convert(simd, RENDER_FMT_YUV420P) == yv12.Convert(scalar, RENDER_FMT_YUV420P));
+
+  YUV2RGBPicture nv12(RENDER_FMT_NV12, 723, 65);
+  EXPECT_TRUE(nv12.Convert(simd, RENDER_FMT_NV12) == nv12.Convert(scalar, RENDER_FMT_NV12));
+}
+
+TEST(TestYUV2RGBConverter, ThreadsMatchSingle)
+{
+  CYUV2RGBConverter threaded(4);
+  CYUV2RGBConverter single(1);
+
+  YUV2RGBPicture picture(RENDER_FMT_YUV420P, 640, 362);
+  EXPECT_TRUE(picture.Convert(threaded, RENDER_FMT_YUV420P) == picture.Convert(single, RENDER_FMT_YUV420P));
+  /* the workers are reused for the next picture */
+  EXPECT_TRUE(picture.Convert(threaded, RENDER_FMT_YUV420P) == picture.Convert(single, RENDER_FMT_YUV420P));
+}
+
+static double TimeConvert(CYUV2RGBConverter &converter, YUV2RGBPicture &picture, std::vector<uint8_t> &out, int loops)
+{
+  int64_t start = CurrentHostCounter();
+  for (int i = 0; i < loops; ++i)
+    converter.Convert(RENDER_FMT_YUV420P, picture.m_plane, picture.m_stride,
+                      picture.m_width, picture.m_height, &out[0], picture.m_width * 4);
+  return (double)(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency() / loops;
+}
+
+/* timings only, not part of the unit tests, run it by hand with
+ *   ./xbmc-test --gtest_also_run_disabled_tests --gtest_filter=TestYUV2RGBConverter.* */
+TEST(TestYUV2RGBConverter, DISABLED_Benchmark1080p)
+{
+  const int loops = 20;
+  YUV2RGBPicture       picture(RENDER_FMT_YUV420P, 1920, 1080);
+  std::vector<uint8_t> out(1920 * 1080 * 4);
+
+  CYUV2RGBConverter scalar(1, false), simd(1, true), threaded(0, true);
+  std::cout << "scalar:   " << TimeConvert(scalar  , picture, out, loops) << " ms" << std::endl;
+  std::cout << "simd:     " << TimeConvert(simd    , picture, out, loops) << " ms" << std::endl;
+  std::cout << "threaded: " << TimeConvert(threaded, picture, out, loops) << " ms" << std::endl;
+
+  DllSwScale dll;
+  if (!dll.Load())
+    return;
+
+  struct SwsContext *context = dll.sws_getContext(1920, 1080, PIX_FMT_YUV420P,
+                                                  1920, 1080, PIX_FMT_BGRA,
+                                                  SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
+  ASSERT_TRUE(context != NULL);
+
+  uint8_t *dst[]       = { &out[0], 0, 0, 0 };
+  int      dstStride[] = { 1920 * 4, 0, 0, 0 };
+  int      stride[]    = { picture.m_stride[0], picture.m_stride[1], picture.m_stride[2], 0 };
+  uint8_t *src[]       = { picture.m_plane[0], picture.m_plane[1], picture.m_plane[2], 0 };
+
+  int64_t start = CurrentHostCounter();
+  for (int i = 0; i < loops; ++i)
+    dll.sws_scale(context, src, stride, 0, 1080, dst, dstStride);
+  std::cout << "swscale:  " << (double)(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency() / loops
+            << " ms" << std::endl;
+
+  dll.sws_freeContext(context);
+}
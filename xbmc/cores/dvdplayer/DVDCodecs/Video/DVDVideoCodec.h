@@ -237,4 +237,16 @@ public:
   {
     return 0;
   }
+
+  /*
+   *
+   * How many packets the decoder holds back before it returns
+   * the picture of a packet, e.g. when decoding frames in parallel.
+   * Such decoders return their remaining pictures when fed empty
+   * packets at the end of the stream
+   */
+  virtual unsigned GetDecoderDelay()
+  {
+    return 0;
+  }
 };
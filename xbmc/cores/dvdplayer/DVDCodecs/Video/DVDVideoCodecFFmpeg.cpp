@@ -138,6 +138,8 @@ CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg() : CDVDVideoCodec()
   m_iScreenHeight = 0;
   m_iOrientation = 0;
   m_bSoftware = false;
+  m_bFrameThreading = false;
+  m_iDecoderDelay = 0;
   m_pHardware = NULL;
   m_iLastKeyframe = 0;
   m_dts = DVD_NOPTS_VALUE;
@@ -176,6 +178,18 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   pCodec = NULL;
   m_pCodecContext = NULL;
 
+  /* frame threading is opt in, it delays every picture by a packet per thread
+   * and can't be combined with hardware decoding, so it forces software */
+  if (g_advancedSettings.m_videoFrameThreading && !hints.software)
+  {
+    AVCodec* decoder = m_dllAvCodec.avcodec_find_decoder(hints.codec);
+    if (decoder && (decoder->capabilities & CODEC_CAP_FRAME_THREADS))
+    {
+      m_bFrameThreading = true;
+      m_bSoftware       = true;
+    }
+  }
+
   if (hints.codec == CODEC_ID_H264)
   {
     switch(hints.profile)
@@ -245,10 +259,10 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_pCodecContext->workaround_bugs = FF_BUG_AUTODETECT;
   m_pCodecContext->get_format = GetFormat;
   m_pCodecContext->codec_tag = hints.codec_tag;
-  /* Only allow slice threading, since frame threading is more
-   * sensitive to changes in frame sizes, and it causes crashes
-   * during HW accell */
-  m_pCodecContext->thread_type = FF_THREAD_SLICE;
+  /* Only allow slice threading unless asked for frame threading, since
+   * frame threading is more sensitive to changes in frame sizes, and it
+   * causes crashes during HW accell */
+  m_pCodecContext->thread_type = m_bFrameThreading ? FF_THREAD_FRAME | FF_THREAD_SLICE : FF_THREAD_SLICE;
 
 #if defined(TARGET_DARWIN_IOS)
   // ffmpeg with enabled neon will crash and burn if this is enabled
@@ -292,7 +306,16 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   }
 
   int num_threads = std::min(8 /*MAX_THREADS*/, g_cpuInfo.getCPUCount());
-  if( num_threads > 1 && !hints.software && m_pHardware == NULL // thumbnail extraction fails when run threaded
+  if (m_bFrameThreading)
+  {
+    /* one thread more than cores keeps every core busy while a thread waits on its references */
+    if (g_advancedSettings.m_videoDecodeThreads > 0)
+      num_threads = g_advancedSettings.m_videoDecodeThreads;
+    else
+      num_threads = std::min(16, g_cpuInfo.getCPUCount() + 1);
+    m_pCodecContext->thread_count = num_threads;
+  }
+  else if( num_threads > 1 && !hints.software && m_pHardware == NULL // thumbnail extraction fails when run threaded
   && ( pCodec->id == CODEC_ID_H264
     || pCodec->id == CODEC_ID_MPEG4 ))
     m_pCodecContext->thread_count = num_threads;
@@ -308,6 +331,15 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
     return false;
   }
 
+  if (m_pCodecContext->active_thread_type & FF_THREAD_FRAME)
+  {
+    m_iDecoderDelay = m_pCodecContext->thread_count - 1;
+    CLog::Log(LOGNOTICE, "CDVDVideoCodecFFmpeg::Open() Using %d frame threads, decoder delay %u",
+              m_pCodecContext->thread_count, m_iDecoderDelay);
+  }
+  else
+    m_iDecoderDelay = 0;
+
   m_pFrame = m_dllAvCodec.avcodec_alloc_frame();
   if (!m_pFrame) return false;
 
@@ -469,13 +501,16 @@ int CDVDVideoCodecFFmpeg::Decode(BYTE* pData, int iSize, double dts, double pts)
   m_dllAvCodec.av_init_packet(&avpkt);
   avpkt.data = pData;
   avpkt.size = iSize;
+  /* frame threads return the picture of an earlier packet, let ffmpeg carry the dts along */
+  if (m_iDecoderDelay)
+    avpkt.dts = pts_dtoi(dts);
   /* We lie, but this flag is only used by pngdec.c.
    * Setting it correctly would allow CorePNG decoding. */
   avpkt.flags = AV_PKT_FLAG_KEY;
   len = m_dllAvCodec.avcodec_decode_video2(m_pCodecContext, m_pFrame, &iGotPicture, &avpkt);
 
-  if(m_iLastKeyframe < m_pCodecContext->has_b_frames + 2)
-    m_iLastKeyframe = m_pCodecContext->has_b_frames + 2;
+  if(m_iLastKeyframe < m_pCodecContext->has_b_frames + (int)m_iDecoderDelay + 2)
+    m_iLastKeyframe = m_pCodecContext->has_b_frames + (int)m_iDecoderDelay + 2;
 
   if (len < 0)
   {
@@ -489,7 +524,7 @@ int CDVDVideoCodecFFmpeg::Decode(BYTE* pData, int iSize, double dts, double pts)
   if(m_pFrame->key_frame)
   {
     m_started = true;
-    m_iLastKeyframe = m_pCodecContext->has_b_frames + 2;
+    m_iLastKeyframe = m_pCodecContext->has_b_frames + (int)m_iDecoderDelay + 2;
   }
 
   /* put a limit on convergence count to avoid huge mem usage on streams without keyframes */
@@ -540,13 +575,17 @@ int CDVDVideoCodecFFmpeg::Decode(BYTE* pData, int iSize, double dts, double pts)
   if(result & VC_FLUSHED)
     Reset();
 
+  /* while draining the frame threads at the end of the stream, keep the player asking for pictures */
+  if(pData == NULL && m_iDecoderDelay)
+    result &= ~VC_BUFFER;
+
   return result;
 }
 
 void CDVDVideoCodecFFmpeg::Reset()
 {
   m_started = false;
-  m_iLastKeyframe = m_pCodecContext->has_b_frames;
+  m_iLastKeyframe = m_pCodecContext->has_b_frames + m_iDecoderDelay;
   m_dllAvCodec.avcodec_flush_buffers(m_pCodecContext);
 
   if (m_pHardware)
@@ -637,7 +676,10 @@ bool CDVDVideoCodecFFmpeg::GetPictureCommon(DVDVideoPicture* pDvdVideoPicture)
     pDvdVideoPicture->qscale_type = DVP_QSCALE_UNKNOWN;
   }
 
-  pDvdVideoPicture->dts = m_dts;
+  if (m_iDecoderDelay)
+    pDvdVideoPicture->dts = m_pFrame->pkt_dts == (int64_t)AV_NOPTS_VALUE ? DVD_NOPTS_VALUE : pts_itod(m_pFrame->pkt_dts);
+  else
+    pDvdVideoPicture->dts = m_dts;
   m_dts = DVD_NOPTS_VALUE;
   if (m_pFrame->reordered_opaque)
     pDvdVideoPicture->pts = pts_itod(m_pFrame->reordered_opaque);
@@ -60,6 +60,7 @@ public:
   virtual unsigned int SetFilters(unsigned int filters);
   virtual const char* GetName() { return m_name.c_str(); }; // m_name is never changed after open
   virtual unsigned GetConvergeCount();
+  virtual unsigned GetDecoderDelay() { return m_iDecoderDelay; }
 
   bool               IsHardwareAllowed()                     { return !m_bSoftware; }
   IHardwareDecoder * GetHardware()                           { return m_pHardware; };
@@ -114,6 +115,8 @@ protected:
 
   std::string m_name;
   bool              m_bSoftware;
+  bool              m_bFrameThreading; /* decode with FF_THREAD_FRAME, hardware is not allowed */
+  unsigned          m_iDecoderDelay;   /* packets held back by the frame threads */
   IHardwareDecoder *m_pHardware;
   int m_iLastKeyframe;
   double m_dts;
@@ -220,6 +220,8 @@ CDVDDemuxFFmpeg::CDVDDemuxFFmpeg() : CDVDDemux()
   m_speed = DVD_PLAYSPEED_NORMAL;
   m_program = UINT_MAX;
   m_bPlexTranscode = false;
+  m_seekIndexStream = -1;
+  m_seekIndexLength = 0;
 }
 
 CDVDDemuxFFmpeg::~CDVDDemuxFFmpeg()
@@ -542,11 +544,58 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
       AddStream(i);
   }
 
+  OpenSeekIndex();
+
   return true;
 }
 
+void CDVDDemuxFFmpeg::OpenSeekIndex()
+{
+  m_seekIndexStream = -1;
+  m_seekIndex.Clear();
+
+  // only containers without an index, lavf seeks those by searching the file
+  if (strcmp(m_pFormatContext->iformat->name, "mpegts") != 0
+  &&  strcmp(m_pFormatContext->iformat->name, "mpeg") != 0)
+    return;
+
+  if (m_bPlexTranscode
+  || !m_pInput->Seek(0, SEEK_POSSIBLE)
+  ||  dynamic_cast<CDVDInputStream::ISeekTime*>(m_pInput)
+  ||  dynamic_cast<CDVDInputStream::IMenus*>(m_pInput))
+    return;
+
+  for (int i = 0; i < MAX_STREAMS; i++)
+  {
+    if (m_streams[i] && m_streams[i]->type == STREAM_VIDEO)
+    {
+      m_seekIndexStream = i;
+      break;
+    }
+  }
+
+  if (m_seekIndexStream < 0)
+    return;
+
+  m_seekIndexFile   = CDVDDemuxSeekIndex::GetCachePath(m_pInput->GetFileName());
+  m_seekIndexLength = m_pInput->GetLength();
+  m_seekIndex.Load(m_seekIndexFile, m_seekIndexLength);
+}
+
+void CDVDDemuxFFmpeg::CloseSeekIndex()
+{
+  // a single keyframe never brackets a seek, so nothing worth keeping
+  if (m_seekIndexStream >= 0 && m_seekIndex.Changed() && m_seekIndex.Size() > 1)
+    m_seekIndex.Save(m_seekIndexFile, m_seekIndexLength);
+
+  m_seekIndex.Clear();
+  m_seekIndexStream = -1;
+}
+
 void CDVDDemuxFFmpeg::Dispose()
 {
+  CloseSeekIndex();
+
   if (m_pFormatContext)
   {
     if (m_ioContext && m_pFormatContext->pb && m_pFormatContext->pb != m_ioContext)
@@ -817,6 +866,14 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
         pPacket->dts = ConvertTimestamp(pkt.dts, stream->time_base.den, stream->time_base.num);
         pPacket->duration =  DVD_SEC_TO_TIME((double)pkt.duration * stream->time_base.num / stream->time_base.den);
 
+        // remember where keyframes are for later seeks
+        if (pkt.stream_index == m_seekIndexStream && (pkt.flags & AV_PKT_FLAG_KEY) && pkt.pos >= 0)
+        {
+          double ts = pPacket->dts != DVD_NOPTS_VALUE ? pPacket->dts : pPacket->pts;
+          if (ts != DVD_NOPTS_VALUE)
+            m_seekIndex.Add(DVD_TIME_TO_MSEC(ts), pkt.pos);
+        }
+
         // used to guess streamlength
         if (pPacket->dts != DVD_NOPTS_VALUE && (pPacket->dts > m_iCurrentPts || m_iCurrentPts == DVD_NOPTS_VALUE))
           m_iCurrentPts = pPacket->dts;
@@ -921,6 +978,23 @@ bool CDVDDemuxFFmpeg::SeekTime(int time, bool backwords, double *startpts)
     return false;
   }
 
+  // a keyframe seen before takes a single seek on the input instead of a search
+  int     keytime;
+  int64_t keypos;
+  if (m_seekIndexStream >= 0 && m_seekIndex.Find(time, backwords, keytime, keypos))
+  {
+    CSingleLock lock(m_critSection);
+    if (m_dllAvFormat.av_seek_frame(m_pFormatContext, -1, keypos, AVSEEK_FLAG_BYTE) >= 0)
+    {
+      m_iCurrentPts = DVD_MSEC_TO_TIME(keytime);
+      CLog::Log(LOGDEBUG, "%s - seek index placed seek to %d at keyframe %d", __FUNCTION__, time, keytime);
+
+      if(startpts)
+        *startpts = DVD_MSEC_TO_TIME(time);
+      return true;
+    }
+  }
+
   int64_t seek_pts = (int64_t)time * (AV_TIME_BASE / 1000);
   if (m_pFormatContext->start_time != (int64_t)AV_NOPTS_VALUE)
     seek_pts += m_pFormatContext->start_time;
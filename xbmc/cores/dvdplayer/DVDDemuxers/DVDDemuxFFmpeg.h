@@ -21,6 +21,7 @@
  */
 
 #include "DVDDemux.h"
+#include "DVDDemuxSeekIndex.h"
 #include "DllAvFormat.h"
 #include "DllAvCodec.h"
 #include "DllAvUtil.h"
@@ -130,6 +131,8 @@ protected:
   AVDictionary *GetFFMpegOptionsFromURL(const CURL &url);
   double ConvertTimestamp(int64_t pts, int den, int num);
   void UpdateCurrentPTS();
+  void OpenSeekIndex();
+  void CloseSeekIndex();
 
   CCriticalSection m_critSection;
   #define MAX_STREAMS 100
@@ -148,6 +151,11 @@ protected:
   unsigned m_program;
   XbmcThreads::EndTime  m_timeout;
 
+  CDVDDemuxSeekIndex m_seekIndex;
+  int                m_seekIndexStream; // video stream keyframes are recorded for, -1 if disabled
+  CStdString         m_seekIndexFile;
+  int64_t            m_seekIndexLength;
+
   /* PLEX */
   bool m_bPlexTranscode;
   /* END PLEX */
@@ -0,0 +1,246 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDDemuxSeekIndex.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "FileItem.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "URL.h"
+
+#include <algorithm>
+#include <string.h>
+
+#define SEEKINDEX_PATH "special://temp/seekindex/"
+
+/* keyframes closer than this to one already known aren't recorded */
+#define SEEKINDEX_SPACING 1000
+/* entries further apart than this don't say anything about the part between them */
+#define SEEKINDEX_MAXGAP  10000
+/* files not written for this many days, or beyond this many, are removed */
+#define SEEKINDEX_MAXAGE   30
+#define SEEKINDEX_MAXFILES 500
+
+static const char s_magic[4] = { 'D', 'S', 'I', '1' };
+
+static bool NewerThan(const CFileItemPtr& a, const CFileItemPtr& b)
+{
+  return a->m_dateTime > b->m_dateTime;
+}
+
+CDVDDemuxSeekIndex::CDVDDemuxSeekIndex()
+{
+  m_changed = false;
+}
+
+void CDVDDemuxSeekIndex::Clear()
+{
+  m_entries.clear();
+  m_changed = false;
+}
+
+void CDVDDemuxSeekIndex::Add(int time, int64_t pos)
+{
+  if(time < 0 || pos < 0)
+    return;
+
+  std::vector<SEntry>::iterator it = std::lower_bound(m_entries.begin(), m_entries.end(), time, Before);
+
+  if(it != m_entries.end() && it->time - time < SEEKINDEX_SPACING)
+    return;
+  if(it != m_entries.begin() && time - (it - 1)->time < SEEKINDEX_SPACING)
+    return;
+
+  SEntry entry;
+  entry.time = time;
+  entry.pos  = pos;
+  m_entries.insert(it, entry);
+  m_changed = true;
+}
+
+bool CDVDDemuxSeekIndex::Find(int time, bool backwards, int& keytime, int64_t& keypos) const
+{
+  std::vector<SEntry>::const_iterator it = std::lower_bound(m_entries.begin(), m_entries.end(), time, Before);
+
+  const SEntry* prev;
+  const SEntry* next;
+  if(it != m_entries.end() && it->time == time)
+    prev = next = &*it;
+  else
+  {
+    if(it == m_entries.begin() || it == m_entries.end())
+      return false;
+    prev = &*(it - 1);
+    next = &*it;
+    if(next->time - prev->time > SEEKINDEX_MAXGAP)
+      return false;
+  }
+
+  const SEntry* entry = backwards ? prev : next;
+  keytime = entry->time;
+  keypos  = entry->pos;
+  return true;
+}
+
+void CDVDDemuxSeekIndex::Serialize(std::string& data, int64_t length) const
+{
+  uint32_t count = m_entries.size();
+
+  data.clear();
+  data.reserve(sizeof(s_magic) + sizeof(length) + sizeof(count) + count * (sizeof(int32_t) + sizeof(int64_t)));
+  data.append(s_magic, sizeof(s_magic));
+  data.append((const char*)&length, sizeof(length));
+  data.append((const char*)&count, sizeof(count));
+
+  for(std::vector<SEntry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    int32_t time = it->time;
+    data.append((const char*)&time, sizeof(time));
+    data.append((const char*)&it->pos, sizeof(it->pos));
+  }
+}
+
+bool CDVDDemuxSeekIndex::Deserialize(const std::string& data, int64_t length)
+{
+  Clear();
+
+  int64_t  stored;
+  uint32_t count;
+  size_t   header = sizeof(s_magic) + sizeof(stored) + sizeof(count);
+  size_t   entry  = sizeof(int32_t) + sizeof(int64_t);
+
+  if(data.size() < header || memcmp(data.data(), s_magic, sizeof(s_magic)) != 0)
+    return false;
+
+  const char* ptr = data.data() + sizeof(s_magic);
+  memcpy(&stored, ptr, sizeof(stored)); ptr += sizeof(stored);
+  memcpy(&count , ptr, sizeof(count));  ptr += sizeof(count);
+
+  if(stored != length || data.size() != header + count * entry)
+    return false;
+
+  m_entries.resize(count);
+  for(uint32_t i = 0; i < count; i++)
+  {
+    int32_t time;
+    memcpy(&time, ptr, sizeof(time));                   ptr += sizeof(time);
+    memcpy(&m_entries[i].pos, ptr, sizeof(int64_t));    ptr += sizeof(int64_t);
+    m_entries[i].time = time;
+
+    if(i > 0 && m_entries[i].time <= m_entries[i-1].time)
+    {
+      Clear();
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CDVDDemuxSeekIndex::Load(const CStdString& file, int64_t length)
+{
+  XFILE::CFile stream;
+  if(!stream.Open(file))
+    return false;
+
+  std::string data;
+  data.resize((size_t)stream.GetLength());
+  if(!data.empty() && stream.Read(&data[0], data.size()) != data.size())
+    return false;
+
+  if(!Deserialize(data, length))
+  {
+    CLog::Log(LOGDEBUG, "CDVDDemuxSeekIndex::Load - ignoring stale index %s", file.c_str());
+    return false;
+  }
+
+  CLog::Log(LOGDEBUG, "CDVDDemuxSeekIndex::Load - loaded %u keyframes from %s", (unsigned)m_entries.size(), file.c_str());
+  return true;
+}
+
+bool CDVDDemuxSeekIndex::Save(const CStdString& file, int64_t length)
+{
+  std::string data;
+  Serialize(data, length);
+
+  XFILE::CDirectory::Create(SEEKINDEX_PATH);
+
+  XFILE::CFile stream;
+  if(!stream.OpenForWrite(file, true))
+  {
+    CLog::Log(LOGWARNING, "CDVDDemuxSeekIndex::Save - unable to write %s", file.c_str());
+    return false;
+  }
+
+  if(stream.Write(data.data(), data.size()) != (int)data.size())
+    return false;
+
+  m_changed = false;
+
+  CDateTime cutoff = CDateTime::GetCurrentDateTime() - CDateTimeSpan(SEEKINDEX_MAXAGE, 0, 0, 0);
+  Prune(SEEKINDEX_PATH, SEEKINDEX_MAXFILES, cutoff);
+  return true;
+}
+
+void CDVDDemuxSeekIndex::GetExpired(const CFileItemList& items, unsigned int maxFiles, const CDateTime& cutoff, std::vector<CStdString>& expired)
+{
+  std::vector<CFileItemPtr> files;
+  for(int i = 0; i < items.Size(); i++)
+  {
+    if(!items[i]->m_bIsFolder)
+      files.push_back(items[i]);
+  }
+  std::sort(files.begin(), files.end(), NewerThan);
+
+  for(size_t i = 0; i < files.size(); i++)
+  {
+    if(i >= maxFiles || (files[i]->m_dateTime.IsValid() && files[i]->m_dateTime < cutoff))
+      expired.push_back(files[i]->GetPath());
+  }
+}
+
+void CDVDDemuxSeekIndex::Prune(const CStdString& directory, unsigned int maxFiles, const CDateTime& cutoff)
+{
+  CFileItemList items;
+  if(!XFILE::CDirectory::GetDirectory(directory, items, ".idx", XFILE::DIR_FLAG_NO_FILE_DIRS))
+    return;
+
+  std::vector<CStdString> expired;
+  GetExpired(items, maxFiles, cutoff, expired);
+  for(std::vector<CStdString>::const_iterator it = expired.begin(); it != expired.end(); ++it)
+    XFILE::CFile::Delete(*it);
+
+  if(!expired.empty())
+    CLog::Log(LOGDEBUG, "CDVDDemuxSeekIndex::Prune - removed %u old index files", (unsigned)expired.size());
+}
+
+CStdString CDVDDemuxSeekIndex::GetCachePath(const CStdString& file)
+{
+  CURL url(file);
+  url.SetOptions("");
+  url.SetProtocolOptions("");
+
+  Crc32 crc;
+  crc.ComputeFromLowerCase(url.Get());
+
+  CStdString path;
+  path.Format(SEEKINDEX_PATH "%08x.idx", (unsigned int)crc);
+  return path;
+}
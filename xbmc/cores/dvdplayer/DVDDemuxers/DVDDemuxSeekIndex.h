@@ -0,0 +1,85 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/StdString.h"
+#include "XBDateTime.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class CFileItemList;
+
+/**
+ * Keyframe positions of a file seen while demuxing, so seeks in containers
+ * without an index (mpeg-ts, mpeg-ps) can go straight to a byte offset
+ * instead of letting lavf search the file. Kept in special://temp between
+ * plays of the same file.
+ */
+class CDVDDemuxSeekIndex
+{
+public:
+  CDVDDemuxSeekIndex();
+
+  void Clear();
+
+  /* records a keyframe, time is in ms from the start of the stream */
+  void Add(int time, int64_t pos);
+
+  /**
+   * Finds the keyframe to start decoding at for a seek to time. Fails when
+   * the index hasn't seen the part of the file around time.
+   */
+  bool Find(int time, bool backwards, int& keytime, int64_t& keypos) const;
+
+  size_t Size() const    { return m_entries.size(); }
+  bool   Changed() const { return m_changed; }
+
+  /* length is the size of the file, an index saved for another length is ignored */
+  void Serialize(std::string& data, int64_t length) const;
+  bool Deserialize(const std::string& data, int64_t length);
+
+  bool Load(const CStdString& file, int64_t length);
+  bool Save(const CStdString& file, int64_t length);
+
+  /* cache file for a media file, request options such as tokens are not part of the key */
+  static CStdString GetCachePath(const CStdString& file);
+
+  /**
+   * Index files to remove from a listing of the cache, newest first: all
+   * last written before cutoff and all past the first maxFiles. Save prunes
+   * the cache with this, so it doesn't grow with every file ever played.
+   */
+  static void GetExpired(const CFileItemList& items, unsigned int maxFiles, const CDateTime& cutoff, std::vector<CStdString>& expired);
+  static void Prune(const CStdString& directory, unsigned int maxFiles, const CDateTime& cutoff);
+
+private:
+  struct SEntry
+  {
+    int     time;
+    int64_t pos;
+  };
+  static bool Before(const SEntry& entry, int time) { return entry.time < time; }
+
+  std::vector<SEntry> m_entries;
+  bool                m_changed;
+};
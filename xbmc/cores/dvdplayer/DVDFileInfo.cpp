@@ -171,16 +171,14 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
     CDVDStreamInfo hint(*pDemuxer->GetStream(nVideoStream), true);
     hint.software = true;
 
-    if (hint.codec == CODEC_ID_MPEG2VIDEO || hint.codec == CODEC_ID_MPEG1VIDEO)
-    {
-      // libmpeg2 is not thread safe so use ffmepg for mpeg2/mpeg1 thumb extraction
-      CDVDCodecOptions dvdOptions;
-      pVideoCodec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, dvdOptions);
-    }
-    else
-    {
+    // libmpeg2 is not thread safe so use ffmpeg for thumb extraction, and
+    // only decode the keyframe the demuxer seeks to
+    CDVDCodecOptions dvdOptions;
+    dvdOptions.m_keys.push_back(CDVDCodecOption("skip_frame", "nokey"));
+    dvdOptions.m_keys.push_back(CDVDCodecOption("skip_loop_filter", "all"));
+    pVideoCodec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, dvdOptions);
+    if (!pVideoCodec)
       pVideoCodec = CDVDFactoryCodec::CreateVideoCodec( hint );
-    }
 
     if (pVideoCodec)
     {
@@ -198,6 +196,7 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
 
         // num streams * 80 frames, should get a valid frame, if not abort.
         int abort_index = pDemuxer->GetNrOfStreams() * 80;
+        bool decoded = false;
         do
         {
           pPacket = pDemuxer->Read();
@@ -214,6 +213,7 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
 
           iDecoderState = pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
           CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+          decoded = true;
 
           if (iDecoderState & VC_ERROR)
             break;
@@ -230,6 +230,15 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
 
         } while (abort_index--);
 
+        // with only keyframes decoded the picture may still be held back for reordering
+        if (decoded && !(iDecoderState & (VC_ERROR | VC_PICTURE)))
+        {
+          iDecoderState = pVideoCodec->Decode(NULL, 0, DVD_NOPTS_VALUE, DVD_NOPTS_VALUE);
+          memset(&picture, 0, sizeof(DVDVideoPicture));
+          if (!(iDecoderState & VC_PICTURE) || !pVideoCodec->GetPicture(&picture))
+            iDecoderState = VC_ERROR;
+        }
+
         if (iDecoderState & VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
         {
           {
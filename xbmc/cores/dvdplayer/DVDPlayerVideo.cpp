@@ -437,6 +437,10 @@ void CDVDPlayerVideo::Process()
       }
       picture.iFlags &= ~DVP_FLAG_ALLOCATED;
       m_packets.clear();
+      m_packetDrops.clear();
+#ifdef HAS_VIDEO_PLAYBACK
+      g_renderManager.DiscardQueue();
+#endif
       m_started = false;
     }
     else if (pMsg->IsType(CDVDMsg::GENERAL_FLUSH)) // private message sent by (CDVDPlayerVideo::Flush())
@@ -450,6 +454,10 @@ void CDVDPlayerVideo::Process()
       }
       picture.iFlags &= ~DVP_FLAG_ALLOCATED;
       m_packets.clear();
+      m_packetDrops.clear();
+#ifdef HAS_VIDEO_PLAYBACK
+      g_renderManager.DiscardQueue();
+#endif
 
       m_pullupCorrection.Flush();
       //we need to recalculate the framerate
@@ -484,6 +492,22 @@ void CDVDPlayerVideo::Process()
       OpenStream(msg->m_hints, msg->m_codec);
       msg->m_codec = NULL;
       picture.iFlags &= ~DVP_FLAG_ALLOCATED;
+      m_packetDrops.clear();
+    }
+    else if (pMsg->IsType(CDVDMsg::GENERAL_EOF))
+    {
+      // decoders that hold back pictures return them when fed empty packets,
+      // queue one so the last pictures go through the normal output path
+      if (m_pVideoCodec && m_pVideoCodec->GetDecoderDelay() > 0)
+      {
+        DemuxPacket* pPacket = CDVDDemuxUtils::AllocateDemuxPacket(0);
+        if (pPacket)
+        {
+          pPacket->dts = DVD_NOPTS_VALUE;
+          pPacket->pts = DVD_NOPTS_VALUE;
+          m_messageQueue.Put(new CDVDMsgDemuxerPacket(pPacket));
+        }
+      }
     }
 
     if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET))
@@ -552,6 +576,17 @@ void CDVDPlayerVideo::Process()
 
       int iDecoderState = m_pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
 
+      // a delaying decoder returns the picture of an earlier packet, so the
+      // drop flag has to travel with the packet until its picture comes out
+      unsigned int decoderDelay = m_pVideoCodec->GetDecoderDelay();
+      if (decoderDelay > 0)
+      {
+        if (pPacket->pData)
+          m_packetDrops.push_back(bPacketDrop);
+        while (m_packetDrops.size() > decoderDelay + 1)
+          m_packetDrops.pop_front();
+      }
+
       // buffer packets so we can recover should decoder flush for some reason
       if(m_pVideoCodec->GetConvergeCount() > 0)
       {
@@ -596,6 +631,7 @@ void CDVDPlayerVideo::Process()
           memset(&picture, 0, sizeof(DVDVideoPicture));
           /* END PLEX */
           m_packets.clear();
+          m_packetDrops.clear();
           break;
         }
 
@@ -621,7 +657,15 @@ void CDVDPlayerVideo::Process()
             if(picture.iDuration == 0.0)
               picture.iDuration = frametime;
 
-            if(bPacketDrop)
+            bool bPictureDrop = bPacketDrop;
+            if (decoderDelay > 0)
+            {
+              bPictureDrop = !m_packetDrops.empty() && m_packetDrops.front();
+              if (!m_packetDrops.empty())
+                m_packetDrops.pop_front();
+            }
+
+            if(bPictureDrop)
               picture.iFlags |= DVP_FLAG_DROPPED;
 
             if (m_iNrOfPicturesNotToSkip > 0)
@@ -31,6 +31,8 @@
 #include "cores/VideoRenderers/RenderManager.h"
 #endif
 
+#include <deque>
+
 enum CodecID;
 class CDemuxStreamVideo;
 class CDVDOverlayCodecCC;
@@ -195,5 +197,6 @@ protected:
   CPullupCorrection m_pullupCorrection;
 
   std::list<DVDMessageListItem> m_packets;
+  std::deque<bool>              m_packetDrops; /* drop flags of packets still held back by the decoder */
 };
 
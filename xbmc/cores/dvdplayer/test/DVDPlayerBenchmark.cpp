@@ -0,0 +1,433 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "DVDPlayerBenchmark.h"
+#include "DVDClock.h"
+#include "DVDMessage.h"
+#include "DVDMessageQueue.h"
+#include "DVDStreamInfo.h"
+#include "DVDInputStreams/DVDInputStream.h"
+#include "DVDInputStreams/DVDFactoryInputStream.h"
+#include "DVDDemuxers/DVDDemux.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDDemuxers/DVDFactoryDemuxer.h"
+#include "DVDCodecs/DVDCodecs.h"
+#include "DVDCodecs/DVDFactoryCodec.h"
+#include "DVDCodecs/Video/DVDVideoCodec.h"
+#include "DVDCodecs/Audio/DVDAudioCodec.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "threads/Thread.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <string.h>
+#include <algorithm>
+
+/* shared wall clock the output stages pace against in real time mode */
+class CDVDBenchmarkClock
+{
+public:
+  CDVDBenchmarkClock() : m_start(DVD_NOPTS_VALUE), m_startPts(DVD_NOPTS_VALUE) {}
+
+  /* waits until pts is due, returns how late it is in seconds */
+  double Wait(double pts)
+  {
+    { CSingleLock lock(m_section);
+      if (m_start == DVD_NOPTS_VALUE)
+      {
+        m_start    = CDVDClock::GetAbsoluteClock();
+        m_startPts = pts;
+      }
+    }
+    double target = m_start + pts - m_startPts;
+    double now    = CDVDClock::WaitAbsoluteClock(target);
+    return std::max(0.0, now - target) / DVD_TIME_BASE;
+  }
+
+private:
+  CCriticalSection m_section;
+  double           m_start;
+  double           m_startPts;
+};
+
+class CDVDBenchmarkStage : public CThread
+{
+public:
+  CDVDBenchmarkStage(const char *name, CDVDBenchmarkClock *clock) :
+    CThread(name), m_queue(name), m_end(0.0), m_clock(clock)
+  {
+    memset(&m_stats, 0, sizeof(m_stats));
+    m_queue.SetMaxDataSize(8 * 1024 * 1024);
+    m_queue.SetMaxTimeSize(8.0);
+    m_queue.Init();
+  }
+
+  virtual ~CDVDBenchmarkStage() {}
+
+  CDVDMessageQueue   m_queue;
+  SDVDBenchmarkStage m_stats;
+  double             m_end;  // absolute clock when the last frame came out
+
+protected:
+  virtual void HandlePacket(DemuxPacket *packet) = 0;
+
+  virtual void Process()
+  {
+    while (!m_bStop)
+    {
+      CDVDMsg *msg;
+      MsgQueueReturnCode ret = m_queue.Get(&msg, 100);
+      if (ret == MSGQ_TIMEOUT)
+        continue;
+      if (MSGQ_IS_ERROR(ret))
+        break;
+
+      bool eof = msg->IsType(CDVDMsg::GENERAL_EOF);
+      if (msg->IsType(CDVDMsg::DEMUXER_PACKET))
+      {
+        m_stats.packets++;
+        HandlePacket(((CDVDMsgDemuxerPacket*)msg)->GetPacket());
+      }
+      msg->Release();
+
+      if (eof)
+        break;
+    }
+
+    m_end           = CDVDClock::GetAbsoluteClock();
+    m_stats.cpuTime = GetAbsoluteUsage() / 10000000.0;
+  }
+
+  CDVDBenchmarkClock *m_clock;
+};
+
+/* decodes and drops pictures, a renderer that never draws */
+class CDVDBenchmarkVideo : public CDVDBenchmarkStage
+{
+public:
+  CDVDBenchmarkVideo(CDVDBenchmarkClock *clock) :
+    CDVDBenchmarkStage("BenchmarkVideo", clock), m_codec(NULL), m_frametime(0.0) {}
+
+  virtual ~CDVDBenchmarkVideo() { delete m_codec; }
+
+  bool Open(CDVDStreamInfo &hint)
+  {
+    hint.software = true;
+    m_codec = CDVDFactoryCodec::CreateVideoCodec(hint);
+    if (hint.fpsrate && hint.fpsscale)
+      m_frametime = (double)hint.fpsscale / hint.fpsrate;
+    return m_codec != NULL;
+  }
+
+protected:
+  virtual void HandlePacket(DemuxPacket *packet)
+  {
+    int state = m_codec->Decode(packet->pData, packet->iSize, packet->dts, packet->pts);
+    while (!(state & VC_ERROR))
+    {
+      if (state & VC_PICTURE)
+      {
+        DVDVideoPicture picture;
+        memset(&picture, 0, sizeof(picture));
+        if (m_codec->GetPicture(&picture) && !(picture.iFlags & DVP_FLAG_DROPPED))
+        {
+          m_stats.frames++;
+          if (m_clock && picture.pts != DVD_NOPTS_VALUE)
+          {
+            if (m_clock->Wait(picture.pts) > m_frametime)
+              m_stats.late++;
+          }
+        }
+      }
+
+      if (state & VC_BUFFER)
+        break;
+      state = m_codec->Decode(NULL, 0, DVD_NOPTS_VALUE, DVD_NOPTS_VALUE);
+    }
+  }
+
+  CDVDVideoCodec *m_codec;
+  double          m_frametime;
+};
+
+/* decodes and drops samples, pacing like a sink that plays them */
+class CDVDBenchmarkAudio : public CDVDBenchmarkStage
+{
+public:
+  CDVDBenchmarkAudio(CDVDBenchmarkClock *clock) :
+    CDVDBenchmarkStage("BenchmarkAudio", clock), m_codec(NULL), m_pts(DVD_NOPTS_VALUE) {}
+
+  virtual ~CDVDBenchmarkAudio() { delete m_codec; }
+
+  bool Open(CDVDStreamInfo &hint)
+  {
+    m_codec = CDVDFactoryCodec::CreateAudioCodec(hint, false);
+    return m_codec != NULL;
+  }
+
+protected:
+  virtual void HandlePacket(DemuxPacket *packet)
+  {
+    if (packet->pts != DVD_NOPTS_VALUE)
+      m_pts = packet->pts;
+
+    BYTE *data = packet->pData;
+    int   size = packet->iSize;
+    while (size > 0)
+    {
+      int len = m_codec->Decode(data, size);
+      if (len < 0)
+      {
+        m_codec->Reset();
+        break;
+      }
+      data += len;
+      size -= len;
+
+      BYTE *out;
+      int   bytes = m_codec->GetData(&out);
+      int   frame = m_codec->GetChannels() * (CAEUtil::DataFormatToBits(m_codec->GetDataFormat()) >> 3);
+      if (bytes <= 0 || frame <= 0)
+        continue;
+
+      unsigned int frames = bytes / frame;
+      m_stats.frames += frames;
+      if (m_clock && m_pts != DVD_NOPTS_VALUE && m_codec->GetSampleRate() > 0)
+      {
+        m_clock->Wait(m_pts);
+        m_pts += (double)frames * DVD_TIME_BASE / m_codec->GetSampleRate();
+      }
+
+      if (len == 0)
+        break;
+    }
+  }
+
+  CDVDAudioCodec *m_codec;
+  double          m_pts;
+};
+
+/* reads packets and feeds the decoder queues, like CDVDPlayer::Process */
+class CDVDBenchmarkDemux : public CThread
+{
+public:
+  CDVDBenchmarkDemux(CDVDDemux *demuxer, double duration, SDVDBenchmarkResult &result) :
+    CThread("BenchmarkDemux"),
+    m_demuxer (demuxer),
+    m_duration(duration),
+    m_result  (result),
+    m_firstPts(DVD_NOPTS_VALUE),
+    m_lastPts (DVD_NOPTS_VALUE)
+  {
+    for (int i = 0; i < 2; i++)
+    {
+      m_stage[i]   = NULL;
+      m_id[i]      = -1;
+      m_queue[i]   = NULL;
+      m_samples[i] = 0;
+    }
+  }
+
+  void AddStage(int index, int id, CDVDBenchmarkStage *stage, SDVDBenchmarkStage *queue)
+  {
+    m_id[index]    = id;
+    m_stage[index] = stage;
+    m_queue[index] = queue;
+  }
+
+  double GetMediaTime() const
+  {
+    return m_firstPts == DVD_NOPTS_VALUE ? 0.0 : (m_lastPts - m_firstPts) / DVD_TIME_BASE;
+  }
+
+protected:
+  virtual void Process()
+  {
+    DemuxPacket *packet;
+    while (!m_bStop && (packet = m_demuxer->Read()))
+    {
+      int index = packet->iStreamId == m_id[0] ? 0 : (packet->iStreamId == m_id[1] ? 1 : -1);
+      if (index < 0 || packet->iStreamId < 0)
+      {
+        CDVDDemuxUtils::FreeDemuxPacket(packet);
+        continue;
+      }
+
+      double pts = packet->dts != DVD_NOPTS_VALUE ? packet->dts : packet->pts;
+      if (pts != DVD_NOPTS_VALUE)
+      {
+        if (m_firstPts == DVD_NOPTS_VALUE)
+          m_firstPts = m_lastPts = pts;
+        m_lastPts = std::max(m_lastPts, pts);
+      }
+
+      m_result.demux.packets++;
+      m_result.bytes += packet->iSize;
+
+      /* block like the player does when a decoder falls behind */
+      CDVDMessageQueue &queue = m_stage[index]->m_queue;
+      while (queue.IsFull() && !m_bStop)
+        Sleep(10);
+      queue.Put(new CDVDMsgDemuxerPacket(packet));
+
+      SDVDBenchmarkStage &stats = *m_queue[index];
+      int level = queue.GetLevel();
+      stats.maxQueue  = std::max(stats.maxQueue, level);
+      stats.avgQueue += (level - stats.avgQueue) / ++m_samples[index];
+
+      if (m_duration > 0.0 && GetMediaTime() >= m_duration)
+        break;
+    }
+
+    m_result.demux.cpuTime = GetAbsoluteUsage() / 10000000.0;
+  }
+
+  CDVDDemux           *m_demuxer;
+  double               m_duration;
+  SDVDBenchmarkResult &m_result;
+  double               m_firstPts;
+  double               m_lastPts;
+  CDVDBenchmarkStage  *m_stage[2];
+  int                  m_id[2];
+  SDVDBenchmarkStage  *m_queue[2];
+  unsigned int         m_samples[2];
+};
+
+CDVDPlayerBenchmark::CDVDPlayerBenchmark(const CStdString &path, bool realtime, double duration) :
+  m_path    (path),
+  m_realtime(realtime),
+  m_duration(duration)
+{
+}
+
+static void FinishStage(CDVDBenchmarkStage &stage, SDVDBenchmarkStage &result, double &end)
+{
+  stage.m_queue.Put(new CDVDMsg(CDVDMsg::GENERAL_EOF));
+  stage.WaitForThreadExit(0xFFFFFFFF);
+  stage.m_queue.End();
+
+  result.packets = stage.m_stats.packets;
+  result.frames  = stage.m_stats.frames;
+  result.late    = stage.m_stats.late;
+  result.cpuTime = stage.m_stats.cpuTime;
+  end = std::max(end, stage.m_end);
+}
+
+bool CDVDPlayerBenchmark::Run(SDVDBenchmarkResult &result)
+{
+  memset(&result, 0, sizeof(result));
+  result.realtime = m_realtime;
+
+  CDVDInputStream *input = CDVDFactoryInputStream::CreateInputStream(NULL, m_path, "");
+  if (!input || !input->Open(m_path.c_str(), ""))
+  {
+    CLog::Log(LOGERROR, "CDVDPlayerBenchmark::Run - unable to open %s", m_path.c_str());
+    delete input;
+    return false;
+  }
+
+  CStdString error;
+  CDVDDemux *demuxer = CDVDFactoryDemuxer::CreateDemuxer(input, error);
+  if (!demuxer)
+  {
+    CLog::Log(LOGERROR, "CDVDPlayerBenchmark::Run - unable to demux %s: %s", m_path.c_str(), error.c_str());
+    delete input;
+    return false;
+  }
+
+  CDVDBenchmarkClock  clock;
+  CDVDBenchmarkClock *pacing = m_realtime ? &clock : NULL;
+  CDVDBenchmarkVideo  video(pacing);
+  CDVDBenchmarkAudio  audio(pacing);
+  CDVDBenchmarkDemux  demux(demuxer, m_duration, result);
+  bool hasVideo = false, hasAudio = false;
+
+  for (int i = 0; i < demuxer->GetNrOfStreams(); i++)
+  {
+    CDemuxStream *stream = demuxer->GetStream(i);
+    if (!stream)
+      continue;
+
+    CDVDStreamInfo hint(*stream, true);
+    if (stream->type == STREAM_VIDEO && !hasVideo && video.Open(hint))
+    {
+      demux.AddStage(0, stream->iId, &video, &result.video);
+      hasVideo = true;
+    }
+    else if (stream->type == STREAM_AUDIO && !hasAudio && audio.Open(hint))
+    {
+      demux.AddStage(1, stream->iId, &audio, &result.audio);
+      hasAudio = true;
+    }
+    else
+      stream->SetDiscard(AVDISCARD_ALL);
+  }
+
+  if (!hasVideo && !hasAudio)
+  {
+    CLog::Log(LOGERROR, "CDVDPlayerBenchmark::Run - no decodable streams in %s", m_path.c_str());
+    delete demuxer;
+    delete input;
+    return false;
+  }
+
+  double start = CDVDClock::GetAbsoluteClock();
+  if (hasVideo)
+    video.Create();
+  if (hasAudio)
+    audio.Create();
+  demux.Create();
+  demux.WaitForThreadExit(0xFFFFFFFF);
+
+  /* let the decoders drain what was queued */
+  double end = CDVDClock::GetAbsoluteClock();
+  if (hasVideo)
+    FinishStage(video, result.video, end);
+  if (hasAudio)
+    FinishStage(audio, result.audio, end);
+
+  result.wallTime  = (end - start) / DVD_TIME_BASE;
+  result.mediaTime = demux.GetMediaTime();
+
+  delete demuxer;
+  delete input;
+  return true;
+}
+
+CStdString CDVDPlayerBenchmark::Format(const SDVDBenchmarkResult &result)
+{
+  double wall = std::max(result.wallTime, 0.001);
+  CStdString text;
+  text.Format("%s: %.2fs of media in %.2fs (%.2fx), %.1f fps, %u late\n"
+             , result.realtime ? "realtime" : "fast"
+             , result.mediaTime, result.wallTime, result.mediaTime / wall
+             , result.video.frames / wall, result.video.late);
+  text.AppendFormat("demux: %u packets %.2fs cpu, %.1f MB\n"
+                   , result.demux.packets, result.demux.cpuTime
+                   , result.bytes / (1024.0 * 1024.0));
+  text.AppendFormat("video: %u packets %u frames %.2fs cpu, queue avg %.0f%% max %d%%\n"
+                   , result.video.packets, result.video.frames, result.video.cpuTime
+                   , result.video.avgQueue, result.video.maxQueue);
+  text.AppendFormat("audio: %u packets %u frames %.2fs cpu, queue avg %.0f%% max %d%%"
+                   , result.audio.packets, result.audio.frames, result.audio.cpuTime
+                   , result.audio.avgQueue, result.audio.maxQueue);
+  return text;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/StdString.h"
+
+#include <stdint.h>
+
+struct SDVDBenchmarkStage
+{
+  unsigned int packets;   // demux packets handled
+  unsigned int frames;    // pictures or audio frames produced
+  unsigned int late;      // pictures that missed their time in real time mode
+  double       cpuTime;   // seconds of cpu time used by the stage thread
+  double       avgQueue;  // fill level of the stage queue in percent, sampled per packet
+  int          maxQueue;
+};
+
+struct SDVDBenchmarkResult
+{
+  bool               realtime;
+  double             wallTime;     // seconds from the first packet to the last decoded frame
+  double             mediaTime;    // seconds of media covered by the demuxed packets
+  uint64_t           bytes;        // payload bytes demuxed
+  SDVDBenchmarkStage demux;
+  SDVDBenchmarkStage video;
+  SDVDBenchmarkStage audio;
+};
+
+/**
+ * Plays a file through the demuxer and the first video and audio codecs
+ * without a renderer or an audio sink. The stages run on their own
+ * threads and talk over the same message queues DVDPlayer uses, decoded
+ * pictures and samples are dropped on the floor. With realtime set the
+ * output stages wait for each frame's timestamp like a display and a
+ * sink would, otherwise everything runs as fast as the cpu allows.
+ */
+class CDVDPlayerBenchmark
+{
+public:
+  CDVDPlayerBenchmark(const CStdString &path, bool realtime = false, double duration = 0.0);
+
+  bool Run(SDVDBenchmarkResult &result);
+
+  static CStdString Format(const SDVDBenchmarkResult &result);
+
+private:
+  CStdString m_path;
+  bool       m_realtime;
+  double     m_duration;  // seconds of media to play, 0 for all of it
+};
@@ -0,0 +1,134 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/dvdplayer/DVDDemuxers/DVDDemuxSeekIndex.h"
+#include "FileItem.h"
+
+#include "gtest/gtest.h"
+
+/* a keyframe every 2 seconds, 188 byte ts packets */
+static void FillIndex(CDVDDemuxSeekIndex &index, int from, int to)
+{
+  for (int time = from; time <= to; time += 2000)
+    index.Add(time, (int64_t)time * 188);
+}
+
+TEST(TestDVDDemuxSeekIndex, FindBackwardsAndForwards)
+{
+  CDVDDemuxSeekIndex index;
+  FillIndex(index, 0, 60000);
+
+  int     keytime;
+  int64_t keypos;
+  EXPECT_TRUE(index.Find(5000, true, keytime, keypos));
+  EXPECT_EQ(4000, keytime);
+  EXPECT_EQ(4000 * 188, keypos);
+
+  EXPECT_TRUE(index.Find(5000, false, keytime, keypos));
+  EXPECT_EQ(6000, keytime);
+
+  EXPECT_TRUE(index.Find(6000, true, keytime, keypos));
+  EXPECT_EQ(6000, keytime);
+}
+
+TEST(TestDVDDemuxSeekIndex, OnlyCoveredRanges)
+{
+  CDVDDemuxSeekIndex index;
+  FillIndex(index, 0, 10000);
+  FillIndex(index, 120000, 130000);
+
+  int     keytime;
+  int64_t keypos;
+  EXPECT_FALSE(index.Find(60000, true, keytime, keypos));
+  EXPECT_FALSE(index.Find(140000, true, keytime, keypos));
+  EXPECT_TRUE(index.Find(125000, true, keytime, keypos));
+  EXPECT_EQ(124000, keytime);
+}
+
+TEST(TestDVDDemuxSeekIndex, SkipsCloseKeyframes)
+{
+  CDVDDemuxSeekIndex index;
+  index.Add(0, 0);
+  index.Add(500, 100);
+  index.Add(2000, 200);
+  index.Add(1500, 150);
+  index.Add(1000, 120);
+  EXPECT_EQ(3u, index.Size());
+}
+
+TEST(TestDVDDemuxSeekIndex, Serialize)
+{
+  CDVDDemuxSeekIndex index;
+  FillIndex(index, 0, 20000);
+
+  std::string data;
+  index.Serialize(data, 123456);
+
+  CDVDDemuxSeekIndex loaded;
+  EXPECT_FALSE(loaded.Deserialize(data, 654321));
+  EXPECT_EQ(0u, loaded.Size());
+
+  EXPECT_TRUE(loaded.Deserialize(data, 123456));
+  EXPECT_EQ(index.Size(), loaded.Size());
+  EXPECT_FALSE(loaded.Changed());
+
+  int     keytime;
+  int64_t keypos;
+  EXPECT_TRUE(loaded.Find(9000, true, keytime, keypos));
+  EXPECT_EQ(8000, keytime);
+  EXPECT_EQ(8000 * 188, keypos);
+
+  data.resize(data.size() - 1);
+  EXPECT_FALSE(loaded.Deserialize(data, 123456));
+}
+
+/* an index file last written the given number of days before now */
+static void AddCacheFile(CFileItemList &items, const CStdString &name, const CDateTime &now, int days)
+{
+  CFileItemPtr item(new CFileItem("special://temp/seekindex/" + name, false));
+  item->m_dateTime = now - CDateTimeSpan(days, 0, 0, 0);
+  items.Add(item);
+}
+
+TEST(TestDVDDemuxSeekIndex, ExpiresOldAndExcessFiles)
+{
+  CDateTime now(2013, 6, 1, 12, 0, 0);
+  CFileItemList items;
+  AddCacheFile(items, "00000004.idx", now, 40);
+  AddCacheFile(items, "00000001.idx", now, 1);
+  AddCacheFile(items, "00000003.idx", now, 3);
+  AddCacheFile(items, "00000002.idx", now, 2);
+
+  std::vector<CStdString> expired;
+  CDVDDemuxSeekIndex::GetExpired(items, 10, now - CDateTimeSpan(30, 0, 0, 0), expired);
+  ASSERT_EQ(1u, expired.size());
+  EXPECT_STREQ("special://temp/seekindex/00000004.idx", expired[0].c_str());
+
+  /* beyond the count the least recently written go first */
+  expired.clear();
+  CDVDDemuxSeekIndex::GetExpired(items, 2, now - CDateTimeSpan(30, 0, 0, 0), expired);
+  ASSERT_EQ(2u, expired.size());
+  EXPECT_STREQ("special://temp/seekindex/00000003.idx", expired[0].c_str());
+  EXPECT_STREQ("special://temp/seekindex/00000004.idx", expired[1].c_str());
+
+  expired.clear();
+  CDVDDemuxSeekIndex::GetExpired(items, 10, now - CDateTimeSpan(60, 0, 0, 0), expired);
+  EXPECT_TRUE(expired.empty());
+}
@@ -0,0 +1,147 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "DVDPlayerBenchmark.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+static void WriteLE(XFILE::CFile *file, unsigned int value, int bytes)
+{
+  unsigned char buf[4];
+  for (int i = 0; i < bytes; i++)
+    buf[i] = (value >> (8 * i)) & 0xff;
+  file->Write(buf, bytes);
+}
+
+/* writes a short uncompressed clip the demuxer and codecs of any build can
+ * read, a yuv4mpeg picture stream or a 16 bit stereo wav */
+static XFILE::CFile *CreateClip(bool video, int seconds)
+{
+  XFILE::CFile *file = XBMC_CREATETEMPFILE(video ? ".y4m" : ".wav");
+  if (!file)
+    return NULL;
+  file->Close();
+  if (!file->OpenForWrite(XBMC_TEMPFILEPATH(file), true))
+  {
+    XBMC_DELETETEMPFILE(file);
+    return NULL;
+  }
+
+  if (video)
+  {
+    const int width = 160, height = 120, fps = 25;
+    std::vector<unsigned char> frame(width * height * 3 / 2, 128);
+    const char *header = "YUV4MPEG2 W160 H120 F25:1 Ip A1:1 C420jpeg\n";
+    file->Write(header, strlen(header));
+    for (int i = 0; i < seconds * fps; i++)
+    {
+      /* a moving ramp, so no two pictures are alike */
+      for (int y = 0; y < height; y++)
+        memset(&frame[y * width], (y + i) & 0xff, width);
+      file->Write("FRAME\n", 6);
+      file->Write(&frame[0], frame.size());
+    }
+  }
+  else
+  {
+    const unsigned int rate = 44100, channels = 2, align = channels * 2;
+    const unsigned int bytes = seconds * rate * align;
+    file->Write("RIFF", 4);
+    WriteLE(file, 36 + bytes, 4);
+    file->Write("WAVEfmt ", 8);
+    WriteLE(file, 16, 4);
+    WriteLE(file, 1, 2);  // pcm
+    WriteLE(file, channels, 2);
+    WriteLE(file, rate, 4);
+    WriteLE(file, rate * align, 4);
+    WriteLE(file, align, 2);
+    WriteLE(file, 16, 2);
+    file->Write("data", 4);
+    WriteLE(file, bytes, 4);
+
+    std::vector<short> samples(rate * channels);
+    for (unsigned int i = 0; i < samples.size(); i++)
+      samples[i] = (short)((i * 64) & 0x7fff);
+    for (int i = 0; i < seconds; i++)
+      file->Write(&samples[0], samples.size() * sizeof(short));
+  }
+
+  file->Close();
+  return file;
+}
+
+/* uncompressed clips decode in a fraction of their duration anywhere, so
+ * falling behind real time in fast mode means the pipeline stalls */
+TEST(TestDVDPlayerBenchmark, SyntheticVideo)
+{
+  XFILE::CFile *file = CreateClip(true, 2);
+  ASSERT_TRUE(file != NULL);
+
+  CDVDPlayerBenchmark benchmark(XBMC_TEMPFILEPATH(file));
+  SDVDBenchmarkResult result;
+  EXPECT_TRUE(benchmark.Run(result));
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+
+  EXPECT_EQ(50u, result.video.frames);
+  EXPECT_EQ(result.demux.packets, result.video.packets);
+  EXPECT_LT(result.wallTime, result.mediaTime);
+}
+
+TEST(TestDVDPlayerBenchmark, SyntheticAudio)
+{
+  XFILE::CFile *file = CreateClip(false, 2);
+  ASSERT_TRUE(file != NULL);
+
+  CDVDPlayerBenchmark benchmark(XBMC_TEMPFILEPATH(file));
+  SDVDBenchmarkResult result;
+  EXPECT_TRUE(benchmark.Run(result));
+  EXPECT_TRUE(XBMC_DELETETEMPFILE(file));
+
+  EXPECT_EQ(2u * 44100u, result.audio.frames);
+  EXPECT_EQ(0u, result.video.frames);
+  EXPECT_LT(result.wallTime, result.mediaTime);
+}
+
+/* not part of the unit tests, run it by hand on a file, e.g.
+ *   BENCHMARK_FILE=/media/sample.mkv BENCHMARK_REALTIME=1 BENCHMARK_DURATION=60 \
+ *     ./xbmc-test --gtest_also_run_disabled_tests --gtest_filter=TestDVDPlayerBenchmark.* */
+TEST(TestDVDPlayerBenchmark, DISABLED_Playback)
+{
+  const char *file = getenv("BENCHMARK_FILE");
+  ASSERT_TRUE(file != NULL) << "BENCHMARK_FILE not set";
+
+  const char *realtime = getenv("BENCHMARK_REALTIME");
+  const char *duration = getenv("BENCHMARK_DURATION");
+
+  CDVDPlayerBenchmark benchmark(file, realtime && atoi(realtime) != 0, duration ? atof(duration) : 0.0);
+  SDVDBenchmarkResult result;
+  ASSERT_TRUE(benchmark.Run(result));
+  std::cout << CDVDPlayerBenchmark::Format(result) << std::endl;
+
+  EXPECT_GT(result.demux.packets, 0u);
+  EXPECT_GT(result.video.frames + result.audio.frames, 0u);
+}
@@ -56,7 +56,7 @@ public:
   CAudioDecoder();
   ~CAudioDecoder();
 
-  bool Create(const CFileItem &file, int64_t seekOffset);
+  bool Create(const CFileItem &file, int64_t seekOffset, unsigned int bufferSeconds = 2);
   void Destroy();
 
   int ReadSamples(int numsamples);
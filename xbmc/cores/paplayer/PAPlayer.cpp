@@ -29,11 +29,15 @@
 #include "utils/log.h"
 #include "utils/MathUtils.h"
 
+#include "threads/Event.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "cores/AudioEngine/AEFactory.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/Interfaces/AEStream.h"
 
+#include <algorithm>
+
 #define TIME_TO_CACHE_NEXT_FILE 5000 /* 5 seconds before end of song, start caching the next song */
 #define FAST_XFADE_TIME           80 /* 80 milliseconds */
 #define MAX_SKIP_XFADE_TIME     2000 /* max 2 seconds crossfade on track skip */
@@ -43,6 +47,96 @@ CAEChannelInfo ICodec::GetChannelInfo()
   return CAEUtil::GuessChLayout(m_Channels);
 }
 
+/* opens the next file and decodes its first seconds while the current one plays,
+ * so a slow source has the whole preroll time to get going */
+class PAPlayer::CPreroll : public CThread
+{
+public:
+  CPreroll(const CFileItem &file, unsigned int bufferSeconds) :
+    CThread         ("PAPlayerPreroll"),
+    m_file          (file),
+    m_bufferSeconds (bufferSeconds),
+    m_si            (NULL),
+    m_ready         (true)
+  {
+  }
+
+  virtual ~CPreroll()
+  {
+    StopThread();
+    if (m_si)
+    {
+      m_si->m_decoder.Destroy();
+      delete m_si;
+    }
+  }
+
+  const CFileItem& GetFile() const { return m_file; }
+
+  /* true once the thread is done, successful or not */
+  bool IsReady() { return m_ready.WaitMSec(0); }
+
+  /* takes the opened stream, NULL if opening failed, only once IsReady() */
+  StreamInfo* Detach()
+  {
+    StreamInfo* si = m_si;
+    m_si = NULL;
+    return si;
+  }
+
+protected:
+  virtual void Process()
+  {
+    StreamInfo *si = new StreamInfo();
+
+    if (!si->m_decoder.Create(m_file, (m_file.m_lStartOffset * 1000) / 75, m_bufferSeconds))
+    {
+      CLog::Log(LOGWARNING, "PAPlayer::CPreroll - Failed to create the decoder for %s", m_file.GetPath().c_str());
+      delete si;
+      m_ready.Set();
+      return;
+    }
+
+    /* decode until the buffer is full or a short file has ended */
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    while(!m_bStop && si->m_decoder.GetStatus() == STATUS_QUEUING)
+    {
+      int ret = si->m_decoder.ReadSamples(PACKET_SIZE);
+      if (ret == RET_ERROR)
+      {
+        CLog::Log(LOGINFO, "PAPlayer::CPreroll - Error reading samples from %s", m_file.GetPath().c_str());
+        si->m_decoder.Destroy();
+        delete si;
+        m_ready.Set();
+        return;
+      }
+
+      /* waiting on the source */
+      if (ret == RET_SLEEP)
+        Sleep(10);
+    }
+
+    if (m_bStop)
+    {
+      si->m_decoder.Destroy();
+      delete si;
+      return;
+    }
+
+    CLog::Log(LOGDEBUG, "PAPlayer::CPreroll - %s ready after %u ms", m_file.GetPath().c_str(), XbmcThreads::SystemClockMillis() - start);
+
+    si->m_decoder.Start();
+    m_si = si;
+    m_ready.Set();
+  }
+
+private:
+  CFileItem     m_file;
+  unsigned int  m_bufferSeconds;
+  StreamInfo*   m_si;
+  CEvent        m_ready; /* hands m_si over to the player thread */
+};
+
 // PAP: Psycho-acoustic Audio Player
 // Supporting all open  audio codec standards.
 // First one being nullsoft's nsv audio decoder format
@@ -60,6 +154,9 @@ PAPlayer::PAPlayer(IPlayerCallback& callback) :
   m_currentStream      (NULL ),
   m_audioCallback      (NULL ),
   m_FileItem           (new CFileItem()),
+  m_queuedStream       (NULL ),
+  m_preroll            (NULL ),
+  m_prerollMS          (0    ),
   m_userRequestedVolume(-1),
 /* PLEX */
   m_hardCrossFade(0)
@@ -76,6 +173,10 @@ PAPlayer::~PAPlayer()
 
   /* wait for the thread to terminate */
   StopThread(true);//true - wait for end of thread
+
+  CSingleLock lock(m_prerollSection);
+  CancelPreroll();
+  ReapPrerolls(true);
   delete m_FileItem;
 }
 
@@ -228,18 +329,28 @@ void PAPlayer::CloseAllStreams(bool fade/* = true */)
       delete si;
     }
     m_currentStream = NULL;
+    m_queuedStream  = NULL;
   }
   else
   {
     SoftStop(false, true);
     CExclusiveLock lock(m_streamsLock);
     m_currentStream = NULL;
+    m_queuedStream  = NULL;
   }  
 }
 
 bool PAPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options)
 {
   m_defaultCrossfadeMS = g_guiSettings.GetInt("musicplayer.crossfade") * 1000;
+  m_prerollMS          = g_advancedSettings.m_audioPrerollTime * 1000;
+
+  /* whatever was opened ahead is not what will play next */
+  {
+    CSingleLock lock(m_prerollSection);
+    CancelPreroll();
+  }
+  m_isFinished = false;
 
   if (m_streams.size() > 1 || !m_defaultCrossfadeMS || m_isPaused)
   {
@@ -309,7 +420,106 @@ void PAPlayer::UpdateCrossfadeTime(const CFileItem& file)
 
 bool PAPlayer::QueueNextFile(const CFileItem &file)
 {
-  return QueueNextFileEx(file);
+  CSingleLock lock(m_prerollSection);
+
+  /* the play queue changed, replace what was queued before */
+  CancelPreroll();
+  DropQueuedStream();
+
+  if (!m_prerollMS)
+  {
+    lock.Leave();
+    return QueueNextFileEx(file);
+  }
+
+  /* open it in the background, it is added to the streams once its transition is near.
+   * Decoding goes on from there, so the buffer only has to hold the crossfade */
+  m_preroll = new CPreroll(file, (m_defaultCrossfadeMS + 999) / 1000);
+  m_preroll->Create();
+  return true;
+}
+
+void PAPlayer::DropQueuedStream()
+{
+  CExclusiveLock lock(m_streamsLock);
+  StreamInfo* si = m_queuedStream;
+  m_queuedStream = NULL;
+
+  StreamList::iterator itt = std::find(m_streams.begin(), m_streams.end(), si);
+  if (itt == m_streams.end())
+    return;
+
+  /* too late once the transition to it has begun */
+  if (si->m_started || !m_currentStream || m_currentStream == si || m_currentStream->m_playNextTriggered)
+    return;
+
+  m_streams.erase(itt);
+  if (si->m_isSlaved)
+    m_currentStream->m_stream->RegisterSlave(NULL);
+
+  si->m_decoder.Destroy();
+  if (si->m_stream)
+    CAEFactory::FreeStream(si->m_stream);
+  delete si;
+
+  CLog::Log(LOGDEBUG, "PAPlayer::DropQueuedStream - Queued stream replaced");
+}
+
+void PAPlayer::CancelPreroll()
+{
+  if (!m_preroll)
+    return;
+
+  /* don't wait here for a source that is slow to open, the player thread reaps it */
+  m_preroll->StopThread(false);
+  m_cancelledPrerolls.push_back(m_preroll);
+  m_preroll = NULL;
+}
+
+void PAPlayer::ReapPrerolls(bool wait)
+{
+  for (PrerollList::iterator itt = m_cancelledPrerolls.begin(); itt != m_cancelledPrerolls.end();)
+  {
+    if (wait || !(*itt)->IsRunning())
+    {
+      delete *itt;
+      itt = m_cancelledPrerolls.erase(itt);
+    }
+    else
+      ++itt;
+  }
+}
+
+bool PAPlayer::IsPrerollDue()
+{
+  CSharedLock lock(m_streamsLock);
+  if (!m_currentStream)
+    return m_streams.empty();
+
+  return m_currentStream->m_started && m_currentStream->m_framesSent >= m_currentStream->m_promoteNextAtFrame;
+}
+
+void PAPlayer::PromotePreroll()
+{
+  CSingleLock lock(m_prerollSection);
+  ReapPrerolls(false);
+
+  if (!m_preroll || !m_preroll->IsReady() || !IsPrerollDue())
+    return;
+
+  CPreroll* preroll = m_preroll;
+  m_preroll = NULL;
+
+  StreamInfo* si = preroll->Detach();
+  if (!si || !AddStream(si, preroll->GetFile(), true))
+  {
+    /* the item can't be skipped from here, finish the current one and let
+     * the application open it, which moves the play queue past it */
+    CLog::Log(LOGWARNING, "PAPlayer::PromotePreroll - Unable to play %s", preroll->GetFile().GetPath().c_str());
+    m_isFinished = true;
+  }
+
+  delete preroll;
 }
 
 bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
@@ -346,6 +556,17 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
     CThread::Sleep(1);
   }
 
+  if (!AddStream(si, file, fadeIn))
+  {
+    m_callback.OnQueueNextItem();
+    return false;
+  }
+
+  return true;
+}
+
+bool PAPlayer::AddStream(StreamInfo *si, const CFileItem &file, bool fadeIn)
+{
   UpdateCrossfadeTime(file);
 
   /* init the streaminfo struct */
@@ -371,8 +592,17 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
     streamTotalTime = si->m_endOffset - si->m_startOffset;
   
   si->m_prepareNextAtFrame = 0;
+  si->m_promoteNextAtFrame = 0;
   if (streamTotalTime >= TIME_TO_CACHE_NEXT_FILE + m_defaultCrossfadeMS)
-    si->m_prepareNextAtFrame = (int)((streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS) * si->m_sampleRate / 1000.0f);
+  {
+    int64_t promoteAt = streamTotalTime - TIME_TO_CACHE_NEXT_FILE - m_defaultCrossfadeMS;
+    si->m_promoteNextAtFrame = (int)(promoteAt * si->m_sampleRate / 1000.0f);
+    si->m_prepareNextAtFrame = si->m_promoteNextAtFrame;
+
+    /* ask for the next file early enough for its preroll to fill before it is needed */
+    if (m_prerollMS)
+      si->m_prepareNextAtFrame = std::max(1, (int)((promoteAt - (int64_t)m_prerollMS) * si->m_sampleRate / 1000.0f));
+  }
 
   si->m_prepareTriggered = false;
 
@@ -381,17 +611,18 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */)
 
   if (!PrepareStream(si))
   {
-    CLog::Log(LOGINFO, "PAPlayer::QueueNextFileEx - Error preparing stream");
+    CLog::Log(LOGINFO, "PAPlayer::AddStream - Error preparing stream");
     
     si->m_decoder.Destroy();
     delete si;
-    m_callback.OnQueueNextItem();
     return false;
   }
 
   /* add the stream to the list */
   CExclusiveLock lock(m_streamsLock);
   m_streams.push_back(si);
+  /* a file queued behind the playing one can be replaced until it starts */
+  m_queuedStream = fadeIn ? si : NULL;
   //update the current stream to start playing the next track at the correct frame.
   UpdateStreamInfoPlayNextAtFrame(m_currentStream, m_upcomingCrossfadeMS);
 
@@ -487,6 +718,9 @@ void PAPlayer::Process()
   CLog::Log(LOGDEBUG, "PAPlayer::Process - Playback started");  
   while(m_isPlaying && !m_bStop)
   {
+    /* hand a prerolled next file over once its transition is near */
+    PromotePreroll();
+
     /* this needs to happen outside of any locks to prevent deadlocks */
     if (m_signalSpeedChange)
     {
@@ -565,6 +799,8 @@ inline void PAPlayer::ProcessStreams(double &delay, double &buffer)
 
       /* remove the stream */
       itt = m_streams.erase(itt);
+      if (si == m_queuedStream)
+        m_queuedStream = NULL;
       /* if its the current stream */
       if (si == m_currentStream)
       {
@@ -638,6 +874,8 @@ inline bool PAPlayer::ProcessStream(StreamInfo *si, double &delay, double &buffe
   if (si == m_currentStream && !si->m_started)
   {
     si->m_started = true;
+    if (si == m_queuedStream)
+      m_queuedStream = NULL;
     si->m_stream->RegisterAudioCallback(m_audioCallback);
     if (!si->m_isSlaved)
       si->m_stream->Resume();
@@ -757,6 +995,11 @@ void PAPlayer::UnRegisterAudioCallback()
 
 void PAPlayer::OnNothingToQueueNotify()
 {
+  {
+    CSingleLock lock(m_prerollSection);
+    CancelPreroll();
+    DropQueuedStream();
+  }
   m_isFinished = true;
 }
 
@@ -26,6 +26,7 @@
 #include "threads/Thread.h"
 #include "AudioDecoder.h"
 #include "threads/SharedSection.h"
+#include "threads/CriticalSection.h"
 
 #include "cores/IAudioCallback.h"
 #include "cores/AudioEngine/Utils/AEChannelInfo.h"
@@ -112,6 +113,7 @@ private:
     bool              m_finishing;           /* if this stream is finishing */
     int               m_framesSent;          /* number of frames sent to the stream */
     int               m_prepareNextAtFrame;  /* when to prepare the next stream */
+    int               m_promoteNextAtFrame;  /* when to hand a prerolled next stream to the engine */
     bool              m_prepareTriggered;    /* if the next stream has been prepared */
     int               m_playNextAtFrame;     /* when to start playing the next stream */
     bool              m_playNextTriggered;   /* if this stream has started the next one */
@@ -127,6 +129,9 @@ private:
 
   typedef std::list<StreamInfo*> StreamList;
 
+  class CPreroll;
+  typedef std::list<CPreroll*> PrerollList;
+
   bool                m_signalSpeedChange;   /* true if OnPlaybackSpeedChange needs to be called */
   int                 m_playbackSpeed;       /* the playback speed (1 = normal) */
   bool                m_isPlaying;
@@ -143,8 +148,20 @@ private:
   CSharedSection      m_streamsLock;         /* lock for the stream list */
   StreamList          m_streams;             /* playing streams */  
   StreamList          m_finishing;           /* finishing streams */
+  StreamInfo*         m_queuedStream;        /* queued stream that can still be replaced */
+
+  CCriticalSection    m_prerollSection;      /* lock for the preroll state */
+  CPreroll*           m_preroll;             /* next file being opened ahead of its transition */
+  PrerollList         m_cancelledPrerolls;   /* cancelled prerolls still winding down */
+  unsigned int        m_prerollMS;           /* how much of the next file to decode ahead in ms */
 
   bool QueueNextFileEx(const CFileItem &file, bool fadeIn = true);
+  bool AddStream(StreamInfo *si, const CFileItem &file, bool fadeIn);
+  void DropQueuedStream();
+  void CancelPreroll();
+  void ReapPrerolls(bool wait);
+  bool IsPrerollDue();
+  void PromotePreroll();
   void SoftStart(bool wait = false);
   void SoftStop(bool wait = false, bool close = true);
   void CloseAllStreams(bool fade = true);
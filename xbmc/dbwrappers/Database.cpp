@@ -31,6 +31,7 @@
 #include "sqlitedataset.h"
 #include "DatabaseManager.h"
 #include "DbUrl.h"
+#include "threads/SystemClock.h"
 
 #ifdef HAS_MYSQL
 #include "mysqldataset.h"
@@ -105,6 +106,15 @@ CDatabase::CDatabase(void)
   m_openCount = 0;
   m_sqlite = true;
   m_bMultiWrite = false;
+  m_batch = false;
+  m_batchOpen = false;
+  m_batchDepth = 0;
+  m_batchItems = 0;
+  m_batchTotal = 0;
+  m_batchCommits = 0;
+  m_batchStart = 0;
+  m_batchOpened = 0;
+  m_batchCommitTime = 0;
 }
 
 CDatabase::~CDatabase(void)
@@ -433,6 +443,23 @@ bool CDatabase::Update(const DatabaseSettings &settings)
 
 bool CDatabase::Connect(const CStdString &dbName, const DatabaseSettings &dbSettings, bool create)
 {
+  std::string poolKey = dbSettings.type + "|" + dbSettings.host + "|" + dbSettings.port + "|" + dbSettings.user + "|" + dbName;
+
+  // reuse an idle connection, it's already set up
+  if (!create)
+  {
+    dbiplus::Database *db = CDatabaseManager::Get().AcquireConnection(poolKey);
+    if (db)
+    {
+      m_pDB.reset(db);
+      m_pDS.reset(m_pDB->CreateDataset());
+      m_pDS2.reset(m_pDB->CreateDataset());
+      m_poolKey = poolKey;
+      m_openCount = 1;
+      return true;
+    }
+  }
+
   // create the appropriate database structure
   if (dbSettings.type.Equals("sqlite3"))
   {
@@ -498,6 +525,22 @@ bool CDatabase::Connect(const CStdString &dbName, const DatabaseSettings &dbSett
       m_pDS->exec("PRAGMA cache_size=4096\n");
       m_pDS->exec("PRAGMA synchronous='NORMAL'\n");
       m_pDS->exec("PRAGMA count_changes='OFF'\n");
+
+      // wal lets readers carry on while a scanner is writing, and syncs less
+      CStdString journalMode = dbSettings.journalmode;
+      journalMode.ToLower();
+      if (journalMode.Equals("wal") || journalMode.Equals("delete") || journalMode.Equals("truncate") || journalMode.Equals("persist"))
+        m_pDS->exec(PrepareSQL("PRAGMA journal_mode=%s\n", journalMode.c_str()));
+      else if (!journalMode.IsEmpty())
+        CLog::Log(LOGWARNING, "%s - ignoring unknown journal mode %s", __FUNCTION__, journalMode.c_str());
+
+      // readers don't block a writer in wal mode, so writers can queue on a
+      // lock rather than poll for the file
+      // (query() only runs selects, so read the pragma back from exec)
+      m_pDS->exec("PRAGMA journal_mode\n");
+      const dbiplus::result_set *res = (const dbiplus::result_set *)m_pDS->getExecRes();
+      CStdString mode = res->records.empty() ? "" : res->records[0]->at(0).get_asString();
+      m_pDB->serialize_writes(mode.Equals("wal"));
     }
   }
   catch (DbErrors &error)
@@ -508,6 +551,8 @@ bool CDatabase::Connect(const CStdString &dbName, const DatabaseSettings &dbSett
     return false;
   }
 
+  CDatabaseManager::Get().ConnectionOpened(poolKey);
+  m_poolKey = poolKey;
   m_openCount = 1; // our database is open
   return true;
 }
@@ -577,11 +622,24 @@ void CDatabase::Close()
   m_openCount = 0;
 
   if (NULL == m_pDB.get() ) return ;
+  EndBatch();
   if (NULL != m_pDS.get()) m_pDS->close();
-  m_pDB->disconnect();
-  m_pDB.reset();
   m_pDS.reset();
   m_pDS2.reset();
+
+  // the next user of the database can have the connection, unless it's been
+  // left in a transaction
+  if (!m_poolKey.empty())
+  {
+    CDatabaseManager::Get().ReleaseConnection(m_poolKey, m_pDB->in_transaction() ? NULL : m_pDB.release());
+    m_poolKey.clear();
+  }
+
+  if (NULL != m_pDB.get())
+  {
+    m_pDB->disconnect();
+    m_pDB.reset();
+  }
 }
 
 bool CDatabase::Compress(bool bForce /* =true */)
@@ -629,7 +687,23 @@ void CDatabase::BeginTransaction()
 {
   try
   {
-    if (NULL != m_pDB.get())
+    if (NULL == m_pDB.get())
+      return;
+
+    if (m_batch)
+    {
+      // the batch transaction is only opened by a write, so the write lock
+      // isn't held while the caller works on the next item
+      if (!m_batchOpen)
+      {
+        m_pDB->start_transaction();
+        m_batchOpen = true;
+        m_batchOpened = XbmcThreads::SystemClockMillis();
+      }
+      m_pDB->start_savepoint();
+      m_batchDepth++;
+    }
+    else
       m_pDB->start_transaction();
   }
   catch (...)
@@ -642,7 +716,19 @@ bool CDatabase::CommitTransaction()
 {
   try
   {
-    if (NULL != m_pDB.get())
+    if (NULL == m_pDB.get())
+      return true;
+
+    // inside a batch the writes are committed with it
+    if (m_batch)
+    {
+      if (m_batchDepth > 0)
+      {
+        m_pDB->release_savepoint();
+        m_batchDepth--;
+      }
+    }
+    else
       m_pDB->commit_transaction();
   }
   catch (...)
@@ -657,7 +743,18 @@ void CDatabase::RollbackTransaction()
 {
   try
   {
-    if (NULL != m_pDB.get())
+    if (NULL == m_pDB.get())
+      return;
+
+    if (m_batch)
+    {
+      if (m_batchDepth > 0)
+      {
+        m_pDB->rollback_savepoint();
+        m_batchDepth--;
+      }
+    }
+    else
       m_pDB->rollback_transaction();
   }
   catch (...)
@@ -668,10 +765,100 @@ void CDatabase::RollbackTransaction()
 
 bool CDatabase::InTransaction()
 {
-  if (NULL != m_pDB.get()) return false;
+  if (NULL == m_pDB.get()) return false;
   return m_pDB->in_transaction();
 }
 
+void CDatabase::BeginBatch()
+{
+  // mysql runs with autocommit and has no savepoints here, a rollback inside
+  // a batch would undo nothing, so it keeps committing per transaction
+  if (m_batch || NULL == m_pDB.get() || !m_sqlite || g_advancedSettings.m_databaseBatchItems <= 1)
+    return;
+
+  m_batch = true;
+  m_batchOpen = false;
+  m_batchDepth = 0;
+  m_batchItems = 0;
+  m_batchTotal = 0;
+  m_batchCommits = 0;
+  m_batchCommitTime = 0;
+  m_batchStart = XbmcThreads::SystemClockMillis();
+  m_batchOpened = m_batchStart;
+}
+
+bool CDatabase::BatchItemDone(unsigned int items /* = 1 */)
+{
+  if (!m_batch)
+    return false;
+
+  m_batchItems += items;
+  if (!m_batchOpen)
+    return false;
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  if (m_batchItems < (unsigned int)g_advancedSettings.m_databaseBatchItems &&
+      now - m_batchOpened < (unsigned int)g_advancedSettings.m_databaseBatchTime)
+    return false;
+
+  // a begin without its commit, the batch commit ends it as well
+  if (m_batchDepth > 0)
+    CLog::Log(LOGWARNING, "%s - %u transactions left open, committing them with the batch", __FUNCTION__, m_batchDepth);
+  m_batchDepth = 0;
+
+  return CommitBatch();
+}
+
+bool CDatabase::FlushBatch()
+{
+  // nothing written yet, or the caller is in the middle of a write
+  if (!m_batch || !m_batchOpen || m_batchDepth > 0)
+    return false;
+
+  return CommitBatch();
+}
+
+bool CDatabase::CommitBatch()
+{
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  m_batchOpen = false;
+  try
+  {
+    m_pDB->commit_transaction();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to commit %u items", __FUNCTION__, m_batchItems);
+    return false;
+  }
+
+  m_batchCommitTime += XbmcThreads::SystemClockMillis() - now;
+  m_batchCommits++;
+  m_batchTotal += m_batchItems;
+  m_batchItems = 0;
+  return true;
+}
+
+bool CDatabase::EndBatch()
+{
+  if (!m_batch)
+    return true;
+
+  m_batch = false;
+  m_batchDepth = 0;
+
+  bool ret = true;
+  if (m_batchOpen)
+    ret = CommitBatch();
+  else
+    m_batchTotal += m_batchItems;
+  m_batchItems = 0;
+
+  CLog::Log(LOGNOTICE, "%s - %s: wrote %u items in %u transactions, took %u ms of which %u ms committing",
+            __FUNCTION__, GetBaseDBName(), m_batchTotal, m_batchCommits, XbmcThreads::SystemClockMillis() - m_batchStart, m_batchCommitTime);
+  return ret;
+}
+
 bool CDatabase::CreateTables()
 {
 
@@ -71,6 +71,39 @@ public:
   void RollbackTransaction();
   bool InTransaction();
 
+  /*!
+   * @brief Group the writes that follow into transactions of several items
+   * each, until EndBatch(). Used by the library scanners so that a scan
+   * doesn't commit, and sync to disk, once per item.
+   * @remarks Transactions begun while a batch is open become savepoints in
+   * it, so a rollback only undoes the writes since the matching begin. The
+   * batch transaction itself is begun by the first of them, not here.
+   * Only sqlite databases batch, for others this does nothing.
+   */
+  void BeginBatch();
+
+  /*!
+   * @brief Count items as written, committing the batch when it holds enough
+   * items or has been open for too long.
+   * @param items The number of items written since the last call.
+   * @return True if the batch was committed.
+   */
+  bool BatchItemDone(unsigned int items = 1);
+
+  /*!
+   * @brief Commit the open batch transaction early, so other connections can
+   * write while the caller does something slow, e.g. a network lookup.
+   * @return True if there was a transaction to commit and it was committed.
+   */
+  bool FlushBatch();
+
+  /*!
+   * @brief Commit what is left of the batch and log the time spent writing.
+   * @return True if the final commit succeeded.
+   */
+  bool EndBatch();
+  bool InBatch() const { return m_batch; }
+
   static CStdString FormatSQL(CStdString strStmt, ...);
   CStdString PrepareSQL(CStdString strStmt, ...) const;
 
@@ -168,9 +201,21 @@ protected:
 
 private:
   void InitSettings(DatabaseSettings &dbSettings);
+  bool CommitBatch();
   bool Connect(const CStdString &dbName, const DatabaseSettings &db, bool create);
   bool UpdateVersionNumber();
 
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
   unsigned int m_openCount;
+  std::string m_poolKey; /*!< key of the connection in the CDatabaseManager pool, empty if it isn't pooled */
+
+  bool m_batch;                   /*!< True while writes are grouped by BeginBatch() */
+  bool m_batchOpen;               /*!< True while the batch transaction is begun */
+  unsigned int m_batchDepth;      /*!< savepoints open in the batch transaction */
+  unsigned int m_batchItems;      /*!< items written in the open batch transaction */
+  unsigned int m_batchTotal;      /*!< items written since BeginBatch() */
+  unsigned int m_batchCommits;
+  unsigned int m_batchStart;      /*!< when BeginBatch() was called */
+  unsigned int m_batchOpened;     /*!< when the open batch transaction began */
+  unsigned int m_batchCommitTime; /*!< ms spent committing since BeginBatch() */
 };
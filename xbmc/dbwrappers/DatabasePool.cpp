@@ -0,0 +1,131 @@
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DatabasePool.h"
+#include "dataset.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+CDatabasePool::CDatabasePool(unsigned int maxIdle, unsigned int maxIdleTime)
+{
+  m_maxIdle     = maxIdle;
+  m_maxIdleTime = maxIdleTime;
+  memset(&m_stats, 0, sizeof(m_stats));
+}
+
+CDatabasePool::~CDatabasePool()
+{
+  Clear();
+}
+
+dbiplus::Database *CDatabasePool::Acquire(const std::string &key)
+{
+  vector<dbiplus::Database*> expired;
+  dbiplus::Database *db = NULL;
+  {
+    CSingleLock lock(m_section);
+    map<string, IdleConnections>::iterator it = m_pool.find(key);
+    if (it == m_pool.end())
+      return NULL;
+
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    IdleConnections &idle = it->second;
+    while (!idle.empty() && now - idle.front().since > m_maxIdleTime)
+    {
+      expired.push_back(idle.front().db);
+      idle.pop_front();
+    }
+
+    if (!idle.empty())
+    {
+      db = idle.back().db;
+      idle.pop_back();
+
+      m_stats.reused++;
+      m_stats.idle--;
+      if (++m_stats.inUse > m_stats.peakInUse)
+        m_stats.peakInUse = m_stats.inUse;
+    }
+    m_stats.idle -= expired.size();
+  }
+
+  // closing a connection may wait on the disk, do it outside of the lock
+  for (vector<dbiplus::Database*>::iterator it = expired.begin(); it != expired.end(); ++it)
+    delete *it;
+
+  return db;
+}
+
+void CDatabasePool::Opened(const std::string &key)
+{
+  CSingleLock lock(m_section);
+  m_stats.opened++;
+  if (++m_stats.inUse > m_stats.peakInUse)
+    m_stats.peakInUse = m_stats.inUse;
+}
+
+void CDatabasePool::Release(const std::string &key, dbiplus::Database *db)
+{
+  {
+    CSingleLock lock(m_section);
+    m_stats.inUse--;
+    if (!db)
+      return;
+
+    IdleConnections &idle = m_pool[key];
+    if (idle.size() < m_maxIdle)
+    {
+      IdleConnection connection;
+      connection.db    = db;
+      connection.since = XbmcThreads::SystemClockMillis();
+      idle.push_back(connection);
+      m_stats.idle++;
+      return;
+    }
+  }
+  delete db;
+}
+
+CDatabasePool::Stats CDatabasePool::GetStats()
+{
+  CSingleLock lock(m_section);
+  return m_stats;
+}
+
+void CDatabasePool::Clear()
+{
+  map<string, IdleConnections> pool;
+  {
+    CSingleLock lock(m_section);
+    pool.swap(m_pool);
+    m_stats.idle = 0;
+  }
+
+  for (map<string, IdleConnections>::iterator it = pool.begin(); it != pool.end(); ++it)
+  {
+    for (IdleConnections::iterator i = it->second.begin(); i != it->second.end(); ++i)
+      delete i->db;
+  }
+}
@@ -0,0 +1,94 @@
+#pragma once
+/*
+ *      Copyright (C) 2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <deque>
+#include <map>
+#include <string>
+#include "threads/CriticalSection.h"
+
+namespace dbiplus { class Database; }
+
+/*!
+ \ingroup database
+ \brief Idle database connections, kept by the database and the settings they
+ were opened with, so the many short lived CDatabase objects used by the GUI
+ and background jobs reuse a connection, with its prepared statements and page
+ cache, rather than opening one each time.
+ */
+class CDatabasePool
+{
+public:
+  /*!
+   \param maxIdle idle connections kept per database, more are disconnected.
+   \param maxIdleTime ms after which an idle connection is closed rather than reused.
+   */
+  CDatabasePool(unsigned int maxIdle, unsigned int maxIdleTime);
+  ~CDatabasePool();
+
+  /*! \brief Take an idle connection from the pool.
+   \param key identifies the database and the settings it's opened with.
+   \return a connected database, or NULL if there is no idle connection to it.
+   */
+  dbiplus::Database *Acquire(const std::string &key);
+
+  /*! \brief Count a newly opened connection as in use.
+   \param key identifies the database and the settings it's opened with.
+   */
+  void Opened(const std::string &key);
+
+  /*! \brief Hand a connection back once its user is done with it.
+   Connections beyond what the pool keeps idle are disconnected.
+   \param key identifies the database and the settings it's opened with.
+   \param db the connection, NULL if the user closed it instead.
+   */
+  void Release(const std::string &key, dbiplus::Database *db);
+
+  /*! \brief Disconnect all idle connections.
+   */
+  void Clear();
+
+  struct Stats
+  {
+    unsigned int opened;    ///< connections opened
+    unsigned int reused;    ///< opens served from the pool
+    unsigned int inUse;     ///< connections in use now
+    unsigned int peakInUse; ///< most connections in use at once
+    unsigned int idle;      ///< connections in the pool now
+  };
+  Stats GetStats();
+
+private:
+  CDatabasePool(const CDatabasePool&);
+  CDatabasePool const& operator=(CDatabasePool const&);
+
+  struct IdleConnection
+  {
+    dbiplus::Database *db;
+    unsigned int       since; ///< when it was handed back
+  };
+  typedef std::deque<IdleConnection> IdleConnections;
+
+  unsigned int                m_maxIdle;
+  unsigned int                m_maxIdleTime;
+  CCriticalSection            m_section;     ///< Critical section protecting m_pool and m_stats.
+  std::map<std::string, IdleConnections> m_pool; ///< Idle connections by database, most recently used last.
+  Stats                       m_stats;
+};
@@ -75,6 +75,42 @@ string Database::prepare(const char *format, ...)
   return result;
 }
 
+string Database::bind(const string &sql, const SqlParams &params)
+{
+  string result;
+  result.reserve(sql.size() + params.size() * 16);
+
+  unsigned int index = 0;
+  char quote = 0;
+  for (unsigned int i = 0; i < sql.size(); i++)
+  {
+    char c = sql[i];
+    if (quote)
+    {
+      if (c == quote)
+        quote = 0;
+    }
+    else if (c == '\'' || c == '"')
+      quote = c;
+    else if (c == '?' && index < params.size())
+    {
+      const field_value &value = params[index++];
+      if (value.get_isNull())
+        result += "NULL";
+      else if (value.get_fType() == ft_String)
+        result += prepare("'%s'", value.get_asString().c_str());
+      else if (value.get_fType() == ft_Boolean)
+        result += value.get_asBool() ? "1" : "0";
+      else
+        result += value.get_asString();
+      continue;
+    }
+    result += c;
+  }
+
+  return result;
+}
+
 //************* Dataset implementation ***************
 
 Dataset::Dataset() {
@@ -209,6 +245,21 @@ bool Dataset::seek(int pos) {
 }
 
 
+bool Dataset::query(const string &sql, const SqlParams &params) {
+  return query(db->bind(sql, params).c_str());
+}
+
+
+int Dataset::exec(const string &sql, const SqlParams &params) {
+  return exec(db->bind(sql, params));
+}
+
+
+bool Dataset::query_stream(const string &sql) {
+  return query(sql.c_str());
+}
+
+
 void Dataset::refresh() {
   int row = frecno;
   if ((row != 0) && active) {
@@ -43,6 +43,9 @@
 namespace dbiplus {
 class Dataset;		// forward declaration of class Dataset
 
+/* values for the ? placeholders of a statement, in order */
+typedef std::vector<field_value> SqlParams;
+
 
 #define S_NO_CONNECTION "No active connection";
 
@@ -135,6 +138,17 @@ public:
   virtual void commit_transaction() {};
   virtual void rollback_transaction() {};
 
+/* writers to a database whose readers don't block them (sqlite in wal mode)
+   queue on a lock shared by the connections to it in this process instead of
+   polling the file lock. Backends that lock their own writers ignore this */
+  virtual void serialize_writes(bool serialize) {};
+
+/* savepoints nest within a transaction so part of it can be undone, backends
+   without them ignore these and nested writes become part of the transaction */
+  virtual void start_savepoint() {};
+  virtual void release_savepoint() {};
+  virtual void rollback_savepoint() {};
+
 /* virtual methods for formatting */
 
   /*! \brief Prepare a SQL statement for execution or querying using C printf nomenclature.
@@ -151,6 +165,14 @@ public:
    */
   virtual std::string vprepare(const char *format, va_list args) = 0;
 
+  /*! \brief Fill the ? placeholders of a SQL statement with escaped values, for
+   backends that can't bind parameters themselves.
+   \param sql - statement with ? placeholders outside of quoted literals
+   \param params - values for the placeholders in order
+   \return statement with the values substituted.
+   */
+  virtual std::string bind(const std::string &sql, const SqlParams &params);
+
   virtual bool in_transaction() {return false;};
 
 };
@@ -296,6 +318,16 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exept Sql */
   virtual bool query(const char *sql) = 0;
+/* as query and exec, with the ? placeholders in sql bound to params. Backends
+   with prepared statements keep them per connection, so sql should be
+   constant and only the params vary between calls */
+  virtual bool query(const std::string &sql, const SqlParams &params);
+  virtual int  exec(const std::string &sql, const SqlParams &params);
+/* as query, but forward only: rows are read one at a time as next() is
+   called and only the current one is held. num_rows() only tells whether
+   there is a current row, seek() and prev() don't move. Backends without
+   cursors read the whole result like query */
+  virtual bool query_stream(const std::string &sql);
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
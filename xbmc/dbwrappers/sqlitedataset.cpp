@@ -33,6 +33,10 @@
 #include "utils/log.h"
 #include "system.h" // for Sleep(), OutputDebugString() and GetLastError()
 #include "utils/URIUtils.h"
+#include "threads/CriticalSection.h"
+#include "threads/Condition.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
 
 #ifdef _WIN32
 #pragma comment(lib, "sqlite3.lib")
@@ -40,7 +44,73 @@
 
 using namespace std;
 
+/* distinct parameterised queries kept prepared per connection */
+#define MAX_CACHED_STATEMENTS 128
+
+/* 100ms each, how long to wait on a database locked by another process
+   before failing the statement */
+#define MAX_BUSY_RETRIES 300
+
 namespace dbiplus {
+
+/* Queues the writers to one database file in the order they came, a
+   transaction holds it until it ends. Unlike a CCriticalSection it may be
+   released from another thread, as a connection may be closed on one, and
+   the thread holding it takes it again for a second connection instead of
+   waiting on itself. */
+class CWriteLock
+{
+public:
+  CWriteLock() : m_owner(0), m_depth(0), m_next(0), m_serving(0) {}
+
+  void lock()
+  {
+    CSingleLock lock(m_section);
+    ThreadIdentifier self = CThread::GetCurrentThreadId();
+    if (m_depth && m_owner == self)
+    {
+      m_depth++;
+      return;
+    }
+
+    unsigned int ticket = m_next++;
+    while (m_depth || ticket != m_serving)
+      m_released.wait(lock);
+    m_serving++;
+    m_owner = self;
+    m_depth = 1;
+  }
+
+  void unlock()
+  {
+    CSingleLock lock(m_section);
+    if (m_depth && --m_depth == 0)
+      m_released.notifyAll();
+  }
+
+private:
+  CCriticalSection               m_section;
+  XbmcThreads::ConditionVariable m_released;
+  ThreadIdentifier               m_owner;
+  unsigned int                   m_depth;
+  unsigned int                   m_next;    ///< ticket of the next writer to queue
+  unsigned int                   m_serving; ///< ticket of the next writer to get the lock
+};
+
+/* write locks by database file, they live as long as the process */
+static CCriticalSection s_writeLocksSection;
+static map<string, CWriteLock*> s_writeLocks;
+
+/* holds the write lock of a connection, if it has one, for a statement */
+class CWriteGuard
+{
+public:
+  CWriteGuard(CWriteLock *lock) : m_lock(lock) { if (m_lock) m_lock->lock(); }
+  ~CWriteGuard() { if (m_lock) m_lock->unlock(); }
+private:
+  CWriteLock *m_lock;
+};
+
 //************* Callback function ***************************
 
 int callback(void* res_ptr,int ncol, char** reslt,char** cols)
@@ -81,17 +151,92 @@ int callback(void* res_ptr,int ncol, char** reslt,char** cols)
 
 static int busy_callback(void*, int busyCount)
 {
+	if (busyCount >= MAX_BUSY_RETRIES)
+	{
+		CLog::Log(LOGERROR, "SQLite database still locked after %d retries, giving up", busyCount);
+		return 0;
+	}
 	Sleep(100);
 	OutputDebugString("SQLite collision\n");
 	return 1;
 }
 
+static void read_header(sqlite3_stmt *stmt, result_set &result)
+{
+  const unsigned int numColumns = sqlite3_column_count(stmt);
+  result.record_header.resize(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+    result.record_header[i].name = sqlite3_column_name(stmt, i);
+}
+
+static void read_row(sqlite3_stmt *stmt, unsigned int numColumns, sql_record &res)
+{
+  res.resize(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+  {
+    field_value &v = res.at(i);
+    switch (sqlite3_column_type(stmt, i))
+    {
+    case SQLITE_INTEGER:
+      v.set_asInt64(sqlite3_column_int64(stmt, i));
+      break;
+    case SQLITE_FLOAT:
+      v.set_asDouble(sqlite3_column_double(stmt, i));
+      break;
+    case SQLITE_TEXT:
+      v.set_asString((const char *)sqlite3_column_text(stmt, i));
+      break;
+    case SQLITE_BLOB:
+      v.set_asString((const char *)sqlite3_column_text(stmt, i));
+      break;
+    case SQLITE_NULL:
+    default:
+      v.set_asString("");
+      v.set_isNull();
+      break;
+    }
+  }
+}
+
+static sql_record *read_row(sqlite3_stmt *stmt, unsigned int numColumns)
+{
+  sql_record *res = new sql_record;
+  read_row(stmt, numColumns, *res);
+  return res;
+}
+
+static int bind_params(sqlite3_stmt *stmt, const SqlParams &params)
+{
+  if ((int)params.size() != sqlite3_bind_parameter_count(stmt))
+    return SQLITE_RANGE;
+
+  for (unsigned int i = 0; i < params.size(); i++)
+  {
+    const field_value &v = params[i];
+    int rc;
+    if (v.get_isNull())
+      rc = sqlite3_bind_null(stmt, i + 1);
+    else if (v.get_fType() == ft_String)
+      rc = sqlite3_bind_text(stmt, i + 1, v.get_asString().c_str(), -1, SQLITE_TRANSIENT);
+    else if (v.get_fType() == ft_Float || v.get_fType() == ft_Double)
+      rc = sqlite3_bind_double(stmt, i + 1, v.get_asDouble());
+    else
+      rc = sqlite3_bind_int64(stmt, i + 1, v.get_asInt64());
+
+    if (rc != SQLITE_OK)
+      return rc;
+  }
+  return SQLITE_OK;
+}
+
 //************* SqliteDatabase implementation ***************
 
 SqliteDatabase::SqliteDatabase() {
 
   active = false;	
   _in_transaction = false;		// for transaction
+  write_lock = NULL;
+  transaction_lock = NULL;
 
   error = "Unknown database error";//S_NO_CONNECTION;
   host = "localhost";
@@ -260,8 +405,51 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  clearStatements();
   sqlite3_close(conn);
   active = false;
+  end_transaction();
+}
+
+void SqliteDatabase::serialize_writes(bool serialize) {
+  if (_in_transaction)
+    return;
+
+  write_lock = NULL;
+  if (!serialize)
+    return;
+
+  CStdString path;
+  URIUtils::AddFileToFolder(host, db, path);
+
+  CSingleLock lock(s_writeLocksSection);
+  CWriteLock *&writeLock = s_writeLocks[path];
+  if (!writeLock)
+    writeLock = new CWriteLock;
+  write_lock = writeLock;
+}
+
+sqlite3_stmt *SqliteDatabase::getStatement(const string &sql) {
+  StatementCache::iterator it = statements.find(sql);
+  if (it != statements.end())
+    return it->second;
+
+  // callers are meant to use a fixed set of statements, start over if they don't
+  if (statements.size() >= MAX_CACHED_STATEMENTS)
+    clearStatements();
+
+  sqlite3_stmt *stmt = NULL;
+  if (setErr(sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, NULL), sql.c_str()) != SQLITE_OK)
+    throw DbErrors(getErrorMsg());
+
+  statements.insert(make_pair(sql, stmt));
+  return stmt;
+}
+
+void SqliteDatabase::clearStatements() {
+  for (StatementCache::iterator it = statements.begin(); it != statements.end(); ++it)
+    sqlite3_finalize(it->second);
+  statements.clear();
 }
 
 int SqliteDatabase::create() {
@@ -353,25 +541,56 @@ long SqliteDatabase::nextid(const char* sname) {
 // ---------------------------------------------
 void SqliteDatabase::start_transaction() {
   if (active) {
+    // held until the transaction ends, so other writers queue on it rather
+    // than poll sqlite's busy handler for the whole transaction
+    CWriteLock *lock = getWriteLock();
+    if (lock)
+      lock->lock();
     sqlite3_exec(conn,"begin IMMEDIATE",NULL,NULL,NULL);
     _in_transaction = true;
+    transaction_lock = lock;
   }
 }
 
 void SqliteDatabase::commit_transaction() {
   if (active) {
     sqlite3_exec(conn,"commit",NULL,NULL,NULL);
-    _in_transaction = false;
+    end_transaction();
   }
 }
 
 void SqliteDatabase::rollback_transaction() {
   if (active) {
     sqlite3_exec(conn,"rollback",NULL,NULL,NULL);
-    _in_transaction = false;
+    end_transaction();
   }  
 }
 
+void SqliteDatabase::end_transaction() {
+  _in_transaction = false;
+  if (transaction_lock)
+    transaction_lock->unlock();
+  transaction_lock = NULL;
+}
+
+void SqliteDatabase::start_savepoint() {
+  if (active)
+    sqlite3_exec(conn,"savepoint nested",NULL,NULL,NULL);
+}
+
+void SqliteDatabase::release_savepoint() {
+  if (active)
+    sqlite3_exec(conn,"release nested",NULL,NULL,NULL);
+}
+
+void SqliteDatabase::rollback_savepoint() {
+  if (active) {
+    // rolling back to a savepoint leaves it open
+    sqlite3_exec(conn,"rollback to nested",NULL,NULL,NULL);
+    sqlite3_exec(conn,"release nested",NULL,NULL,NULL);
+  }
+}
+
 
 // methods for formatting
 // ---------------------------------------------
@@ -412,6 +631,8 @@ SqliteDataset::SqliteDataset():Dataset() {
   db = NULL;
   errmsg = NULL;
   autorefresh = false;
+  cursor = NULL;
+  streaming = false;
 }
 
 
@@ -420,9 +641,12 @@ SqliteDataset::SqliteDataset(SqliteDatabase *newDb):Dataset(newDb) {
   db = newDb;
   errmsg = NULL;
   autorefresh = false;
+  cursor = NULL;
+  streaming = false;
 }
 
  SqliteDataset::~SqliteDataset(){
+   if (cursor) sqlite3_finalize(cursor);
    if (errmsg) sqlite3_free(errmsg);
  }
 
@@ -580,6 +804,7 @@ int SqliteDataset::exec(const string &sql) {
       qry = qry.substr(0, pos);
   }
 
+  CWriteGuard guard(static_cast<SqliteDatabase*>(db)->getWriteLock());
   if((res = db->setErr(sqlite3_exec(handle(),qry.c_str(),&callback,&exec_res,&errmsg),qry.c_str())) == SQLITE_OK)
     return res;
   else
@@ -612,42 +837,12 @@ bool SqliteDataset::query(const char *query) {
     throw DbErrors(db->getErrorMsg());
 
   // column headers
-  const unsigned int numColumns = sqlite3_column_count(stmt);
-  result.record_header.resize(numColumns);
-  for (unsigned int i = 0; i < numColumns; i++)
-    result.record_header[i].name = sqlite3_column_name(stmt, i);
+  read_header(stmt, result);
+  const unsigned int numColumns = result.record_header.size();
 
   // returned rows
   while (sqlite3_step(stmt) == SQLITE_ROW)
-  { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
-    for (unsigned int i = 0; i < numColumns; i++)
-    {
-      field_value &v = res->at(i);
-      switch (sqlite3_column_type(stmt, i))
-      {
-      case SQLITE_INTEGER:
-        v.set_asInt64(sqlite3_column_int64(stmt, i));
-        break;
-      case SQLITE_FLOAT:
-        v.set_asDouble(sqlite3_column_double(stmt, i));
-        break;
-      case SQLITE_TEXT:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_BLOB:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_NULL:
-      default:
-        v.set_asString("");
-        v.set_isNull();
-        break;
-      }
-    }
-    result.records.push_back(res);
-  }
+    result.records.push_back(read_row(stmt, numColumns));
   if (db->setErr(sqlite3_finalize(stmt),query) == SQLITE_OK)
   {
     active = true;
@@ -665,6 +860,102 @@ bool SqliteDataset::query(const string &q){
   return query(q.c_str());
 }
 
+bool SqliteDataset::query(const string &q, const SqlParams &params) {
+  if(!handle()) throw DbErrors("No Database Connection");
+
+  close();
+
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->getStatement(q);
+  int rc = bind_params(stmt, params);
+  if (rc == SQLITE_OK)
+  {
+    read_header(stmt, result);
+    const unsigned int numColumns = result.record_header.size();
+
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+      result.records.push_back(read_row(stmt, numColumns));
+    rc = sqlite3_reset(stmt);
+  }
+  else
+    sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+
+  if (db->setErr(rc, q.c_str()) != SQLITE_OK)
+  {
+    result.clear();
+    throw DbErrors(db->getErrorMsg());
+  }
+
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
+bool SqliteDataset::query_stream(const string &q) {
+  if(!handle()) throw DbErrors("No Database Connection");
+
+  close();
+  set_select_sql(q);
+
+  if (db->setErr(sqlite3_prepare_v2(handle(),q.c_str(),-1,&cursor, NULL),q.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+
+  read_header(cursor, result);
+  streaming = true;
+  active = true;
+  ds_state = dsSelect;
+  frecno = 0;
+  fbof = true;
+  step();
+  fbof = feof;
+  return true;
+}
+
+void SqliteDataset::step() {
+  int rc = sqlite3_step(cursor);
+  if (rc == SQLITE_ROW)
+  {
+    // the current row is overwritten in place, nothing else is kept
+    if (result.records.empty())
+      result.records.push_back(new sql_record);
+    else if (!result.records[0])
+      result.records[0] = new sql_record;
+    read_row(cursor, result.record_header.size(), *result.records[0]);
+    feof = false;
+    fill_fields();
+    return;
+  }
+
+  feof = true;
+  rc = sqlite3_finalize(cursor);
+  cursor = NULL;
+  if (db->setErr(rc, select_sql.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+}
+
+int SqliteDataset::exec(const string &sql, const SqlParams &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  exec_res.clear();
+
+  CWriteGuard guard(static_cast<SqliteDatabase*>(db)->getWriteLock());
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->getStatement(sql);
+  int rc = bind_params(stmt, params);
+  if (rc == SQLITE_OK)
+  {
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+      ;
+    rc = sqlite3_reset(stmt);
+  }
+  else
+    sqlite3_reset(stmt);
+  sqlite3_clear_bindings(stmt);
+
+  if (db->setErr(rc, sql.c_str()) != SQLITE_OK)
+    throw DbErrors(db->getErrorMsg());
+  return rc;
+}
+
 void SqliteDataset::open(const string &sql) {
 	set_select_sql(sql);
 	open();
@@ -682,6 +973,12 @@ void SqliteDataset::open() {
 
 void SqliteDataset::close() {
   Dataset::close();
+  if (cursor)
+  {
+    sqlite3_finalize(cursor);
+    cursor = NULL;
+  }
+  streaming = false;
   result.clear();
   edit_object->clear();
   fields_object->clear();
@@ -701,6 +998,9 @@ void SqliteDataset::cancel() {
 
 
 int SqliteDataset::num_rows() {
+  // a cursor doesn't know how many rows are left, only whether there is one
+  if (streaming)
+    return feof ? 0 : 1;
   return result.records.size();
 }
 
@@ -716,21 +1016,30 @@ bool SqliteDataset::bof() {
 
 
 void SqliteDataset::first() {
+  if (streaming) return;
   Dataset::first();
   this->fill_fields();
 }
 
 void SqliteDataset::last() {
+  if (streaming) return;
   Dataset::last();
   fill_fields();
 }
 
 void SqliteDataset::prev(void) {
+  if (streaming) return;
   Dataset::prev();
   fill_fields();
 }
 
 void SqliteDataset::next(void) {
+  if (streaming) {
+    fbof = false;
+    if (cursor)
+      step();
+    return;
+  }
   Dataset::next();
   if (!eof()) 
       fill_fields();
@@ -750,7 +1059,7 @@ void SqliteDataset::free_row(void)
 }
 
 bool SqliteDataset::seek(int pos) {
-  if (ds_state == dsSelect) {
+  if (ds_state == dsSelect && !streaming) {
     Dataset::seek(pos);
     fill_fields();
     return true;	
@@ -30,10 +30,13 @@
 #define _SQLITEDATASET_H
 
 #include <stdio.h>
+#include <map>
 #include "dataset.h"
 #include <sqlite3.h>
 
 namespace dbiplus {
+class CWriteLock;
+
 /***************** Class SqliteDatabase definition ******************
 
        class 'SqliteDatabase' connects with Sqlite-server
@@ -46,6 +49,18 @@ protected:
   bool _in_transaction;
   int last_err;
 
+/* shared by the connections to the same file when writes are serialized */
+  CWriteLock *write_lock;
+/* write_lock while the open transaction holds it */
+  CWriteLock *transaction_lock;
+
+/* marks the transaction ended and releases its write lock */
+  void end_transaction();
+
+/* prepared statements of queries with bound parameters, by their sql */
+  typedef std::map<std::string, sqlite3_stmt*> StatementCache;
+  StatementCache statements;
+
 public:
 /* default constructor */
   SqliteDatabase();
@@ -56,6 +71,14 @@ public:
 
 /* func. returns connection handle with SQLite-server */
   sqlite3 *getHandle() {  return conn; }
+/* returns the cached statement for sql, preparing it on first use.
+   The caller resets it when done */
+  sqlite3_stmt *getStatement(const std::string &sql);
+/* finalizes the cached statements */
+  void clearStatements();
+/* lock to hold for a single write, NULL when writes aren't serialized or
+   a transaction is open, as the transaction already holds it */
+  CWriteLock *getWriteLock() { return _in_transaction ? NULL : write_lock; }
 /* func. returns current status about SQLite-server connection */
   virtual int status();
   virtual int setErr(int err_code,const char * qry);
@@ -89,6 +112,12 @@ public:
   virtual void commit_transaction();
   virtual void rollback_transaction();
 
+  virtual void serialize_writes(bool serialize);
+
+  virtual void start_savepoint();
+  virtual void release_savepoint();
+  virtual void rollback_savepoint();
+
 /* virtual methods for formatting */
   virtual std::string vprepare(const char *format, va_list args);
 
@@ -108,6 +137,12 @@ class SqliteDataset : public Dataset {
 protected:
   sqlite3* handle();
 
+/* statement of a forward only query, stepped as the dataset moves */
+  sqlite3_stmt *cursor;
+  bool streaming;
+/* reads the next row of the cursor into the current record */
+  void step();
+
 /* Makes direct queries to database */
   virtual void make_query(StringList &_sql);
 /* Makes direct inserts into database */
@@ -147,6 +182,9 @@ or insert() operations default = false) */
 /* as open, but with our query exept Sql */
   virtual bool query(const char *query);
   virtual bool query(const std::string &query);
+  virtual bool query(const std::string &query, const SqlParams &params);
+  virtual bool query_stream(const std::string &query);
+  virtual int  exec (const std::string &sql, const SqlParams &params);
 /* func. closes a query */
   virtual void close(void);
 /* Cancel changes, made in insert or edit states of dataset */
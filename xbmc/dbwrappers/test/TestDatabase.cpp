@@ -0,0 +1,191 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/Database.h"
+#include "dbwrappers/dataset.h"
+#include "settings/AdvancedSettings.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/URIUtils.h"
+
+#include <sqlite3.h>
+
+#include "gtest/gtest.h"
+
+class CTestBatchDatabase : public CDatabase
+{
+public:
+  bool Create(const DatabaseSettings &settings)
+  {
+    return Update(settings);
+  }
+
+  bool AddItem(int id)
+  {
+    BeginTransaction();
+    if (!ExecuteQuery(PrepareSQL("INSERT INTO item (idItem) VALUES (%i)\n", id)))
+    {
+      RollbackTransaction();
+      return false;
+    }
+    return CommitTransaction();
+  }
+
+  /* an item that fails after its first write */
+  void AddFailedItem(int id)
+  {
+    BeginTransaction();
+    ExecuteQuery(PrepareSQL("INSERT INTO item (idItem) VALUES (%i)\n", id));
+    RollbackTransaction();
+  }
+
+  int CountItems(int id)
+  {
+    if (!m_pDS->query(PrepareSQL("SELECT * FROM item WHERE idItem = %i\n", id).c_str()))
+      return -1;
+    int count = m_pDS->num_rows();
+    m_pDS->close();
+    return count;
+  }
+
+protected:
+  virtual bool CreateTables()
+  {
+    CDatabase::CreateTables();
+    m_pDS->exec("CREATE TABLE item (idItem integer)\n");
+    return true;
+  }
+  virtual int GetMinVersion() const { return 1; }
+  virtual const char *GetBaseDBName() const { return "MyBatchTest"; }
+};
+
+class TestDatabaseBatch : public testing::Test
+{
+protected:
+  TestDatabaseBatch()
+  {
+    m_batchItems = g_advancedSettings.m_databaseBatchItems;
+    m_batchTime = g_advancedSettings.m_databaseBatchTime;
+    g_advancedSettings.m_databaseBatchItems = 2;
+    g_advancedSettings.m_databaseBatchTime = 60000;
+
+    m_settings.type = "sqlite3";
+    m_settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    m_other = NULL;
+  }
+
+  ~TestDatabaseBatch()
+  {
+    if (m_other)
+      sqlite3_close(m_other);
+    m_db.Close();
+    XFILE::CFile::Delete(m_path);
+    g_advancedSettings.m_databaseBatchItems = m_batchItems;
+    g_advancedSettings.m_databaseBatchTime = m_batchTime;
+  }
+
+  /* Each test gets its own file, as closed connections are kept for reuse */
+  bool Create(const CStdString &name)
+  {
+    m_settings.name = name;
+    URIUtils::AddFileToFolder(m_settings.host, name + "1.db", m_path);
+    XFILE::CFile::Delete(m_path);
+    return m_db.Create(m_settings);
+  }
+
+  /* A write from another connection, without a busy handler so it fails
+     right away rather than wait for the batch */
+  bool OtherWrite()
+  {
+    if (!m_other && sqlite3_open(m_path.c_str(), &m_other) != SQLITE_OK)
+      return false;
+    return sqlite3_exec(m_other, "INSERT INTO item (idItem) VALUES (0)", NULL, NULL, NULL) == SQLITE_OK;
+  }
+
+  CTestBatchDatabase m_db;
+  DatabaseSettings m_settings;
+  CStdString m_path;
+  sqlite3 *m_other;
+  int m_batchItems;
+  int m_batchTime;
+};
+
+TEST_F(TestDatabaseBatch, WriteBetweenItems)
+{
+  ASSERT_TRUE(Create("MyBatchTestItems"));
+  m_db.BeginBatch();
+  ASSERT_TRUE(m_db.InBatch());
+
+  // nothing written yet, so nothing is locked
+  EXPECT_TRUE(OtherWrite());
+
+  EXPECT_TRUE(m_db.AddItem(1));
+  EXPECT_FALSE(m_db.BatchItemDone());
+  EXPECT_FALSE(OtherWrite());
+
+  // the batch is committed and not begun again until the next write
+  EXPECT_TRUE(m_db.AddItem(2));
+  EXPECT_TRUE(m_db.BatchItemDone());
+  EXPECT_TRUE(OtherWrite());
+
+  EXPECT_TRUE(m_db.AddItem(3));
+  EXPECT_FALSE(OtherWrite());
+  EXPECT_TRUE(m_db.EndBatch());
+  EXPECT_TRUE(OtherWrite());
+}
+
+TEST_F(TestDatabaseBatch, RollbackItem)
+{
+  ASSERT_TRUE(Create("MyBatchTestRollback"));
+  m_db.BeginBatch();
+
+  EXPECT_TRUE(m_db.AddItem(1));
+  EXPECT_FALSE(m_db.BatchItemDone());
+
+  // only the failed item is undone, the batch keeps what came before
+  m_db.AddFailedItem(2);
+  EXPECT_EQ(0, m_db.CountItems(2));
+  EXPECT_TRUE(m_db.AddItem(3));
+  EXPECT_TRUE(m_db.EndBatch());
+
+  EXPECT_EQ(1, m_db.CountItems(1));
+  EXPECT_EQ(0, m_db.CountItems(2));
+  EXPECT_EQ(1, m_db.CountItems(3));
+}
+
+TEST_F(TestDatabaseBatch, FlushBatch)
+{
+  ASSERT_TRUE(Create("MyBatchTestFlush"));
+  m_db.BeginBatch();
+  EXPECT_FALSE(m_db.FlushBatch());
+
+  EXPECT_TRUE(m_db.AddItem(1));
+  EXPECT_FALSE(m_db.BatchItemDone());
+  EXPECT_FALSE(OtherWrite());
+
+  // what a scanner does before going online
+  EXPECT_TRUE(m_db.FlushBatch());
+  EXPECT_TRUE(OtherWrite());
+  EXPECT_FALSE(m_db.FlushBatch());
+
+  EXPECT_TRUE(m_db.AddItem(2));
+  EXPECT_TRUE(m_db.EndBatch());
+  EXPECT_TRUE(OtherWrite());
+}
@@ -0,0 +1,154 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "dbwrappers/DatabasePool.h"
+#include "dbwrappers/dataset.h"
+#include "threads/Event.h"
+
+#include "gtest/gtest.h"
+
+/* a connection that only counts its closing */
+class CTestConnection : public dbiplus::Database
+{
+public:
+  CTestConnection(int &closed) : m_closed(closed) {}
+  ~CTestConnection() { m_closed++; }
+
+  virtual dbiplus::Dataset *CreateDataset() const { return NULL; }
+  virtual int setErr(int err_code, const char *qry) { return err_code; }
+  virtual long nextid(const char* seq_name) { return 0; }
+  virtual std::string vprepare(const char *format, va_list args) { return format; }
+
+private:
+  int &m_closed;
+};
+
+class TestDatabasePool : public testing::Test
+{
+protected:
+  TestDatabasePool() : m_closed(0) {}
+
+  /* what CDatabase does to get a connection */
+  dbiplus::Database *Open(CDatabasePool &pool, const std::string &key)
+  {
+    dbiplus::Database *db = pool.Acquire(key);
+    if (db)
+      return db;
+    pool.Opened(key);
+    return new CTestConnection(m_closed);
+  }
+
+  int m_closed;
+};
+
+TEST_F(TestDatabasePool, ReusesConnection)
+{
+  CDatabasePool pool(4, 60000);
+  EXPECT_TRUE(pool.Acquire("MyVideos") == NULL);
+
+  dbiplus::Database *db = Open(pool, "MyVideos");
+  pool.Release("MyVideos", db);
+  EXPECT_EQ(0, m_closed);
+
+  /* only the same database gets it back */
+  EXPECT_TRUE(pool.Acquire("MyMusic") == NULL);
+  EXPECT_EQ(db, Open(pool, "MyVideos"));
+
+  CDatabasePool::Stats stats = pool.GetStats();
+  EXPECT_EQ(1u, stats.opened);
+  EXPECT_EQ(1u, stats.reused);
+  EXPECT_EQ(1u, stats.inUse);
+  EXPECT_EQ(0u, stats.idle);
+
+  pool.Release("MyVideos", db);
+}
+
+TEST_F(TestDatabasePool, ClosedConnection)
+{
+  CDatabasePool pool(4, 60000);
+  Open(pool, "MyVideos");
+
+  /* a connection its user closed isn't kept */
+  pool.Release("MyVideos", NULL);
+  EXPECT_TRUE(pool.Acquire("MyVideos") == NULL);
+  EXPECT_EQ(0u, pool.GetStats().inUse);
+}
+
+TEST_F(TestDatabasePool, KeepsMaxIdle)
+{
+  CDatabasePool pool(2, 60000);
+  dbiplus::Database *db[3];
+  for (int i = 0; i < 3; i++)
+    db[i] = Open(pool, "MyVideos");
+  EXPECT_EQ(3u, pool.GetStats().peakInUse);
+
+  for (int i = 0; i < 3; i++)
+    pool.Release("MyVideos", db[i]);
+  EXPECT_EQ(1, m_closed);
+  EXPECT_EQ(2u, pool.GetStats().idle);
+
+  /* the most recently used comes back first */
+  EXPECT_EQ(db[1], pool.Acquire("MyVideos"));
+  pool.Release("MyVideos", db[1]);
+}
+
+TEST_F(TestDatabasePool, Clear)
+{
+  CDatabasePool pool(4, 60000);
+  dbiplus::Database *videos = Open(pool, "MyVideos");
+  dbiplus::Database *music = Open(pool, "MyMusic");
+  pool.Release("MyVideos", videos);
+  pool.Release("MyMusic", music);
+
+  pool.Clear();
+  EXPECT_EQ(2, m_closed);
+  EXPECT_EQ(0u, pool.GetStats().idle);
+  EXPECT_TRUE(pool.Acquire("MyVideos") == NULL);
+  EXPECT_TRUE(pool.Acquire("MyMusic") == NULL);
+}
+
+TEST_F(TestDatabasePool, ExpiresIdle)
+{
+  CDatabasePool pool(4, 50);
+  dbiplus::Database *db[2];
+  db[0] = Open(pool, "MyVideos");
+  db[1] = Open(pool, "MyVideos");
+  pool.Release("MyVideos", db[0]);
+
+  CEvent wait;
+  wait.WaitMSec(200);
+
+  /* the connection idle for longer than the limit is closed, not reused */
+  pool.Release("MyVideos", db[1]);
+  EXPECT_EQ(db[1], pool.Acquire("MyVideos"));
+  EXPECT_EQ(1, m_closed);
+  EXPECT_EQ(0u, pool.GetStats().idle);
+
+  pool.Release("MyVideos", db[1]);
+}
+
+TEST_F(TestDatabasePool, ClosesOnDestruction)
+{
+  {
+    CDatabasePool pool(4, 60000);
+    pool.Release("MyVideos", Open(pool, "MyVideos"));
+  }
+  EXPECT_EQ(1, m_closed);
+}
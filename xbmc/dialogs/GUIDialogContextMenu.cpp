@@ -558,9 +558,7 @@ bool CGUIDialogContextMenu::OnContextButton(const CStdString &type, const CFileI
       }
       else if (!strThumb.IsEmpty())
       { // this is some sort of an auto-share, so store in the texture database
-        CTextureDatabase db;
-        if (db.Open())
-          db.SetTextureForPath(item->GetPath(), "thumb", strThumb);
+        CTextureCache::Get().SetTextureForPath(item->GetPath(), "thumb", strThumb);
       }
 
       CGUIMessage msg(GUI_MSG_NOTIFY_ALL,0,0,GUI_MSG_UPDATE_SOURCES);
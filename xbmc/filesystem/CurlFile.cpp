@@ -222,6 +222,7 @@ CCurlFile::CReadState::CReadState()
   m_bFirstLoop = true;
   m_sendRange = true;
   m_headerdone = false;
+  m_parked = false;
 
   /* PLEX */
   m_hasTicklePipe = PlexUtils::MakeWakeupPipe(m_ticklePipe);
@@ -246,7 +247,8 @@ CCurlFile::CReadState::~CReadState()
   /* END PLEX */
 }
 
-bool CCurlFile::CReadState::Seek(int64_t pos)
+/* seeks within what has been received already, never waits on the connection */
+bool CCurlFile::CReadState::SeekBuffered(int64_t pos)
 {
   if(pos == m_filePos)
     return true;
@@ -256,6 +258,13 @@ bool CCurlFile::CReadState::Seek(int64_t pos)
     m_filePos = pos;
     return true;
   }
+  return false;
+}
+
+bool CCurlFile::CReadState::Seek(int64_t pos)
+{
+  if(SeekBuffered(pos))
+    return true;
 
   if(pos > m_filePos && pos < m_filePos + m_bufferSize)
   {
@@ -308,6 +317,7 @@ long CCurlFile::CReadState::Connect(unsigned int size)
 {
   SetResume();
   g_curlInterface.multi_add_handle(m_multiHandle, m_easyHandle);
+  m_parked = false;
 
   m_bufferSize = size;
   m_buffer.Destroy();
@@ -340,6 +350,29 @@ long CCurlFile::CReadState::Connect(unsigned int size)
   return -1;
 }
 
+/* stops the transfer rather than leave the connection idle, where the server
+ * may close it at any time, what was received stays readable */
+void CCurlFile::CReadState::Park()
+{
+  if(m_multiHandle && m_easyHandle)
+    g_curlInterface.multi_remove_handle(m_multiHandle, m_easyHandle);
+
+  free(m_overflowBuffer);
+  m_overflowBuffer = NULL;
+  m_overflowSize = 0;
+  m_parked = true;
+}
+
+/* asks for the rest of the file from where the data received before parking ends */
+void CCurlFile::CReadState::Resume()
+{
+  g_curlInterface.easy_setopt(m_easyHandle, CURLOPT_RANGE, NULL);
+  g_curlInterface.easy_setopt(m_easyHandle, CURLOPT_RESUME_FROM_LARGE, m_filePos + m_buffer.getMaxReadSize());
+  g_curlInterface.multi_add_handle(m_multiHandle, m_easyHandle);
+  m_stillRunning = 1;
+  m_parked = false;
+}
+
 void CCurlFile::CReadState::Disconnect()
 {
   if(m_multiHandle && m_easyHandle && g_curlInterface.IsLoaded()) // PLEX
@@ -402,6 +435,7 @@ void CCurlFile::SetBufferSize(unsigned int size)
 
 void CCurlFile::Close()
 {
+  ClearRangeStates();
   m_state->Disconnect();
 
   m_url.Empty();
@@ -1175,6 +1209,19 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   CReadState* oldstate = NULL;
   if(m_multisession)
   {
+    /* see if one of the connections we kept around already covers this position */
+    CReadState* rangestate = TakeRangeState(nextPos);
+    if(rangestate)
+    {
+      ParkRangeState(m_state);
+      m_state = rangestate;
+
+      /* the header list its handle points to has been rebuilt since, it
+       * needs the current one for the request that resumes it */
+      SetRequestHeaders(m_state);
+      return nextPos;
+    }
+
     CURL url(m_url);
     oldstate = m_state;
     m_state = new CReadState();
@@ -1212,11 +1259,51 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   }
 
   SetCorrectHeaders(m_state);
-  delete oldstate;
+  if (oldstate)
+    ParkRangeState(oldstate);
 
   return m_state->m_filePos;
 }
 
+CCurlFile::CReadState* CCurlFile::TakeRangeState(int64_t pos)
+{
+  for (RANGESTATES::iterator it = m_rangeStates.begin(); it != m_rangeStates.end(); ++it)
+  {
+    CReadState* state = *it;
+    if (state->SeekBuffered(pos))
+    {
+      m_rangeStates.erase(it);
+      CLog::Log(LOGDEBUG, "CCurlFile::TakeRangeState - reusing buffered data for position %" PRId64, pos);
+      return state;
+    }
+  }
+  return NULL;
+}
+
+void CCurlFile::ParkRangeState(CReadState* state)
+{
+  if (state->m_cancelled || g_advancedSettings.m_curlrangesessions <= 0 || !state->m_buffer.getMaxReadSize())
+  {
+    delete state;
+    return;
+  }
+
+  state->Park();
+  m_rangeStates.push_front(state);
+  while (m_rangeStates.size() > (size_t)g_advancedSettings.m_curlrangesessions)
+  {
+    delete m_rangeStates.back();
+    m_rangeStates.pop_back();
+  }
+}
+
+void CCurlFile::ClearRangeStates()
+{
+  for (RANGESTATES::iterator it = m_rangeStates.begin(); it != m_rangeStates.end(); ++it)
+    delete *it;
+  m_rangeStates.clear();
+}
+
 int64_t CCurlFile::GetLength()
 {
   if (!m_opened) return 0;
@@ -1416,6 +1503,9 @@ bool CCurlFile::CReadState::FillBuffer(unsigned int want)
       continue;
     }
 
+    if (m_parked)
+      Resume();
+
     CURLMcode result = g_curlInterface.multi_perform(m_multiHandle, &m_stillRunning);
     if (!m_stillRunning)
     {
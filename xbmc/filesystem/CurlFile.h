@@ -22,6 +22,7 @@
 #include "IFile.h"
 #include "utils/RingBuffer.h"
 #include <map>
+#include <deque>
 #include "utils/HttpHeader.h"
 /* PLEX */
 #include "log.h"
@@ -114,6 +115,7 @@ namespace XFILE
           int64_t         m_filePos;
           bool            m_bFirstLoop;
           bool            m_sendRange;
+          bool            m_parked;           // transfer stopped, resumed with a new range request when the buffer runs out
 
           /* returned http header */
           CHttpHeader m_httpheader;
@@ -123,6 +125,7 @@ namespace XFILE
           size_t HeaderCallback(void *ptr, size_t size, size_t nmemb);
 
           bool         Seek(int64_t pos);
+          bool         SeekBuffered(int64_t pos);
           unsigned int Read(void* lpBuf, int64_t uiBufSize);
           bool         ReadString(char *szLine, int iLineLength);
           bool         FillBuffer(unsigned int want);
@@ -130,6 +133,8 @@ namespace XFILE
           void         SetResume(void);
           long         Connect(unsigned int size);
           void         Disconnect();
+          void         Park();
+          void         Resume();
 
           /* PLEX */
           CStdString    m_strDeadEndUrl; // If we can't redirect, this holds the last URL.
@@ -160,10 +165,20 @@ namespace XFILE
       void SetCorrectHeaders(CReadState* state);
       virtual bool Service(const CStdString& strURL, CStdString& strHTML);
 
+      /* range sessions, read states kept with the data they received so seeks
+       * back between regions of the file (e.g. index and data) don't reconnect
+       * until reading past it */
+      CReadState* TakeRangeState(int64_t pos);
+      void        ParkRangeState(CReadState* state);
+      void        ClearRangeStates();
+
     protected:
       CReadState*     m_state;
       unsigned int    m_bufferSize;
 
+      typedef std::deque<CReadState*> RANGESTATES;
+      RANGESTATES     m_rangeStates;      // most recently used first
+
       CStdString      m_url;
       CStdString      m_userAgent;
       CStdString      m_proxy;
@@ -0,0 +1,261 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/CurlFile.h"
+#include "threads/Thread.h"
+#include "threads/SingleLock.h"
+#include "URL.h"
+
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+using namespace XFILE;
+
+static char TestByte(int64_t pos)
+{
+  return (char)(pos % 251);
+}
+
+class CTestHttpServer;
+
+/* answers one request, with the part of the file it asked for */
+class CTestHttpConnection : public CThread
+{
+public:
+  CTestHttpConnection(CTestHttpServer &server, int socket)
+    : CThread("TestHttpConnection"), m_server(server), m_socket(socket) {}
+  ~CTestHttpConnection() { StopThread(); }
+
+protected:
+  virtual void Process();
+
+private:
+  CTestHttpServer &m_server;
+  int              m_socket;
+};
+
+/* a file served over http on the loopback, counting the requests for it */
+class CTestHttpServer : public CThread
+{
+public:
+  CTestHttpServer(int64_t size)
+    : CThread("TestHttpServer"), m_size(size), m_socket(-1), m_port(0), m_requests(0), m_lastStart(-1) {}
+
+  ~CTestHttpServer()
+  {
+    StopThread();
+    for (std::vector<CTestHttpConnection*>::iterator it = m_connections.begin(); it != m_connections.end(); ++it)
+      delete *it;
+    if (m_socket >= 0)
+      close(m_socket);
+  }
+
+  bool Start()
+  {
+    m_socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_socket < 0)
+      return false;
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof(addr);
+    if (bind(m_socket, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        listen(m_socket, 8) < 0 ||
+        getsockname(m_socket, (struct sockaddr*)&addr, &len) < 0)
+      return false;
+
+    m_port = ntohs(addr.sin_port);
+    Create();
+    return true;
+  }
+
+  CStdString GetUrl() const
+  {
+    CStdString url;
+    url.Format("http://127.0.0.1:%d/file", m_port);
+    return url;
+  }
+
+  int64_t GetSize() const { return m_size; }
+
+  int Requests()
+  {
+    CSingleLock lock(m_section);
+    return m_requests;
+  }
+
+  /* where the last request started reading */
+  int64_t LastStart()
+  {
+    CSingleLock lock(m_section);
+    return m_lastStart;
+  }
+
+  void Requested(int64_t start)
+  {
+    CSingleLock lock(m_section);
+    m_requests++;
+    m_lastStart = start;
+  }
+
+protected:
+  virtual void Process()
+  {
+    while (!m_bStop)
+    {
+      fd_set fds;
+      FD_ZERO(&fds);
+      FD_SET(m_socket, &fds);
+      struct timeval timeout = { 0, 100000 };
+      if (select(m_socket + 1, &fds, NULL, NULL, &timeout) <= 0)
+        continue;
+
+      int connection = accept(m_socket, NULL, NULL);
+      if (connection < 0)
+        continue;
+
+      /* each on its own, curl keeps the last connection open while it
+       * makes the next */
+      CTestHttpConnection *handler = new CTestHttpConnection(*this, connection);
+      m_connections.push_back(handler);
+      handler->Create();
+    }
+  }
+
+private:
+  int64_t          m_size;
+  int              m_socket;
+  int              m_port;
+  CCriticalSection m_section;
+  int              m_requests;
+  int64_t          m_lastStart;
+  std::vector<CTestHttpConnection*> m_connections;
+};
+
+void CTestHttpConnection::Process()
+{
+  std::string request;
+  char buf[1024];
+  while (request.find("\r\n\r\n") == std::string::npos)
+  {
+    ssize_t got = recv(m_socket, buf, sizeof(buf), 0);
+    if (got <= 0)
+    {
+      close(m_socket);
+      return;
+    }
+    request.append(buf, got);
+  }
+
+  int64_t size = m_server.GetSize();
+  int64_t start = 0;
+  size_t range = request.find("Range: bytes=");
+  if (range != std::string::npos)
+    start = strtoll(request.c_str() + range + 13, NULL, 10);
+  m_server.Requested(start);
+
+  CStdString header;
+  header.Format("HTTP/1.1 206 Partial Content\r\n"
+                "Content-Range: bytes %" PRId64 "-%" PRId64 "/%" PRId64 "\r\n"
+                "Content-Length: %" PRId64 "\r\n"
+                "Accept-Ranges: bytes\r\n"
+                "Connection: close\r\n\r\n",
+                start, size - 1, size, size - start);
+  bool ok = send(m_socket, header.c_str(), header.size(), MSG_NOSIGNAL) == (ssize_t)header.size();
+
+  /* until the client has what it asked for or hangs up */
+  for (int64_t pos = start; ok && pos < size && !m_bStop;)
+  {
+    int len = 0;
+    for (; len < (int)sizeof(buf) && pos + len < size; len++)
+      buf[len] = TestByte(pos + len);
+    ssize_t sent = send(m_socket, buf, len, MSG_NOSIGNAL);
+    ok = sent > 0;
+    if (ok)
+      pos += sent;
+  }
+  close(m_socket);
+}
+
+/* reads len bytes at the position of file, checking they are the served ones */
+static bool ReadChecked(CCurlFile &file, int64_t len)
+{
+  char buf[4096];
+  int64_t pos = file.GetPosition();
+  while (len > 0)
+  {
+    unsigned int got = file.Read(buf, len < (int64_t)sizeof(buf) ? len : sizeof(buf));
+    if (got == 0)
+      return false;
+    for (unsigned int i = 0; i < got; i++)
+    {
+      if (buf[i] != TestByte(pos + i))
+        return false;
+    }
+    pos += got;
+    len -= got;
+  }
+  return true;
+}
+
+TEST(TestCurlFile, SeekBackReusesData)
+{
+  const int64_t size = 1 << 20;
+  CTestHttpServer server(size);
+  ASSERT_TRUE(server.Start());
+
+  CCurlFile file;
+  ASSERT_TRUE(file.Open(CURL(server.GetUrl())));
+  EXPECT_EQ(size, file.GetLength());
+  EXPECT_TRUE(ReadChecked(file, 100));
+  EXPECT_EQ(1, server.Requests());
+
+  /* the index at the end of the file */
+  EXPECT_EQ(size - 100, file.Seek(size - 100, SEEK_SET));
+  EXPECT_TRUE(ReadChecked(file, 100));
+  EXPECT_EQ(2, server.Requests());
+
+  /* back to the data, served from what the first request received */
+  EXPECT_EQ(100, file.Seek(100, SEEK_SET));
+  EXPECT_EQ(2, server.Requests());
+
+  /* reading past that asks for the rest, from where that data ended */
+  EXPECT_TRUE(ReadChecked(file, 256 * 1024));
+  EXPECT_EQ(100 + 256 * 1024, file.GetPosition());
+  EXPECT_EQ(3, server.Requests());
+  EXPECT_GE(server.LastStart(), 100);
+
+  file.Close();
+}
@@ -26,10 +26,19 @@
 #include "Util.h"
 #include "utils/log.h"
 #include "GUIInfoManager.h"
+#include "cores/AudioEngine/AEFactory.h"
 #include "system.h"
 
 using namespace JSONRPC;
 
+static CVariant StageTimingToVariant(const AEStageTiming &timing)
+{
+  CVariant result = CVariant(CVariant::VariantTypeObject);
+  result["average"] = timing.average;
+  result["max"] = timing.max;
+  return result;
+}
+
 JSONRPC_STATUS CApplicationOperations::GetProperties(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CVariant properties = CVariant(CVariant::VariantTypeObject);
@@ -134,6 +143,29 @@ JSONRPC_STATUS CApplicationOperations::GetPropertyValue(const CStdString &proper
     else
       result["tag"] = "prealpha";
   }
+  else if (property.Equals("audioengine"))
+  {
+    AEStats stats;
+    if (!CAEFactory::GetStats(stats))
+      return FailedToExecute;
+
+    result = CVariant(CVariant::VariantTypeObject);
+    result["sink"] = stats.sink;
+    result["passthrough"] = stats.passthrough;
+    result["transcode"] = stats.transcode;
+    result["streams"] = stats.streams;
+    result["resampleratio"] = stats.resampleRatio;
+    result["buffered"] = stats.bufferedTime * 1000.0;
+    result["bufferedtotal"] = stats.bufferedTotal * 1000.0;
+    result["sinkdelay"] = stats.sinkDelay * 1000.0;
+    result["sinkcache"] = stats.sinkCacheTime * 1000.0;
+    result["sinkcachetotal"] = stats.sinkCacheTotal * 1000.0;
+    result["underruns"] = stats.underruns;
+    result["sinkerrors"] = stats.sinkErrors;
+    result["streamstage"] = StageTimingToVariant(stats.streamStage);
+    result["outputstage"] = StageTimingToVariant(stats.outputStage);
+    result["sinkwrite"] = StageTimingToVariant(stats.sinkWrite);
+  }
   else
     return InvalidParams;
 
@@ -231,9 +231,11 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
       fields.insert(field->asString());
   }
 
+  if (resultname && end - start > 0)
+    result[resultname].reserve(result[resultname].size() + end - start);
+
   for (int i = start; i < end; i++)
   {
-    CVariant object;
     CFileItemPtr item = items.Get(i);
     HandleFileItem(ID, allowFile, resultname, item, parameterObject, fields, result, true, thumbLoader);
   }
@@ -346,9 +348,9 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
   if (resultname)
   {
     if (append)
-      result[resultname].append(object);
+      result[resultname].push_back_swap(object);
     else
-      result[resultname] = object;
+      result[resultname].swap(object);
   }
 }
 
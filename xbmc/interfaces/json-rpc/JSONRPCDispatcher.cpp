@@ -0,0 +1,146 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "JSONRPCDispatcher.h"
+#include "JSONRPC.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/Variant.h"
+
+using namespace JSONRPC;
+
+class CJSONRPCDispatcher::CRequestJob : public CJob
+{
+public:
+  CRequestJob(CJSONRPCDispatcher *dispatcher, const std::string &request, ITransportLayer *transport, IAsyncClient *client)
+    : m_dispatcher(dispatcher), m_request(request), m_transport(transport), m_client(client)
+  {
+    m_client->Acquire();
+    m_queued      = XbmcThreads::SystemClockMillis();
+    m_started     = false;
+    m_hasResponse = false;
+
+    {
+      CSingleLock lock(m_dispatcher->m_jobsSection);
+      m_dispatcher->m_jobs++;
+      m_dispatcher->m_idle.Reset();
+    }
+
+    CSingleLock lock(m_statsSection);
+    m_stats.queued++;
+  }
+
+  virtual ~CRequestJob()
+  {
+    if (!m_started)
+    {
+      CSingleLock lock(m_statsSection);
+      m_stats.queued--;
+      m_stats.cancelled++;
+    }
+
+    {
+      CSingleLock lock(m_dispatcher->m_jobsSection);
+      if (--m_dispatcher->m_jobs == 0)
+        m_dispatcher->m_idle.Set();
+    }
+
+    // may destroy the client and the dispatcher with it
+    m_client->Release();
+  }
+
+  virtual const char *GetType() const { return "jsonrpc"; }
+
+  virtual bool DoWork()
+  {
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    unsigned int wait  = start - m_queued;
+    m_started = true;
+    {
+      CSingleLock lock(m_statsSection);
+      m_stats.queued--;
+      m_stats.running++;
+      if (wait > m_stats.maxWait)
+        m_stats.maxWait = wait;
+    }
+
+    m_hasResponse = CJSONRPC::MethodCall(m_request, m_transport, m_client, m_response);
+
+    CSingleLock lock(m_statsSection);
+    m_stats.running--;
+    m_stats.completed++;
+    m_stats.waitTime += wait;
+    m_stats.runTime  += XbmcThreads::SystemClockMillis() - start;
+    return true;
+  }
+
+  CJSONRPCDispatcher *m_dispatcher;
+  std::string         m_request;
+  CVariant            m_response;
+  bool                m_hasResponse;
+  ITransportLayer    *m_transport;
+  IAsyncClient       *m_client;
+  unsigned int        m_queued;
+  bool                m_started;
+};
+
+CCriticalSection CJSONRPCDispatcher::m_statsSection;
+CJSONRPCDispatcher::Stats CJSONRPCDispatcher::m_stats = { 0, 0, 0, 0, 0, 0, 0 };
+
+CJSONRPCDispatcher::CJSONRPCDispatcher()
+  : CJobQueue(false, 1, CJob::PRIORITY_HIGH), m_idle(true, true)
+{
+  m_jobs = 0;
+}
+
+CJSONRPCDispatcher::~CJSONRPCDispatcher()
+{
+}
+
+void CJSONRPCDispatcher::Dispatch(const std::string &request, ITransportLayer *transport, IAsyncClient *client)
+{
+  AddJob(new CRequestJob(this, request, transport, client));
+}
+
+void CJSONRPCDispatcher::Cancel()
+{
+  CancelJobs();
+}
+
+bool CJSONRPCDispatcher::WaitIdle(unsigned int timeout)
+{
+  return m_idle.WaitMSec(timeout);
+}
+
+CJSONRPCDispatcher::Stats CJSONRPCDispatcher::GetStats()
+{
+  CSingleLock lock(m_statsSection);
+  return m_stats;
+}
+
+void CJSONRPCDispatcher::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  // the next request of this client is only started once this one has been answered
+  CRequestJob *request = (CRequestJob *)job;
+  if (success && request->m_hasResponse)
+    request->m_client->Respond(request->m_response);
+
+  CJobQueue::OnJobComplete(jobID, success, job);
+}
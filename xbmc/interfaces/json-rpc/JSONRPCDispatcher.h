@@ -0,0 +1,112 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+
+#include "IClient.h"
+#include "ITransportLayer.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/JobManager.h"
+
+namespace JSONRPC
+{
+  /*!
+   \ingroup jsonrpc
+   \brief Client whose requests are answered asynchronously by a CJSONRPCDispatcher
+
+   The client is reference counted so that it stays valid while one of its
+   requests is running, even after the transport has dropped the connection.
+   */
+  class IAsyncClient : public IClient
+  {
+  public:
+    virtual ~IAsyncClient() { };
+    virtual void Acquire() = 0;
+    virtual void Release() = 0;
+
+    /*!
+     \brief Called on a job worker with the response to a dispatched request
+     The response may be large, transports should serialize it as they send it.
+     \sa CJSONVariantStreamWriter
+     */
+    virtual void Respond(const CVariant &response) = 0;
+  };
+
+  /*!
+   \ingroup jsonrpc
+   \brief Runs the JSON-RPC requests of one client on the job manager's workers
+
+   Requests of a client are run one at a time in the order they were
+   dispatched, so its responses go out in order while the transport thread
+   goes back to serving other clients. Cancelling drops the requests that
+   haven't started, and the response of a running one.
+   */
+  class CJSONRPCDispatcher : private CJobQueue
+  {
+  public:
+    CJSONRPCDispatcher();
+    virtual ~CJSONRPCDispatcher();
+
+    void Dispatch(const std::string &request, ITransportLayer *transport, IAsyncClient *client);
+
+    /*!
+     \brief Cancels all requests, called when the client goes away
+     */
+    void Cancel();
+
+    /*!
+     \brief Waits for a running request to finish, so the transport may go away
+     \return true if no request is left, false on timeout
+     */
+    bool WaitIdle(unsigned int timeout);
+
+    struct Stats
+    {
+      unsigned int queued;    ///< requests waiting for a worker
+      unsigned int running;   ///< requests being processed
+      unsigned int completed; ///< requests answered
+      unsigned int cancelled; ///< requests dropped because the client went away
+      uint64_t     waitTime;  ///< total ms answered requests spent queued
+      uint64_t     runTime;   ///< total ms answered requests spent running
+      unsigned int maxWait;   ///< longest ms a request spent queued
+    };
+
+    /*!
+     \brief Counters over the requests of all clients, since startup
+     */
+    static Stats GetStats();
+
+  private:
+    class CRequestJob;
+    friend class CRequestJob;
+
+    virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+    CCriticalSection m_jobsSection;
+    unsigned int     m_jobs; ///< jobs not yet destroyed
+    CEvent           m_idle;
+
+    static CCriticalSection m_statsSection;
+    static Stats            m_stats;
+  };
+}
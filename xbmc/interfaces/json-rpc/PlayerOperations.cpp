@@ -41,6 +41,7 @@
 #include "pvr/PVRManager.h"
 #include "pvr/channels/PVRChannel.h"
 #include "pvr/channels/PVRChannelGroupsContainer.h"
+#include "cores/VideoRenderers/RenderManager.h"
 
 using namespace JSONRPC;
 using namespace PLAYLIST;
@@ -1494,6 +1495,32 @@ JSONRPC_STATUS CPlayerOperations::GetPropertyValue(PlayerType player, const CStd
   }
   else if (property.Equals("live"))
     result = IsPVRChannel();
+  else if (property.Equals("renderstats"))
+  {
+    if (player != Video)
+      return FailedToExecute;
+
+    SRenderStatsSummary stats;
+    g_renderManager.GetRenderStats(stats);
+
+    result = CVariant(CVariant::VariantTypeObject);
+    result["frames"] = stats.frames;
+    result["dropped"] = stats.dropped;
+    result["missedvsyncs"] = stats.missedVsyncs;
+    result["refreshperiod"] = stats.refreshPeriod * 1000.0;
+    result["window"] = stats.window;
+    result["averageerror"] = stats.avgError;
+    result["maxerror"] = stats.maxError;
+    result["averagelatency"] = stats.avgLatency;
+    result["averagequeue"] = stats.avgQueue;
+    result["durations"] = CVariant(CVariant::VariantTypeArray);
+    result["errors"] = CVariant(CVariant::VariantTypeArray);
+    for (int i = 0; i < RENDERSTATS_BUCKETS; i++)
+    {
+      result["durations"].push_back(stats.durations[i]);
+      result["errors"].push_back(stats.errors[i]);
+    }
+  }
   else
     return InvalidParams;
 
@@ -22,7 +22,7 @@
 namespace JSONRPC
 {
   const char* const JSONRPC_SERVICE_ID          = "http://www.xbmc.org/jsonrpc/ServiceDescription.json";
-  const char* const JSONRPC_SERVICE_VERSION     = "6.0.3";
+  const char* const JSONRPC_SERVICE_VERSION     = "6.2.0";
   const char* const JSONRPC_SERVICE_DESCRIPTION = "JSON-RPC API of XBMC";
 
   const char* const JSONRPC_SERVICE_TYPES[] = {  
@@ -250,7 +250,25 @@ namespace JSONRPC
                 "\"totaltime\", \"playlistid\", \"position\", \"repeat\", \"shuffled\","
                 "\"canseek\", \"canchangespeed\", \"canmove\", \"canzoom\", \"canrotate\","
                 "\"canshuffle\", \"canrepeat\", \"currentaudiostream\", \"audiostreams\","
-                "\"subtitleenabled\", \"currentsubtitle\", \"subtitles\", \"live\" ]"
+                "\"subtitleenabled\", \"currentsubtitle\", \"subtitles\", \"live\","
+                "\"renderstats\" ]"
+    "}",
+    "\"Player.RenderStats\": {"
+      "\"type\": \"object\","
+      "\"description\": \"Frame pacing of the video renderer, averages and histograms cover the most recent frames\","
+      "\"properties\": {"
+        "\"frames\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true },"
+        "\"dropped\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true },"
+        "\"missedvsyncs\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true },"
+        "\"refreshperiod\": { \"type\": \"number\", \"minimum\": 0, \"required\": true, \"description\": \"Milliseconds between vertical blanks\" },"
+        "\"window\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true },"
+        "\"averageerror\": { \"type\": \"number\", \"required\": true, \"description\": \"Milliseconds between the intended and the actual present time\" },"
+        "\"maxerror\": { \"type\": \"number\", \"required\": true },"
+        "\"averagelatency\": { \"type\": \"number\", \"required\": true, \"description\": \"Milliseconds from decode to present\" },"
+        "\"averagequeue\": { \"type\": \"number\", \"minimum\": 0, \"required\": true },"
+        "\"durations\": { \"type\": \"array\", \"items\": { \"type\": \"integer\" }, \"required\": true, \"description\": \"Frames shown for 0, 1, 2... vertical blanks, the last entry counts longer ones too\" },"
+        "\"errors\": { \"type\": \"array\", \"items\": { \"type\": \"integer\" }, \"required\": true, \"description\": \"Present errors in half refresh periods starting at -1 period\" }"
+      "}"
     "}",
     "\"Player.Property.Value\": {"
       "\"type\": \"object\","
@@ -277,7 +295,8 @@ namespace JSONRPC
         "\"subtitleenabled\": { \"type\": \"boolean\" },"
         "\"currentsubtitle\": { \"$ref\": \"Player.Subtitle\" },"
         "\"subtitles\": { \"type\": \"array\", \"items\": { \"$ref\": \"Player.Subtitle\" } },"
-        "\"live\": { \"type\": \"boolean\" }"
+        "\"live\": { \"type\": \"boolean\" },"
+        "\"renderstats\": { \"$ref\": \"Player.RenderStats\" }"
       "}"
     "}",
     "\"Notifications.Item.Type\": {"
@@ -1226,9 +1245,17 @@ namespace JSONRPC
         "\"canreboot\": { \"type\": \"boolean\" }"
       "}"
     "}",
+    "\"Application.AudioEngine.Timing\": {"
+      "\"type\": \"object\","
+      "\"description\": \"Processing time in microseconds over the last second\","
+      "\"properties\": {"
+        "\"average\": { \"type\": \"number\", \"minimum\": 0, \"required\": true },"
+        "\"max\": { \"type\": \"number\", \"minimum\": 0, \"required\": true }"
+      "}"
+    "}",
     "\"Application.Property.Name\": {"
       "\"type\": \"string\","
-      "\"enum\": [ \"volume\", \"muted\", \"name\", \"version\" ]"
+      "\"enum\": [ \"volume\", \"muted\", \"name\", \"version\", \"audioengine\" ]"
     "}",
     "\"Application.Property.Value\": {"
       "\"type\": \"object\","
@@ -1243,6 +1270,25 @@ namespace JSONRPC
             "\"revision\": { \"type\": [ \"string\", \"integer\" ] },"
             "\"tag\": { \"type\": \"string\", \"enum\": [ \"prealpha\", \"alpha\", \"beta\", \"releasecandidate\", \"stable\" ], \"required\": true }"
           "}"
+        "},"
+        "\"audioengine\": { \"type\": \"object\","
+          "\"properties\": {"
+            "\"sink\": { \"type\": \"string\", \"required\": true },"
+            "\"passthrough\": { \"type\": \"boolean\", \"required\": true },"
+            "\"transcode\": { \"type\": \"boolean\", \"required\": true },"
+            "\"streams\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true },"
+            "\"resampleratio\": { \"type\": \"number\", \"required\": true },"
+            "\"buffered\": { \"type\": \"number\", \"minimum\": 0, \"required\": true, \"description\": \"Milliseconds of audio queued in the engine\" },"
+            "\"bufferedtotal\": { \"type\": \"number\", \"minimum\": 0, \"required\": true },"
+            "\"sinkdelay\": { \"type\": \"number\", \"minimum\": 0, \"required\": true, \"description\": \"Milliseconds until audio added to the sink is heard\" },"
+            "\"sinkcache\": { \"type\": \"number\", \"minimum\": 0, \"required\": true },"
+            "\"sinkcachetotal\": { \"type\": \"number\", \"minimum\": 0, \"required\": true },"
+            "\"underruns\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true },"
+            "\"sinkerrors\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true },"
+            "\"streamstage\": { \"$ref\": \"Application.AudioEngine.Timing\", \"required\": true },"
+            "\"outputstage\": { \"$ref\": \"Application.AudioEngine.Timing\", \"required\": true },"
+            "\"sinkwrite\": { \"$ref\": \"Application.AudioEngine.Timing\", \"required\": true }"
+          "}"
         "}"
       "}"
     "}"
@@ -528,14 +528,17 @@ int CMusicDatabase::AddGenre(const CStdString& strGenre1)
       return it->second;
 
 
-    strSQL=PrepareSQL("select * from genre where strGenre like '%s'", strGenre.c_str());
-    m_pDS->query(strSQL.c_str());
+    dbiplus::SqlParams params;
+    params.push_back(strGenre);
+
+    strSQL = "select * from genre where strGenre like ?";
+    m_pDS->query(strSQL, params);
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
       // doesnt exists, add it
-      strSQL=PrepareSQL("insert into genre (idGenre, strGenre) values( NULL, '%s' )", strGenre.c_str());
-      m_pDS->exec(strSQL.c_str());
+      strSQL = "insert into genre (idGenre, strGenre) values( NULL, ? )";
+      m_pDS->exec(strSQL, params);
 
       int idGenre = (int)m_pDS->lastinsertid();
       m_genreCache.insert(pair<CStdString, int>(strGenre1, idGenre));
@@ -855,14 +858,17 @@ int CMusicDatabase::AddPath(const CStdString& strPath1)
     if (it != m_pathCache.end())
       return it->second;
 
-    strSQL=PrepareSQL( "select * from path where strPath='%s'", strPath.c_str());
-    m_pDS->query(strSQL.c_str());
+    dbiplus::SqlParams params;
+    params.push_back(strPath);
+
+    strSQL = "select * from path where strPath=?";
+    m_pDS->query(strSQL, params);
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
       // doesnt exists, add it
-      strSQL=PrepareSQL("insert into path (idPath, strPath) values( NULL, '%s' )", strPath.c_str());
-      m_pDS->exec(strSQL.c_str());
+      strSQL = "insert into path (idPath, strPath) values( NULL, ? )";
+      m_pDS->exec(strSQL, params);
 
       int idPath = (int)m_pDS->lastinsertid();
       m_pathCache.insert(pair<CStdString, int>(strPath, idPath));
@@ -3143,47 +3149,55 @@ bool CMusicDatabase::GetAlbumsByWhere(const CStdString &baseDir, const Filter &f
     strSQL = PrepareSQL(strSQL, !filter.fields.empty() && filter.fields.compare("*") != 0 ? filter.fields.c_str() : "albumview.*") + strSQLExtra;
 
     CLog::Log(LOGDEBUG, "%s query: %s", __FUNCTION__, strSQL.c_str());
-    // run query
+    // run query, rows are used in the order they are read when there's
+    // nothing to sort so they can be stepped through instead of held
+    bool streaming = !countOnly && sortDescription.sortBy == SortByNone;
     unsigned int time = XbmcThreads::SystemClockMillis();
-    if (!m_pDS->query(strSQL.c_str()))
+    if (!(streaming ? m_pDS->query_stream(strSQL) : m_pDS->query(strSQL.c_str())))
       return false;
     CLog::Log(LOGDEBUG, "%s - query took %i ms",
               __FUNCTION__, XbmcThreads::SystemClockMillis() - time); time = XbmcThreads::SystemClockMillis();
 
-    int iRowsFound = m_pDS->num_rows();
-    if (iRowsFound <= 0)
+    DatabaseResults results;
+    const dbiplus::query_data *data = NULL;
+    if (!streaming)
     {
-      m_pDS->close();
-      return true;
-    }
+      int iRowsFound = m_pDS->num_rows();
+      if (iRowsFound <= 0)
+      {
+        m_pDS->close();
+        return true;
+      }
 
-    // store the total value of items as a property
-    if (total < iRowsFound)
-      total = iRowsFound;
-    items.SetProperty("total", total);
+      // store the total value of items as a property
+      if (total < iRowsFound)
+        total = iRowsFound;
+      items.SetProperty("total", total);
 
-    if (countOnly)
-    {
-      CFileItemPtr pItem(new CFileItem());
-      pItem->SetProperty("total", total);
-      items.Add(pItem);
+      if (countOnly)
+      {
+        CFileItemPtr pItem(new CFileItem());
+        pItem->SetProperty("total", total);
+        items.Add(pItem);
 
-      m_pDS->close();
-      return true;
+        m_pDS->close();
+        return true;
+      }
+
+      results.reserve(iRowsFound);
+      if (!SortUtils::SortFromDataset(sortDescription, MediaTypeAlbum, m_pDS, results))
+        return false;
+
+      items.Reserve(results.size());
+      data = &m_pDS->get_result_set().records;
     }
-    
-    DatabaseResults results;
-    results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeAlbum, m_pDS, results))
-      return false;
 
     // get data from returned rows
-    items.Reserve(results.size());
-    const dbiplus::query_data &data = m_pDS->get_result_set().records;
-    for (DatabaseResults::const_iterator it = results.begin(); it != results.end(); it++)
+    int iRowsFound = 0;
+    DatabaseResults::const_iterator it = results.begin();
+    for (; data ? it != results.end() : !m_pDS->eof(); iRowsFound++)
     {
-      unsigned int targetRow = (unsigned int)it->at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
+      const dbiplus::sql_record* const record = data ? data->at((unsigned int)(it++)->at(FieldRow).asInteger()) : m_pDS->get_sql_record();
       
       try
       {
@@ -3200,6 +3214,17 @@ bool CMusicDatabase::GetAlbumsByWhere(const CStdString &baseDir, const Filter &f
         m_pDS->close();
         CLog::Log(LOGERROR, "%s - out of memory getting listing (got %i)", __FUNCTION__, items.Size());
       }
+
+      if (!data)
+        m_pDS->next();
+    }
+
+    if (streaming && iRowsFound > 0)
+    {
+      // store the total value of items as a property
+      if (total < iRowsFound)
+        total = iRowsFound;
+      items.SetProperty("total", total);
     }
 
     // cleanup
@@ -3256,35 +3281,42 @@ bool CMusicDatabase::GetSongsByWhere(const CStdString &baseDir, const Filter &fi
     strSQL = PrepareSQL(strSQL, !filter.fields.empty() && filter.fields.compare("*") != 0 ? filter.fields.c_str() : "songview.*") + strSQLExtra;
 
     CLog::Log(LOGDEBUG, "%s query = %s", __FUNCTION__, strSQL.c_str());
-    // run query
-    if (!m_pDS->query(strSQL.c_str()))
+    // run query, rows are used in the order they are read when there's
+    // nothing to sort so they can be stepped through instead of held
+    bool streaming = sortDescription.sortBy == SortByNone;
+    if (!(streaming ? m_pDS->query_stream(strSQL) : m_pDS->query(strSQL.c_str())))
       return false;
 
-    int iRowsFound = m_pDS->num_rows();
-    if (iRowsFound == 0)
+    DatabaseResults results;
+    const dbiplus::query_data *data = NULL;
+    if (!streaming)
     {
-      m_pDS->close();
-      return true;
-    }
+      int iRowsFound = m_pDS->num_rows();
+      if (iRowsFound == 0)
+      {
+        m_pDS->close();
+        return true;
+      }
 
-    // store the total value of items as a property
-    if (total < iRowsFound)
-      total = iRowsFound;
-    items.SetProperty("total", total);
-    
-    DatabaseResults results;
-    results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeSong, m_pDS, results))
-      return false;
+      // store the total value of items as a property
+      if (total < iRowsFound)
+        total = iRowsFound;
+      items.SetProperty("total", total);
+
+      results.reserve(iRowsFound);
+      if (!SortUtils::SortFromDataset(sortDescription, MediaTypeSong, m_pDS, results))
+        return false;
+
+      items.Reserve(results.size());
+      data = &m_pDS->get_result_set().records;
+    }
 
     // get data from returned rows
-    items.Reserve(results.size());
-    const dbiplus::query_data &data = m_pDS->get_result_set().records;
     int count = 0;
-    for (DatabaseResults::const_iterator it = results.begin(); it != results.end(); it++)
+    DatabaseResults::const_iterator it = results.begin();
+    for (; data ? it != results.end() : !m_pDS->eof(); )
     {
-      unsigned int targetRow = (unsigned int)it->at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
+      const dbiplus::sql_record* const record = data ? data->at((unsigned int)(it++)->at(FieldRow).asInteger()) : m_pDS->get_sql_record();
       
       try
       {
@@ -3300,6 +3332,17 @@ bool CMusicDatabase::GetSongsByWhere(const CStdString &baseDir, const Filter &fi
         CLog::Log(LOGERROR, "%s: out of memory loading query: %s", __FUNCTION__, filter.where.c_str());
         return (items.Size() > 0);
       }
+
+      if (!data)
+        m_pDS->next();
+    }
+
+    if (streaming && count > 0)
+    {
+      // store the total value of items as a property
+      if (total < count)
+        total = count;
+      items.SetProperty("total", total);
     }
 
     // cleanup
@@ -4313,6 +4356,8 @@ bool CMusicDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
   { // number of items in the db has likely changed, so reset the infomanager cache
+    if (InBatch()) // once the batch is committed
+      return true;
     g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSIC, GetSongsCount() > 0);
     return true;
   }
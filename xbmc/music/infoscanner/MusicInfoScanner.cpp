@@ -115,6 +115,9 @@ void CMusicInfoScanner::Process()
       m_bCanInterrupt = false;
       m_needsCleanup = false;
 
+      // commit the scan in groups of songs rather than folder by folder
+      m_musicDatabase.BeginBatch();
+
       bool commit = false;
       bool cancelled = false;
       while (!cancelled && m_pathsToScan.size())
@@ -131,6 +134,8 @@ void CMusicInfoScanner::Process()
         commit = !cancelled;
       }
 
+      m_musicDatabase.EndBatch();
+
       if (commit)
       {
         g_infoManager.ResetLibraryBools();
@@ -203,6 +208,7 @@ void CMusicInfoScanner::Process()
   catch (...)
   {
     CLog::Log(LOGERROR, "MusicInfoScanner: Exception while scanning.");
+    m_musicDatabase.EndBatch();
   }
 
   m_bRunning = false;
@@ -580,6 +586,7 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
     artistsToScan.insert(albumArtists.begin(), albumArtists.end());
   }
   m_musicDatabase.CommitTransaction();
+  m_musicDatabase.BatchItemDone(numAdded);
 
   // Download info & artwork
   bool bCanceled;
@@ -595,6 +602,8 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
         CStdString strPath;
         strPath.Format("musicdb://2/%u/", *it);
 
+        // don't keep the library locked while the scraper is online
+        m_musicDatabase.FlushBatch();
         if (!DownloadArtistInfo(strPath, strArtist, bCanceled)) // assume we want to retry
           m_artistsScanned.pop_back();
       }
@@ -622,6 +631,7 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
       if (find(m_albumsScanned.begin(), m_albumsScanned.end(), *it) == m_albumsScanned.end())
       {
         CMusicAlbumInfo albumInfo;
+        m_musicDatabase.FlushBatch();
         if (DownloadAlbumInfo(strPath, StringUtils::Join(album.artist, g_advancedSettings.m_musicItemSeparator), album.strAlbum, bCanceled, albumInfo))
           m_albumsScanned.push_back(*it);
       }
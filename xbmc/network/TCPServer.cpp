@@ -28,8 +28,10 @@
 #include "settings/AdvancedSettings.h"
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "interfaces/AnnouncementManager.h"
+#include "utils/JSONVariantWriter.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
+#include "threads/Atomics.h"
 #include "threads/SingleLock.h"
 #include "websocket/WebSocketManager.h"
 
@@ -55,6 +57,21 @@ using namespace ANNOUNCEMENT;
 //using namespace std; On VS2010, bind conflicts with std::bind
 
 #define RECEIVEBUFFER 1024
+#define SENDBUFFER    16384
+/* how long to wait for running requests when shutting down */
+#define REQUEST_WAIT  5000
+
+/* Requests run on job workers and can outlive the server that received
+   them, so they are given a transport that lives as long as the process */
+class CTCPTransport : public ITransportLayer
+{
+public:
+  virtual bool PrepareDownload(const char *path, CVariant &details, std::string &protocol) { return false; }
+  virtual bool Download(const char *path, CVariant &result) { return false; }
+  virtual int GetCapabilities() { return Response | Announcing; }
+};
+
+static CTCPTransport s_transport;
 
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
@@ -149,7 +166,7 @@ void CTCPServer::Process()
               {
                 // Replace the CTCPClient with a CWebSocketClient
                 CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(m_connections[i]));
-                delete m_connections[i];
+                m_connections[i]->Release();
                 m_connections.erase(m_connections.begin() + i);
                 m_connections.insert(m_connections.begin() + i, websocketClient);
               }
@@ -166,8 +183,9 @@ void CTCPServer::Process()
           if (close)
           {
             CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
+            m_connections[i]->CancelRequests();
             m_connections[i]->Disconnect();
-            delete m_connections[i];
+            m_connections[i]->Release();
             m_connections.erase(m_connections.begin() + i);
           }
         }
@@ -184,6 +202,7 @@ void CTCPServer::Process()
           if (newconnection->m_socket == INVALID_SOCKET)
           {
             CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: %d", errno);
+            newconnection->Release();
             if (EBADF == errno)
             {
               Sleep(1000);
@@ -206,17 +225,17 @@ void CTCPServer::Process()
 
 bool CTCPServer::PrepareDownload(const char *path, CVariant &details, std::string &protocol)
 {
-  return false;
+  return s_transport.PrepareDownload(path, details, protocol);
 }
 
 bool CTCPServer::Download(const char *path, CVariant &result)
 {
-  return false;
+  return s_transport.Download(path, result);
 }
 
 int CTCPServer::GetCapabilities()
 {
-  return Response | Announcing;
+  return s_transport.GetCapabilities();
 }
 
 void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
@@ -231,7 +250,7 @@ void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char
         continue;
     }
 
-    m_connections[i]->Send(str.c_str(), str.size());
+    m_connections[i]->Announce(str);
   }
 }
 
@@ -477,12 +496,27 @@ void CTCPServer::Deinitialize()
 {
   for (unsigned int i = 0; i < m_connections.size(); i++)
   {
+    m_connections[i]->CancelRequests();
     m_connections[i]->Disconnect();
-    delete m_connections[i];
+  }
+
+  for (unsigned int i = 0; i < m_connections.size(); i++)
+  {
+    // a request still running only holds on to its client, which is
+    // reference counted, and to s_transport
+    if (!m_connections[i]->WaitRequests(REQUEST_WAIT))
+      CLog::Log(LOGWARNING, "JSONRPC Server: Request still running on shutdown, it will be answered to a closed connection");
+    m_connections[i]->Release();
   }
 
   m_connections.clear();
 
+  CJSONRPCDispatcher::Stats stats = CJSONRPCDispatcher::GetStats();
+  if (stats.completed > 0)
+    CLog::Log(LOGDEBUG, "JSONRPC Server: %u requests answered, %u cancelled, average wait %u ms (max %u ms), average run %u ms",
+              stats.completed, stats.cancelled, (unsigned int)(stats.waitTime / stats.completed), stats.maxWait,
+              (unsigned int)(stats.runTime / stats.completed));
+
   for (unsigned int i = 0; i < m_servers.size(); i++)
     closesocket(m_servers[i]);
 
@@ -500,18 +534,22 @@ void CTCPServer::Deinitialize()
 CTCPServer::CTCPClient::CTCPClient()
 {
   m_new = true;
+  m_responding = false;
   m_announcementflags = ANNOUNCE_ALL;
   m_socket = INVALID_SOCKET;
   m_beginBrackets = 0;
   m_endBrackets = 0;
   m_beginChar = 0;
   m_endChar = 0;
+  m_references = 1;
 
   m_addrlen = sizeof(m_cliaddr);
 }
 
 CTCPServer::CTCPClient::CTCPClient(const CTCPClient& client)
 {
+  m_references = 1;
+  m_responding = false;
   Copy(client);
 }
 
@@ -533,17 +571,85 @@ int CTCPServer::CTCPClient::GetAnnouncementFlags()
 
 bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
 {
+  CSingleLock lock (m_critSection);
   m_announcementflags = flags;
   return true;
 }
 
+void CTCPServer::CTCPClient::Acquire()
+{
+  AtomicIncrement(&m_references);
+}
+
+void CTCPServer::CTCPClient::Release()
+{
+  if (AtomicDecrement(&m_references) == 0)
+    delete this;
+}
+
+void CTCPServer::CTCPClient::Respond(const CVariant &response)
+{
+  // send the response while it is serialized, a client's requests are
+  // answered one at a time so only announcements can get in between
+  BeginResponse();
+  CJSONVariantStreamWriter writer(response, g_advancedSettings.m_jsonOutputCompact);
+  char buffer[SENDBUFFER];
+  int size;
+  while ((size = writer.Read(buffer, sizeof(buffer))) > 0)
+    Send(buffer, size);
+  EndResponse();
+}
+
+void CTCPServer::CTCPClient::Announce(const std::string &announcement)
+{
+  // held for the send, so a response can't start in the middle of it
+  CSingleLock lock (m_critSection);
+  if (m_responding)
+    m_announcements.push_back(announcement);
+  else
+    Send(announcement.c_str(), announcement.size());
+}
+
+void CTCPServer::CTCPClient::BeginResponse()
+{
+  CSingleLock lock (m_critSection);
+  m_responding = true;
+}
+
+void CTCPServer::CTCPClient::EndResponse()
+{
+  // announcements made while these are sent are queued behind them
+  while (true)
+  {
+    std::vector<std::string> announcements;
+    {
+      CSingleLock lock (m_critSection);
+      if (m_announcements.empty())
+      {
+        m_responding = false;
+        return;
+      }
+      announcements.swap(m_announcements);
+    }
+
+    for (unsigned int i = 0; i < announcements.size(); i++)
+      Send(announcements[i].c_str(), announcements[i].size());
+  }
+}
+
 void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
 {
   unsigned int sent = 0;
   do
   {
     CSingleLock lock (m_critSection);
-    sent += send(m_socket, data, size - sent, 0);
+    // a response may be finished after the connection was dropped
+    if (m_socket == INVALID_SOCKET)
+      return;
+    int res = send(m_socket, data + sent, size - sent, 0);
+    if (res < 0)
+      return;
+    sent += res;
   } while (sent < size);
 }
 
@@ -575,8 +681,7 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
         m_endBrackets++;
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        Send(line.c_str(), line.size());
+        m_dispatcher.Dispatch(m_buffer, &s_transport, this);
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
       }
@@ -640,6 +745,15 @@ CTCPServer::CWebSocketClient& CTCPServer::CWebSocketClient::operator=(const CWeb
   return *this;
 }
 
+void CTCPServer::CWebSocketClient::Respond(const CVariant &response)
+{
+  // a message is framed with its length, so it has to be serialized first
+  std::string str = CJSONVariantWriter::Write(response, g_advancedSettings.m_jsonOutputCompact);
+  BeginResponse();
+  Send(str.c_str(), str.size());
+  EndResponse();
+}
+
 void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
 {
   const CWebSocketMessage *msg = m_websocket->Send(WebSocketTextFrame, data, size);
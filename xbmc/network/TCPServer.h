@@ -22,9 +22,9 @@
 #include <vector>
 #include <sys/socket.h>
 
-#include "interfaces/json-rpc/IClient.h"
 #include "interfaces/json-rpc/IJSONRPCAnnouncer.h"
 #include "interfaces/json-rpc/ITransportLayer.h"
+#include "interfaces/json-rpc/JSONRPCDispatcher.h"
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
 #include "websocket/WebSocket.h"
@@ -51,7 +51,7 @@ namespace JSONRPC
     bool InitializeTCP();
     void Deinitialize();
 
-    class CTCPClient : public IClient
+    class CTCPClient : public IAsyncClient
     {
     public:
       CTCPClient();
@@ -65,10 +65,22 @@ namespace JSONRPC
       virtual int  GetAnnouncementFlags();
       virtual bool SetAnnouncementFlags(int flags);
 
+      // requests are answered on job workers which keep a reference, release instead of deleting
+      virtual void Acquire();
+      virtual void Release();
+      virtual void Respond(const CVariant &response);
+
       virtual void Send(const char *data, unsigned int size);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
+      /*! \brief Sends an announcement, or queues it until the response being sent is done */
+      void Announce(const std::string &announcement);
+
+      /*! \brief Drops the connection's pending requests, for when it goes away */
+      void CancelRequests()                { m_dispatcher.Cancel(); }
+      bool WaitRequests(unsigned int timeout) { return m_dispatcher.WaitIdle(timeout); }
+
       virtual bool IsNew() const { return m_new; }
       virtual bool Closing() const { return false; }
 
@@ -79,12 +91,21 @@ namespace JSONRPC
 
     protected:
       void Copy(const CTCPClient& client);
+
+      /*! \brief Marks a response as being sent, announcements are queued meanwhile */
+      void BeginResponse();
+      /*! \brief Sends the queued announcements and clears the mark */
+      void EndResponse();
     private:
       bool m_new;
+      bool m_responding;
+      std::vector<std::string> m_announcements;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
       char m_beginChar, m_endChar;
       std::string m_buffer;
+      long m_references;
+      CJSONRPCDispatcher m_dispatcher;
     };
 
     class CWebSocketClient : public CTCPClient
@@ -96,6 +117,7 @@ namespace JSONRPC
       CWebSocketClient& operator=(const CWebSocketClient& client);
       ~CWebSocketClient();
 
+      virtual void Respond(const CVariant &response);
       virtual void Send(const char *data, unsigned int size);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
@@ -21,21 +21,44 @@
 #include "WebServer.h"
 #ifdef HAS_WEB_SERVER
 #include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "TextureCache.h"
+#include "utils/HttpRangeUtils.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "utils/Base64.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "XBDateTime.h"
 #include "URL.h"
 
+#ifdef TARGET_POSIX
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #ifdef _WIN32
 #pragma comment(lib, "libmicrohttpd.dll.lib")
 #endif
 
+#if defined(TARGET_POSIX) && (MHD_VERSION >= 0x00091300)
+#define HAS_MHD_FD_RESPONSE
+#endif
+
+#if defined(TARGET_LINUX) && (MHD_VERSION >= 0x00093100)
+#define HAS_MHD_EPOLL
+#endif
+
 #define MAX_POST_BUFFER_SIZE 2048
 
+// cached thumbnails up to this size are kept in memory
+#define IMAGE_CACHE_MAXFILE  (256 * 1024)
+#define IMAGE_CACHE_ENTRIES  64
+
 #define PAGE_FILE_NOT_FOUND "<html><head><title>File not found</title></head><body>File not found</body></html>"
 #define NOT_SUPPORTED       "<html><head><title>Not Supported</title></head><body>The method you are trying to use is not supported by this server</body></html>"
 
@@ -44,6 +67,10 @@ using namespace std;
 using namespace JSONRPC;
 
 vector<IHTTPRequestHandler *> CWebServer::m_requestHandlers;
+CCriticalSection CWebServer::m_imageCacheSection;
+CCriticalSection CWebServer::m_statsSection;
+map<string, CWebServer::HandlerStats> CWebServer::m_stats;
+CLRUMap<string, CWebServer::CachedImage> CWebServer::m_imageCache(IMAGE_CACHE_ENTRIES);
 
 CWebServer::CWebServer()
 {
@@ -244,6 +271,7 @@ int CWebServer::AnswerToConnection(void *cls, struct MHD_Connection *connection,
     }
   }
 
+  UpdateStats("unhandled", MHD_HTTP_NOT_FOUND, 0);
   return SendErrorResponse(connection, MHD_HTTP_NOT_FOUND, methodType);
 }
 
@@ -269,6 +297,44 @@ int CWebServer::HandlePostField(void *cls, enum MHD_ValueKind kind, const char *
 }
 
 int CWebServer::HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &request)
+{
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  // the name is a literal, it stays valid after the handler is deleted
+  const char *name = handler != NULL ? handler->GetName() : "other";
+  int responseCode = MHD_HTTP_INTERNAL_SERVER_ERROR;
+
+  int ret = SendResponse(handler, request, responseCode);
+
+  UpdateStats(name, responseCode, XbmcThreads::SystemClockMillis() - start);
+  return ret;
+}
+
+void CWebServer::UpdateStats(const char *name, int responseCode, unsigned int time)
+{
+  CSingleLock lock(m_statsSection);
+  map<string, HandlerStats>::iterator it = m_stats.find(name);
+  if (it == m_stats.end())
+  {
+    HandlerStats stats = { 0, 0, 0, 0 };
+    it = m_stats.insert(make_pair(string(name), stats)).first;
+  }
+
+  HandlerStats &stats = it->second;
+  stats.requests++;
+  if (responseCode >= 400)
+    stats.errors++;
+  stats.time += time;
+  if (time > stats.maxTime)
+    stats.maxTime = time;
+}
+
+map<string, CWebServer::HandlerStats> CWebServer::GetStats()
+{
+  CSingleLock lock(m_statsSection);
+  return m_stats;
+}
+
+int CWebServer::SendResponse(IHTTPRequestHandler *handler, const HTTPRequest &request, int &responseCode)
 {
   if (handler == NULL)
     return SendErrorResponse(request.connection, MHD_HTTP_INTERNAL_SERVER_ERROR, request.method);
@@ -281,7 +347,7 @@ int CWebServer::HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &r
   }
 
   struct MHD_Response *response = NULL;
-  int responseCode = handler->GetHTTPResonseCode();
+  responseCode = handler->GetHTTPResonseCode();
   switch (handler->GetHTTPResponseType())
   {
     case HTTPNone:
@@ -312,18 +378,24 @@ int CWebServer::HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &r
       ret = CreateMemoryDownloadResponse(request.connection, handler->GetHTTPResponseData(), handler->GetHTTPResonseDataLength(), true, true, response);
       break;
 
+    case HTTPStreamDownload:
+      ret = CreateStreamDownloadResponse(request.connection, handler->GetHTTPResponseStream(), response);
+      break;
+
     case HTTPError:
       ret = CreateErrorResponse(request.connection, handler->GetHTTPResonseCode(), request.method, response);
       break;
 
     default:
       delete handler;
+      responseCode = MHD_HTTP_INTERNAL_SERVER_ERROR;
       return SendErrorResponse(request.connection, MHD_HTTP_INTERNAL_SERVER_ERROR, request.method);
   }
 
   if (ret == MHD_NO)
   {
     delete handler;
+    responseCode = MHD_HTTP_INTERNAL_SERVER_ERROR;
     return SendErrorResponse(request.connection, MHD_HTTP_INTERNAL_SERVER_ERROR, request.method);
   }
 
@@ -366,110 +438,200 @@ int CWebServer::CreateRedirect(struct MHD_Connection *connection, const string &
   return MHD_NO;
 }
 
+bool CWebServer::GetCachedImage(const string &path, const struct __stat64 &status, boost::shared_ptr<string> &data)
+{
+  CSingleLock lock(m_imageCacheSection);
+  CachedImage image;
+  if (m_imageCache.Get(path, image) && image.mtime == (int64_t)status.st_mtime &&
+      (int64_t)image.data->size() == (int64_t)status.st_size)
+  {
+    data = image.data;
+    return true;
+  }
+  lock.Leave();
+
+  CFile file;
+  if (!file.Open(path, READ_NO_CACHE))
+    return false;
+
+  boost::shared_ptr<string> buffer(new string());
+  buffer->resize((size_t)status.st_size);
+  if (!buffer->empty() && file.Read(&(*buffer)[0], buffer->size()) != buffer->size())
+    return false;
+
+  image.mtime = status.st_mtime;
+  image.data = buffer;
+
+  lock.Enter();
+  m_imageCache.Set(path, image);
+  data = buffer;
+  return true;
+}
+
 int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, const string &strURL, HTTPMethod methodType, struct MHD_Response *&response, int &responseCode)
 {
-  CFile *file = new CFile();
+  // image:// urls are served straight from the texture cache
+  CStdString path = strURL;
+  bool isImage = path.Left(8).Equals("image://");
+  if (isImage)
+  {
+    bool needsRecaching = false;
+    path = CTextureCache::Get().CheckCachedImage(strURL, false, needsRecaching);
+    if (path.IsEmpty())
+      path = CTextureCache::Get().CacheImage(strURL);
+  }
 
-  if (file->Open(strURL, READ_NO_CACHE))
+  struct __stat64 status;
+  if (path.IsEmpty() || CFile::Stat(path, &status) != 0 || (status.st_mode & S_IFDIR))
   {
-    bool getData = true;
-    if (methodType != HEAD)
-    {
-      if (methodType == GET)
-      {
-        string ifModifiedSince = GetRequestHeaderValue(connection, MHD_HEADER_KIND, "If-Modified-Since");
-        if (!ifModifiedSince.empty())
-        {
-          CDateTime ifModifiedSinceDate;
-          ifModifiedSinceDate.SetFromRFC1123DateTime(ifModifiedSince);
+    CLog::Log(LOGERROR, "WebServer: Failed to open %s", strURL.c_str());
+    responseCode = MHD_HTTP_NOT_FOUND;
+    return CreateErrorResponse(connection, MHD_HTTP_NOT_FOUND, methodType, response);
+  }
 
-          struct __stat64 statBuffer;
-          if (file->Stat(&statBuffer) == 0)
-          {
-            struct tm *time = localtime((time_t *)&statBuffer.st_mtime);
-            if (time != NULL)
-            {
-              CDateTime lastModified = *time;
-              if (lastModified.GetAsUTCDateTime() <= ifModifiedSinceDate)
-              {
-                getData = false;
-                response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
-                responseCode = MHD_HTTP_NOT_MODIFIED;
-              }
-            }
-          }
-        }
-      }
+  int64_t size = status.st_size;
+  CStdString lastModified;
+  struct tm *time = localtime((time_t *)&status.st_mtime);
+  if (time != NULL)
+    lastModified = CDateTime(*time).GetAsRFC1123DateTime();
+  CStdString etag;
+  etag.Format("\"%llx-%llx\"", (unsigned long long)status.st_mtime, (unsigned long long)size);
 
-      if (getData)
-        response = MHD_create_response_from_callback(file->GetLength(),
-                                                     2048,
-                                                     &CWebServer::ContentReaderCallback, file,
-                                                     &CWebServer::ContentReaderFreeCallback);
-      if (response == NULL)
-      {
-        file->Close();
-        delete file;
-        return MHD_NO;
-      }
+  bool notModified = false;
+  if (methodType == GET || methodType == HEAD)
+  {
+    string ifNoneMatch = GetRequestHeaderValue(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_NONE_MATCH);
+    string ifModifiedSince = GetRequestHeaderValue(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_MODIFIED_SINCE);
+    if (!ifNoneMatch.empty())
+      notModified = ifNoneMatch == "*" || ifNoneMatch.find(etag) != string::npos;
+    else if (!ifModifiedSince.empty() && time != NULL)
+    {
+      CDateTime ifModifiedSinceDate;
+      ifModifiedSinceDate.SetFromRFC1123DateTime(ifModifiedSince);
+      notModified = CDateTime(*time).GetAsUTCDateTime() <= ifModifiedSinceDate;
     }
-    else
+  }
+
+  // work out which part of the file was asked for
+  int64_t start = 0, end = size - 1;
+  int rangeResult = 0;
+  string range = GetRequestHeaderValue(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_RANGE);
+  if (methodType == GET && !notModified && !range.empty())
+  {
+    // a range of a file that has changed since makes no sense
+    string ifRange = GetRequestHeaderValue(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_RANGE);
+    if (ifRange.empty() || ifRange == etag || ifRange == lastModified)
+      rangeResult = HttpRangeUtils::ParseRange(range, size, start, end);
+    if (rangeResult == 0)
     {
-      getData = false;
+      start = 0;
+      end = size - 1;
+    }
+  }
+  int64_t length = end - start + 1;
 
-      CStdString contentLength;
-      contentLength.Format("%I64d", file->GetLength());
+  CStdString contentRange;
+  if (notModified)
+    responseCode = MHD_HTTP_NOT_MODIFIED;
+  else if (rangeResult < 0)
+  {
+    responseCode = MHD_HTTP_REQUESTED_RANGE_NOT_SATISFIABLE;
+    contentRange.Format("bytes */%lld", (long long)size);
+  }
+  else if (rangeResult > 0)
+  {
+    responseCode = MHD_HTTP_PARTIAL_CONTENT;
+    contentRange.Format("bytes %lld-%lld/%lld", (long long)start, (long long)end, (long long)size);
+  }
 
-      response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
-      if (response == NULL)
-      {
-        file->Close();
-        delete file;
-        return MHD_NO;
-      }
+  if (methodType == HEAD || notModified || rangeResult < 0)
+  {
+    response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
+    if (response == NULL)
+      return MHD_NO;
+
+    if (methodType == HEAD && !notModified)
+    {
+      CStdString contentLength;
+      contentLength.Format("%lld", (long long)size);
       MHD_add_response_header(response, "Content-Length", contentLength);
     }
-
-    // set the Content-Type header
-    CStdString ext = URIUtils::GetExtension(strURL);
-    ext = ext.ToLower();
-    const char *mime = CreateMimeTypeFromExtension(ext.c_str());
-    if (mime)
-      MHD_add_response_header(response, "Content-Type", mime);
-
-    // set the Last-Modified header
-    struct __stat64 statBuffer;
-    if (file->Stat(&statBuffer) == 0)
+  }
+  else
+  {
+    // small cached thumbnails are kept in memory, they're asked for over and over
+    boost::shared_ptr<string> data;
+    if (isImage && size <= IMAGE_CACHE_MAXFILE && GetCachedImage(path, status, data))
+      response = MHD_create_response_from_data((size_t)length, (void *)(data->c_str() + start), MHD_NO, MHD_YES);
+
+#ifdef HAS_MHD_FD_RESPONSE
+    // local files are handed to MHD, which sends them with sendfile()
+    if (response == NULL && URIUtils::IsHD(path) && !URIUtils::IsInArchive(path) && !URIUtils::IsStack(path))
     {
-      struct tm *time = localtime((time_t *)&statBuffer.st_mtime);
-      if (time != NULL)
+      CStdString localPath = CSpecialProtocol::TranslatePath(path);
+      struct stat fileStatus;
+      int fd = CURL(localPath).GetProtocol().IsEmpty() ? open(localPath.c_str(), O_RDONLY) : -1;
+      if (fd >= 0)
       {
-        CDateTime lastModified = *time;
-        MHD_add_response_header(response, "Last-Modified", lastModified.GetAsRFC1123DateTime());
+        // the file may have been replaced since it was stat'ed
+        if (fstat(fd, &fileStatus) == 0 && fileStatus.st_size == size)
+          response = MHD_create_response_from_fd_at_offset(length, fd, start);
+        if (response == NULL)
+          close(fd);
       }
     }
+#endif
 
-    // set the Expires header
-    CDateTime expiryTime = CDateTime::GetCurrentDateTime();
-    if (mime && strncmp(mime, "text/html", 9) == 0)
-      expiryTime += CDateTimeSpan(1, 0, 0, 0);
-    else
-      expiryTime += CDateTimeSpan(365, 0, 0, 0);
-    MHD_add_response_header(response, "Expires", expiryTime.GetAsRFC1123DateTime());
-
-    // only close the CFile instance if libmicrohttpd doesn't have to grab the data of the file
-    if (!getData)
+    if (response == NULL)
     {
-      file->Close();
-      delete file;
+      CFile *file = new CFile();
+      if (!file->Open(path, READ_NO_CACHE))
+      {
+        delete file;
+        CLog::Log(LOGERROR, "WebServer: Failed to open %s", strURL.c_str());
+        responseCode = MHD_HTTP_NOT_FOUND;
+        return CreateErrorResponse(connection, MHD_HTTP_NOT_FOUND, methodType, response);
+      }
+
+      FileDownload *download = new FileDownload();
+      download->file = file;
+      download->offset = start;
+      download->length = length;
+      response = MHD_create_response_from_callback(length,
+                                                   32 * 1024,
+                                                   &CWebServer::ContentReaderCallback, download,
+                                                   &CWebServer::ContentReaderFreeCallback);
+      if (response == NULL)
+      {
+        ContentReaderFreeCallback(download);
+        return MHD_NO;
+      }
     }
   }
+
+  // set the Content-Type header
+  CStdString ext = URIUtils::GetExtension(path);
+  ext = ext.ToLower();
+  const char *mime = CreateMimeTypeFromExtension(ext.c_str());
+  if (mime)
+    MHD_add_response_header(response, "Content-Type", mime);
+
+  // headers that let clients keep and revalidate their copy
+  if (!lastModified.IsEmpty())
+    MHD_add_response_header(response, "Last-Modified", lastModified);
+  MHD_add_response_header(response, MHD_HTTP_HEADER_ETAG, etag);
+  MHD_add_response_header(response, MHD_HTTP_HEADER_ACCEPT_RANGES, "bytes");
+  if (!contentRange.IsEmpty())
+    MHD_add_response_header(response, MHD_HTTP_HEADER_CONTENT_RANGE, contentRange);
+
+  // set the Expires header
+  CDateTime expiryTime = CDateTime::GetCurrentDateTime();
+  if (mime && strncmp(mime, "text/html", 9) == 0)
+    expiryTime += CDateTimeSpan(1, 0, 0, 0);
   else
-  {
-    delete file;
-    CLog::Log(LOGERROR, "WebServer: Failed to open %s", strURL.c_str());
-    return SendErrorResponse(connection, MHD_HTTP_NOT_FOUND, GET); /* GET Assumed Temporarily */
-  }
+    expiryTime += CDateTimeSpan(365, 0, 0, 0);
+  MHD_add_response_header(response, "Expires", expiryTime.GetAsRFC1123DateTime());
+
   return MHD_YES;
 }
 
@@ -507,6 +669,23 @@ int CWebServer::CreateMemoryDownloadResponse(struct MHD_Connection *connection,
   return MHD_NO;
 }
 
+int CWebServer::CreateStreamDownloadResponse(struct MHD_Connection *connection, IHTTPResponseStream *stream, struct MHD_Response *&response)
+{
+  if (stream == NULL)
+    return MHD_NO;
+
+  // unknown size, so MHD sends it chunked
+  response = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN,
+                                               16 * 1024,
+                                               &CWebServer::StreamReaderCallback, stream,
+                                               &CWebServer::StreamReaderFreeCallback);
+  if (response)
+    return MHD_YES;
+
+  delete stream;
+  return MHD_NO;
+}
+
 int CWebServer::SendErrorResponse(struct MHD_Connection *connection, int errorType, HTTPMethod method)
 {
   struct MHD_Response *response = NULL;
@@ -534,10 +713,14 @@ int CWebServer::ContentReaderCallback(void *cls, uint64_t pos, char *buf, int ma
 int CWebServer::ContentReaderCallback(void *cls, size_t pos, char *buf, int max)
 #endif
 {
-  CFile *file = (CFile *)cls;
-  if((unsigned int)pos != file->GetPosition())
-    file->Seek(pos);
-  unsigned res = file->Read(buf, max);
+  FileDownload *download = (FileDownload *)cls;
+  if ((int64_t)pos >= download->length)
+    return -1;
+
+  int64_t position = download->offset + pos;
+  if (position != download->file->GetPosition())
+    download->file->Seek(position);
+  unsigned res = download->file->Read(buf, (unsigned int)min((int64_t)max, download->length - (int64_t)pos));
   if(res == 0)
     return -1;
   return res;
@@ -545,10 +728,37 @@ int CWebServer::ContentReaderCallback(void *cls, size_t pos, char *buf, int max)
 
 void CWebServer::ContentReaderFreeCallback(void *cls)
 {
-  CFile *file = (CFile *)cls;
-  file->Close();
+  FileDownload *download = (FileDownload *)cls;
+  download->file->Close();
 
-  delete file;
+  delete download->file;
+  delete download;
+}
+
+#if (MHD_VERSION >= 0x00090200)
+ssize_t CWebServer::StreamReaderCallback (void *cls, uint64_t pos, char *buf, size_t max)
+#elif (MHD_VERSION >= 0x00040001)
+int CWebServer::StreamReaderCallback(void *cls, uint64_t pos, char *buf, int max)
+#else   //libmicrohttpd < 0.4.0
+int CWebServer::StreamReaderCallback(void *cls, size_t pos, char *buf, int max)
+#endif
+{
+  IHTTPResponseStream *stream = (IHTTPResponseStream *)cls;
+  int res = stream->Read(buf, max);
+  if (res > 0)
+    return res;
+
+  // returning 0 would make MHD call us again
+#ifdef MHD_CONTENT_READER_END_OF_STREAM
+  return res == 0 ? MHD_CONTENT_READER_END_OF_STREAM : MHD_CONTENT_READER_END_WITH_ERROR;
+#else
+  return -1;
+#endif
+}
+
+void CWebServer::StreamReaderFreeCallback(void *cls)
+{
+  delete (IHTTPResponseStream *)cls;
 }
 
 struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
@@ -567,9 +777,9 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
                           &CWebServer::AnswerToConnection,
                           this,
 #if (MHD_VERSION >= 0x00040002)
-                          MHD_OPTION_THREAD_POOL_SIZE, 4,
+                          MHD_OPTION_THREAD_POOL_SIZE, g_advancedSettings.m_webServerThreads,
 #endif
-                          MHD_OPTION_CONNECTION_LIMIT, 512,
+                          MHD_OPTION_CONNECTION_LIMIT, g_advancedSettings.m_webServerConnectionLimit,
                           MHD_OPTION_CONNECTION_TIMEOUT, timeout,
                           MHD_OPTION_URI_LOG_CALLBACK, &CWebServer::UriRequestLogger, this,
                           MHD_OPTION_END);
@@ -580,11 +790,24 @@ bool CWebServer::Start(int port, const string &username, const string &password)
   SetCredentials(username, password);
   if (!m_running)
   {
-    m_daemon = StartMHD(MHD_USE_SELECT_INTERNALLY, port);
+    unsigned int flags = MHD_USE_SELECT_INTERNALLY;
+    const char *polling = "select";
+    if (g_advancedSettings.m_webServerEpoll)
+    {
+#ifdef HAS_MHD_EPOLL
+      flags |= MHD_USE_EPOLL_LINUX_ONLY;
+      polling = "epoll";
+#else
+      CLog::Log(LOGWARNING, "WebServer: epoll isn't supported by this libmicrohttpd, using select");
+#endif
+    }
+
+    m_daemon = StartMHD(flags, port);
 
     m_running = m_daemon != NULL;
     if (m_running)
-      CLog::Log(LOGNOTICE, "WebServer: Started the webserver");
+      CLog::Log(LOGNOTICE, "WebServer: Started the webserver (%s, %u threads, %u connections)",
+                polling, g_advancedSettings.m_webServerThreads, g_advancedSettings.m_webServerConnectionLimit);
     else
       CLog::Log(LOGERROR, "WebServer: Failed to start the webserver");
   }
@@ -598,6 +821,12 @@ bool CWebServer::Stop()
     MHD_stop_daemon(m_daemon);
     m_running = false;
     CLog::Log(LOGNOTICE, "WebServer: Stopped the webserver");
+
+    map<string, HandlerStats> stats = GetStats();
+    for (map<string, HandlerStats>::const_iterator it = stats.begin(); it != stats.end(); ++it)
+      CLog::Log(LOGNOTICE, "WebServer: %s: %u requests, %u errors, %.1f ms average, %u ms max",
+                it->first.c_str(), it->second.requests, it->second.errors,
+                it->second.requests ? (double)it->second.time / it->second.requests : 0.0, it->second.maxTime);
   } else 
     CLog::Log(LOGNOTICE, "WebServer: Stopped failed because its not running");
 
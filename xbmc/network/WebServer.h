@@ -28,10 +28,18 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <map>
 #include <vector>
+#include <boost/shared_ptr.hpp>
 #include "interfaces/json-rpc/ITransportLayer.h"
 #include "threads/CriticalSection.h"
 #include "httprequesthandler/IHTTPRequestHandler.h"
+#include "utils/LRUMap.h"
+
+namespace XFILE
+{
+  class CFile;
+}
 
 class CWebServer : public JSONRPC::ITransportLayer
 {
@@ -54,6 +62,19 @@ public:
   static std::string GetRequestHeaderValue(struct MHD_Connection *connection, enum MHD_ValueKind kind, const std::string &key);
   static int GetRequestHeaderValues(struct MHD_Connection *connection, enum MHD_ValueKind kind, std::map<std::string, std::string> &headerValues);
   static int GetRequestHeaderValues(struct MHD_Connection *connection, enum MHD_ValueKind kind, std::multimap<std::string, std::string> &headerValues);
+
+  struct HandlerStats
+  {
+    unsigned int requests;
+    unsigned int errors;  ///< requests answered with a 4xx or 5xx status
+    uint64_t     time;    ///< total ms spent answering, sending the body isn't included
+    unsigned int maxTime; ///< longest ms spent answering a request
+  };
+
+  /*!
+   \brief Counters per request handler, since startup
+   */
+  static std::map<std::string, HandlerStats> GetStats();
 private:
   struct MHD_Daemon* StartMHD(unsigned int flags, int port);
   static int AskForAuthentication (struct MHD_Connection *connection);
@@ -63,10 +84,13 @@ private:
 
 #if (MHD_VERSION >= 0x00090200)
   static ssize_t ContentReaderCallback (void *cls, uint64_t pos, char *buf, size_t max);
+  static ssize_t StreamReaderCallback (void *cls, uint64_t pos, char *buf, size_t max);
 #elif (MHD_VERSION >= 0x00040001)
   static int ContentReaderCallback (void *cls, uint64_t pos, char *buf, int max);
+  static int StreamReaderCallback (void *cls, uint64_t pos, char *buf, int max);
 #else
   static int ContentReaderCallback (void *cls, size_t pos, char *buf, int max);
+  static int StreamReaderCallback (void *cls, size_t pos, char *buf, int max);
 #endif
 
 #if (MHD_VERSION >= 0x00040001)
@@ -89,11 +113,16 @@ private:
                              unsigned int size);
 #endif
   static int HandleRequest(IHTTPRequestHandler *handler, const HTTPRequest &request);
+  static int SendResponse(IHTTPRequestHandler *handler, const HTTPRequest &request, int &responseCode);
+  static void UpdateStats(const char *name, int responseCode, unsigned int time);
   static void ContentReaderFreeCallback (void *cls);
+  static void StreamReaderFreeCallback (void *cls);
   static int CreateRedirect(struct MHD_Connection *connection, const std::string &strURL, struct MHD_Response *&response);
+  static bool GetCachedImage(const std::string &path, const struct __stat64 &status, boost::shared_ptr<std::string> &data);
   static int CreateFileDownloadResponse(struct MHD_Connection *connection, const std::string &strURL, HTTPMethod methodType, struct MHD_Response *&response, int &responseCode);
   static int CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response);
   static int CreateMemoryDownloadResponse(struct MHD_Connection *connection, void *data, size_t size, bool free, bool copy, struct MHD_Response *&response);
+  static int CreateStreamDownloadResponse(struct MHD_Connection *connection, IHTTPResponseStream *stream, struct MHD_Response *&response);
 
   static int SendErrorResponse(struct MHD_Connection *connection, int errorType, HTTPMethod method);
   
@@ -109,6 +138,25 @@ private:
   CCriticalSection m_critSection;
   static std::vector<IHTTPRequestHandler *> m_requestHandlers;
 
+  typedef struct CachedImage
+  {
+    int64_t                           mtime;
+    boost::shared_ptr<std::string>    data;
+  } CachedImage;
+
+  static CCriticalSection                       m_imageCacheSection;
+  static CLRUMap<std::string, CachedImage>      m_imageCache;
+
+  static CCriticalSection                       m_statsSection;
+  static std::map<std::string, HandlerStats>    m_stats;
+
+  typedef struct FileDownload
+  {
+    XFILE::CFile *file;
+    int64_t       offset; ///< where the requested range starts in the file
+    int64_t       length;
+  } FileDownload;
+
   typedef struct ConnectionHandler
   {
     IHTTPRequestHandler *requestHandler;
@@ -23,6 +23,7 @@
 #include "interfaces/json-rpc/JSONServiceDescription.h"
 #include "interfaces/json-rpc/JSONUtils.h"
 #include "network/WebServer.h"
+#include "settings/AdvancedSettings.h"
 #include "utils/JSONVariantWriter.h"
 #include "utils/log.h"
 
@@ -31,6 +32,25 @@
 using namespace std;
 using namespace JSONRPC;
 
+/* owns a response while it is serialized and sent */
+class CJsonRpcResponseStream : public IHTTPResponseStream
+{
+public:
+  CJsonRpcResponseStream(CVariant &response, bool compact)
+  {
+    m_response.swap(response);
+    m_writer = new CJSONVariantStreamWriter(m_response, compact);
+  }
+
+  virtual ~CJsonRpcResponseStream() { delete m_writer; }
+
+  virtual int Read(char *buffer, size_t size) { return m_writer->Read(buffer, size); }
+
+private:
+  CVariant                  m_response;
+  CJSONVariantStreamWriter *m_writer;
+};
+
 bool CHTTPJsonRpcHandler::CheckHTTPRequest(const HTTPRequest &request)
 {
   return (request.url.compare("/jsonrpc") == 0);
@@ -67,26 +87,42 @@ int CHTTPJsonRpcHandler::HandleHTTPRequest(const HTTPRequest &request)
     }
   }
 
+  bool compact = g_advancedSettings.m_jsonOutputCompact;
+  bool hasResponse = true;
   if (isRequest)
-    m_response = CJSONRPC::MethodCall(m_request, request.webserver, &client);
+    hasResponse = CJSONRPC::MethodCall(m_request, request.webserver, &client, m_responseValue);
   else
   {
     // get the whole output of JSONRPC.Introspect
-    CVariant result;
-    CJSONServiceDescription::Print(result, request.webserver, &client);
-    m_response = CJSONVariantWriter::Write(result, false);
+    CJSONServiceDescription::Print(m_responseValue, request.webserver, &client);
+    compact = false;
   }
 
   m_responseHeaderFields.insert(pair<string, string>("Content-Type", "application/json"));
 
   m_request.clear();
-  
-  m_responseType = HTTPMemoryDownloadNoFreeCopy;
+
+  // large responses go out while they are serialized, sent chunked
+  if (hasResponse)
+  {
+    m_responseCompact = compact;
+    m_responseType = HTTPStreamDownload;
+  }
+  else
+    m_responseType = HTTPMemoryDownloadNoFreeCopy;
   m_responseCode = MHD_HTTP_OK;
 
   return MHD_YES;
 }
 
+IHTTPResponseStream* CHTTPJsonRpcHandler::GetHTTPResponseStream()
+{
+  if (m_responseType != HTTPStreamDownload)
+    return NULL;
+
+  return new CJsonRpcResponseStream(m_responseValue, m_responseCompact);
+}
+
 #if (MHD_VERSION >= 0x00040001)
 bool CHTTPJsonRpcHandler::appendPostData(const char *data, size_t size)
 #else
@@ -21,11 +21,12 @@
 
 #include "IHTTPRequestHandler.h"
 #include "interfaces/json-rpc/IClient.h"
+#include "utils/Variant.h"
 
 class CHTTPJsonRpcHandler : public IHTTPRequestHandler
 {
 public:
-  CHTTPJsonRpcHandler() { };
+  CHTTPJsonRpcHandler() : m_responseCompact(false) { };
   
   virtual IHTTPRequestHandler* GetInstance() { return new CHTTPJsonRpcHandler(); }
   virtual bool CheckHTTPRequest(const HTTPRequest &request);
@@ -33,8 +34,10 @@ public:
 
   virtual void* GetHTTPResponseData() const { return (void *)m_response.c_str(); };
   virtual size_t GetHTTPResonseDataLength() const { return m_response.size(); }
+  virtual IHTTPResponseStream* GetHTTPResponseStream();
 
   virtual int GetPriority() const { return 2; }
+  virtual const char* GetName() const { return "jsonrpc"; }
 
 protected:
 #if (MHD_VERSION >= 0x00040001)
@@ -46,6 +49,8 @@ protected:
 private:
   std::string m_request;
   std::string m_response;
+  CVariant    m_responseValue; ///< serialized while it is sent
+  bool        m_responseCompact;
 
   class CHTTPClient : public JSONRPC::IClient
   {
@@ -33,6 +33,8 @@ public:
 
   virtual std::string GetHTTPRedirectUrl() const { return m_url; }
   virtual std::string GetHTTPResponseFile() const { return m_url; }
+
+  virtual const char* GetName() const { return "webinterface"; }
   
   static int ResolveUrl(const std::string &url, std::string &path);
   static int ResolveUrl(const std::string &url, std::string &path, ADDON::AddonPtr &addon);
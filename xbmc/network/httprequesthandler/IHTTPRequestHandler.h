@@ -53,7 +53,8 @@ enum HTTPResponseType
   HTTPMemoryDownloadNoFreeNoCopy,
   HTTPMemoryDownloadNoFreeCopy,
   HTTPMemoryDownloadFreeNoCopy,
-  HTTPMemoryDownloadFreeCopy
+  HTTPMemoryDownloadFreeCopy,
+  HTTPStreamDownload
 };
 
 typedef struct HTTPRequest
@@ -65,6 +66,23 @@ typedef struct HTTPRequest
   CWebServer *webserver;
 } HTTPRequest;
 
+/*!
+ \brief Body of a response that is produced while it is being sent
+
+ Its length isn't known up front, so it goes out with chunked transfer encoding.
+ */
+class IHTTPResponseStream
+{
+public:
+  virtual ~IHTTPResponseStream() { }
+
+  /*!
+   \brief Produce the next part of the body
+   \return number of bytes written to buffer, 0 at the end of the body, -1 on failure
+   */
+  virtual int Read(char *buffer, size_t size) = 0;
+};
+
 class IHTTPRequestHandler
 {
 public:
@@ -78,9 +96,13 @@ public:
   virtual size_t GetHTTPResonseDataLength() const { return 0; }
   virtual std::string GetHTTPRedirectUrl() const { return ""; }
   virtual std::string GetHTTPResponseFile() const { return ""; }
+  // ownership of the stream passes to the caller
+  virtual IHTTPResponseStream* GetHTTPResponseStream() { return NULL; }
 
   // The higher the more important
   virtual int GetPriority() const { return 0; }
+  // Requests are accounted under this name in the web server statistics
+  virtual const char* GetName() const { return "other"; }
 
   void AddPostField(const std::string &key, const std::string &value);
 #if (MHD_VERSION >= 0x00040001)
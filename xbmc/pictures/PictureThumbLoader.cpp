@@ -54,9 +54,7 @@ bool CPictureThumbLoader::LoadItem(CFileItem* pItem)
   if (pItem->HasArt("thumb") && m_regenerateThumbs)
   {
     CTextureCache::Get().ClearCachedImage(pItem->GetArt("thumb"));
-    CTextureDatabase db;
-    if (db.Open())
-      db.ClearTextureForPath(pItem->GetPath(), "thumb");
+    CTextureCache::Get().ClearTextureForPath(pItem->GetPath(), "thumb");
     pItem->SetArt("thumb", "");
   }
 
@@ -120,14 +118,12 @@ void CPictureThumbLoader::ProcessFoldersAndArchives(CFileItem *pItem)
   if (pItem->HasArt("thumb"))
     return;
 
-  CTextureDatabase db;
-  db.Open();
   if (pItem->IsCBR() || pItem->IsCBZ())
   {
     CStdString strTBN(URIUtils::ReplaceExtension(pItem->GetPath(),".tbn"));
     if (CFile::Exists(strTBN))
     {
-      db.SetTextureForPath(pItem->GetPath(), "thumb", strTBN);
+      CTextureCache::Get().SetTextureForPath(pItem->GetPath(), "thumb", strTBN);
       CTextureCache::Get().BackgroundCacheImage(strTBN);
       pItem->SetArt("thumb", strTBN);
       return;
@@ -154,7 +150,7 @@ void CPictureThumbLoader::ProcessFoldersAndArchives(CFileItem *pItem)
     thumb = URIUtils::AddFileToFolder(strPath, thumb);
     if (CFile::Exists(thumb))
     {
-      db.SetTextureForPath(pItem->GetPath(), "thumb", thumb);
+      CTextureCache::Get().SetTextureForPath(pItem->GetPath(), "thumb", thumb);
       CTextureCache::Get().BackgroundCacheImage(thumb);
       pItem->SetArt("thumb", thumb);
       return;
@@ -208,7 +204,7 @@ void CPictureThumbLoader::ProcessFoldersAndArchives(CFileItem *pItem)
       { // less than 4 items, so just grab the first thumb
         items.Sort(SORT_METHOD_LABEL, SortOrderAscending);
         CStdString thumb = CTextureCache::GetWrappedThumbURL(items[0]->GetPath());
-        db.SetTextureForPath(pItem->GetPath(), "thumb", thumb);
+        CTextureCache::Get().SetTextureForPath(pItem->GetPath(), "thumb", thumb);
         CTextureCache::Get().BackgroundCacheImage(thumb);
         pItem->SetArt("thumb", thumb);
       }
@@ -228,7 +224,7 @@ void CPictureThumbLoader::ProcessFoldersAndArchives(CFileItem *pItem)
           details.width = g_advancedSettings.GetThumbSize();
           details.height = g_advancedSettings.GetThumbSize();
           CTextureCache::Get().AddCachedTexture(thumb, details);
-          db.SetTextureForPath(pItem->GetPath(), "thumb", thumb);
+          CTextureCache::Get().SetTextureForPath(pItem->GetPath(), "thumb", thumb);
           pItem->SetArt("thumb", CTextureCache::GetCachedPath(relativeCacheFile));
         }
       }
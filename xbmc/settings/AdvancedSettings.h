@@ -36,6 +36,7 @@ public:
     user.clear();
     pass.clear();
     name.clear();
+    journalmode.clear();
   };
   CStdString type;
   CStdString host;
@@ -43,6 +44,7 @@ public:
   CStdString user;
   CStdString pass;
   CStdString name;
+  CStdString journalmode; ///< \brief sqlite journal mode, e.g. "wal", empty leaves the default
 };
 
 struct TVShowRegexp
@@ -110,7 +112,10 @@ class CAdvancedSettings
     bool m_allChannelStereo;
     bool m_streamSilence;
     int m_audioSinkBufferDurationMsec;
+    int m_audioPrerollTime;
     CStdString m_audioTranscodeTo;
+    CStdString m_audioResampler;     // engine used for sample rate conversion
+    CStdString m_audioSyncResampler; // engine used for streams that only resample for A/V sync
     float m_limiterHold;
     float m_limiterRelease;
 
@@ -154,6 +159,9 @@ class CAdvancedSettings
     float m_videoAutoScaleMaxFps;
     bool  m_videoAllowMpeg4VDPAU;
     bool  m_videoAllowMpeg4VAAPI;
+    bool  m_videoFrameThreading;
+    int   m_videoDecodeThreads;
+    int   m_videoRenderBuffers;
     std::vector<RefreshOverride> m_videoAdjustRefreshOverrides;
     std::vector<RefreshVideoLatency> m_videoRefreshLatency;
     float m_videoDefaultLatency;
@@ -249,6 +257,7 @@ class CAdvancedSettings
     bool m_bVideoLibraryHideEmptySeries;
     bool m_bVideoLibraryCleanOnUpdate;
     bool m_bVideoLibraryExportAutoThumbs;
+    int m_videoLibraryThumbJobs; ///< \brief thumbs extracted from video files at once, 0 picks one from the cpu count
     bool m_bVideoLibraryImportWatchedState;
     bool m_bVideoLibraryImportResumePoint;
 
@@ -293,6 +302,7 @@ class CAdvancedSettings
     int m_curlconnecttimeout;
     int m_curllowspeedtime;
     int m_curlretries;
+    int m_curlrangesessions;
     bool m_curlDisableIPV6;
 
     bool m_fullScreen;
@@ -346,6 +356,8 @@ class CAdvancedSettings
     DatabaseSettings m_databaseVideo; // advanced video database setup
     DatabaseSettings m_databaseTV;    // advanced tv database setup
     DatabaseSettings m_databaseEpg;   /*!< advanced EPG database setup */
+    int m_databaseBatchItems; ///< \brief items the library scanners write per transaction, 1 commits every item
+    int m_databaseBatchTime;  ///< \brief ms a scanner transaction is kept open at most
 
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
@@ -357,6 +369,10 @@ class CAdvancedSettings
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
 
+    unsigned int m_webServerThreads;         ///< \brief workers answering web server requests
+    unsigned int m_webServerConnectionLimit;
+    bool m_webServerEpoll;                   ///< \brief poll connections with epoll where available
+
     bool m_enableMultimediaKeys;
     std::vector<CStdString> m_settingsFiles;
     void ParseSettingsFile(const CStdString &file);
@@ -0,0 +1,69 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "HttpRangeUtils.h"
+#include "StringUtils.h"
+
+#include <algorithm>
+#include <stdlib.h>
+
+using namespace std;
+
+int HttpRangeUtils::ParseRange(const string &range, int64_t size, int64_t &start, int64_t &end)
+{
+  // only a single range is supported, for others the whole file is sent
+  if (range.compare(0, 6, "bytes=") != 0 || range.find(',') != string::npos)
+    return 0;
+
+  size_t dash = range.find('-', 6);
+  if (dash == string::npos)
+    return 0;
+
+  CStdString first = range.substr(6, dash - 6);
+  CStdString last = range.substr(dash + 1);
+  if (StringUtils::IsNaturalNumber(first))
+  {
+    start = strtoll(first.c_str(), NULL, 10);
+    end = size - 1;
+    if (StringUtils::IsNaturalNumber(last))
+    {
+      int64_t lastByte = strtoll(last.c_str(), NULL, 10);
+      if (lastByte < start)
+        return 0;
+      end = min(end, lastByte);
+    }
+    else if (!StringUtils::Trim(last).empty())
+      return 0;
+
+    return start < size ? 1 : -1;
+  }
+
+  // the last n bytes of the file
+  if (!StringUtils::Trim(first).empty() || !StringUtils::IsNaturalNumber(last))
+    return 0;
+
+  int64_t suffix = strtoll(last.c_str(), NULL, 10);
+  if (suffix <= 0 || size <= 0)
+    return -1;
+
+  start = max((int64_t)0, size - suffix);
+  end = size - 1;
+  return 1;
+}
@@ -0,0 +1,39 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <string>
+
+class HttpRangeUtils
+{
+public:
+  /*!
+   \brief Parses the value of a Range request header for a file of the given size.
+   Only a single byte range is supported, "first-last", "first-" or the suffix "-count".
+   \param range value of the Range header
+   \param size size of the file
+   \param start first byte of the range, set when 1 is returned
+   \param end last byte of the range, set when 1 is returned
+   \return 1 for a satisfiable range, -1 when it lies outside the file (416),
+   0 when it can't be served and the whole file is to be sent instead
+   */
+  static int ParseRange(const std::string &range, int64_t size, int64_t &start, int64_t &end);
+};
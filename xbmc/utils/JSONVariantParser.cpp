@@ -48,8 +48,6 @@ CJSONVariantParser::CJSONVariantParser(IParseCallback *callback)
 
   m_handler = yajl_alloc(&callbacks, &cfg, NULL, this);
 #endif
-
-  m_status = ParseVariable;
 }
 
 CJSONVariantParser::~CJSONVariantParser()
@@ -60,6 +58,10 @@ CJSONVariantParser::~CJSONVariantParser()
   yajl_parse_complete(m_handler);
 #endif
   yajl_free(m_handler);
+
+  // an incomplete document
+  if (!m_parse.empty())
+    delete m_parse[0];
 }
 
 void CJSONVariantParser::push_buffer(const unsigned char *buffer, unsigned int length)
@@ -74,15 +76,17 @@ CVariant CJSONVariantParser::Parse(const unsigned char *json, unsigned int lengt
 
   parser.push_buffer(json, length);
 
-  return callback.GetOutput();
+  CVariant result;
+  result.swap(callback.GetOutput());
+  return result;
 }
 
 int CJSONVariantParser::ParseNull(void * ctx)
 {
   CJSONVariantParser *parser = (CJSONVariantParser *)ctx;
 
-  parser->PushObject(CVariant::VariantTypeNull);
-  parser->PopObject();
+  CVariant value(CVariant::VariantTypeNull);
+  parser->PushValue(value);
 
   return 1;
 }
@@ -91,8 +95,8 @@ int CJSONVariantParser::ParseBoolean(void * ctx, int boolean)
 {
   CJSONVariantParser *parser = (CJSONVariantParser *)ctx;
 
-  parser->PushObject(CVariant(boolean != 0));
-  parser->PopObject();
+  CVariant value(boolean != 0);
+  parser->PushValue(value);
 
   return 1;
 }
@@ -105,8 +109,8 @@ int CJSONVariantParser::ParseInteger(void * ctx, long integerVal)
 {
   CJSONVariantParser *parser = (CJSONVariantParser *)ctx;
 
-  parser->PushObject(CVariant((int64_t)integerVal));
-  parser->PopObject();
+  CVariant value((int64_t)integerVal);
+  parser->PushValue(value);
 
   return 1;
 }
@@ -115,8 +119,8 @@ int CJSONVariantParser::ParseDouble(void * ctx, double doubleVal)
 {
   CJSONVariantParser *parser = (CJSONVariantParser *)ctx;
 
-  parser->PushObject(CVariant((float)doubleVal));
-  parser->PopObject();
+  CVariant value((float)doubleVal);
+  parser->PushValue(value);
 
   return 1;
 }
@@ -129,8 +133,8 @@ int CJSONVariantParser::ParseString(void * ctx, const unsigned char * stringVal,
 {
   CJSONVariantParser *parser = (CJSONVariantParser *)ctx;
 
-  parser->PushObject(CVariant((const char *)stringVal, stringLen));
-  parser->PopObject();
+  CVariant value((const char *)stringVal, stringLen);
+  parser->PushValue(value);
 
   return 1;
 }
@@ -152,7 +156,7 @@ int CJSONVariantParser::ParseMapKey(void * ctx, const unsigned char * stringVal,
 {
   CJSONVariantParser *parser = (CJSONVariantParser *)ctx;
 
-  parser->m_key = std::string((const char *)stringVal, 0, stringLen);
+  parser->m_key.assign((const char *)stringVal, stringLen);
 
   return 1;
 }
@@ -184,53 +188,56 @@ int CJSONVariantParser::ParseArrayEnd(void * ctx)
   return 1;
 }
 
-void CJSONVariantParser::PushObject(CVariant variant)
+CVariant *CJSONVariantParser::NewValue()
 {
-  if (m_status == ParseObject)
-  {
-    (*m_parse[m_parse.size() - 1])[m_key] = variant;
-    m_parse.push_back(&(*m_parse[m_parse.size() - 1])[m_key]);
-  }
-  else if (m_status == ParseArray)
+  if (m_parse.empty())
+    return new CVariant();
+
+  // values are created in their final place and filled there, so
+  // nothing parsed is ever copied
+  CVariant *parent = m_parse.back();
+  if (parent->isObject())
   {
-    CVariant *temp = m_parse[m_parse.size() - 1];
-    temp->push_back(variant);
-    m_parse.push_back(&(*temp)[temp->size() - 1]);
+    CVariant *value = &(*parent)[m_key];
+    if (!value->isNull())
+      CVariant().swap(*value);
+    return value;
   }
-  else if (m_parse.size() == 0)
+
+  CVariant value;
+  parent->push_back_swap(value);
+  return &(*parent)[parent->size() - 1];
+}
+
+void CJSONVariantParser::PushValue(CVariant &value)
+{
+  CVariant *variant = NewValue();
+  variant->swap(value);
+
+  if (m_parse.empty())
   {
-    m_parse.push_back(new CVariant(variant));
+    if (m_callback)
+      m_callback->onParsed(variant);
+    delete variant;
   }
+}
 
-  if (variant.isObject())
-    m_status = ParseObject;
-  else if (variant.isArray())
-    m_status = ParseArray;
-  else
-    m_status = ParseVariable;
+void CJSONVariantParser::PushObject(CVariant::VariantType type)
+{
+  CVariant *variant = NewValue();
+  CVariant(type).swap(*variant);
+  m_parse.push_back(variant);
 }
 
 void CJSONVariantParser::PopObject()
 {
-  CVariant *variant = m_parse[m_parse.size() - 1];
+  CVariant *variant = m_parse.back();
   m_parse.pop_back();
 
-  if (m_parse.size())
+  if (m_parse.empty())
   {
-    variant = m_parse[m_parse.size() - 1];
-    if (variant->isObject())
-      m_status = ParseObject;
-    else if (variant->isArray())
-      m_status = ParseArray;
-    else
-      m_status = ParseVariable;
-  }
-  else if (m_callback)
-  {
-    m_callback->onParsed(variant);
+    if (m_callback)
+      m_callback->onParsed(variant);
     delete variant;
-
-    m_parse.clear();
-    m_status = ParseVariable;
   }
 }
@@ -39,7 +39,8 @@ public:
 class CSimpleParseCallback : public IParseCallback
 {
 public:
-  virtual void onParsed(CVariant *variant) { m_parsed = *variant; }
+  // the parser is done with the variant, take it over instead of copying it
+  virtual void onParsed(CVariant *variant) { m_parsed.swap(*variant); }
   CVariant &GetOutput() { return m_parsed; }
 
 private:
@@ -80,7 +81,9 @@ private:
   static int ParseArrayStart(void * ctx);
   static int ParseArrayEnd(void * ctx);
 
-  void PushObject(CVariant variant);
+  CVariant *NewValue();
+  void PushValue(CVariant &value);
+  void PushObject(CVariant::VariantType type);
   void PopObject();
 
   static yajl_callbacks callbacks;
@@ -88,15 +91,6 @@ private:
   IParseCallback *m_callback;
   yajl_handle m_handler;
 
-  CVariant m_parsedObject;
-  std::vector<CVariant *> m_parse;
+  std::vector<CVariant *> m_parse; ///< objects and arrays being parsed, they're filled in place
   std::string m_key;
-
-  enum PARSE_STATUS
-  {
-    ParseArray = 1,
-    ParseObject = 2,
-    ParseVariable = 0
-  };
-  PARSE_STATUS m_status;
 };
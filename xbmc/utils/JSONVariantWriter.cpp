@@ -18,16 +18,16 @@
  *
  */
 
+#include <algorithm>
 #include <locale>
+#include <string.h>
 
 #include "JSONVariantWriter.h"
 
 using namespace std;
 
-string CJSONVariantWriter::Write(const CVariant &value, bool compact)
+yajl_gen CJSONVariantWriter::AllocGenerator(bool compact)
 {
-  string output;
-
 #if YAJL_MAJOR == 2
   yajl_gen g = yajl_gen_alloc(NULL);
   yajl_gen_config(g, yajl_gen_beautify, compact ? 0 : 1);
@@ -36,6 +36,14 @@ string CJSONVariantWriter::Write(const CVariant &value, bool compact)
   yajl_gen_config conf = { compact ? 0 : 1, "\t" };
   yajl_gen g = yajl_gen_alloc(&conf, NULL);
 #endif
+  return g;
+}
+
+string CJSONVariantWriter::Write(const CVariant &value, bool compact)
+{
+  string output;
+
+  yajl_gen g = AllocGenerator(compact);
 
   // Set locale to classic ("C") to ensure valid JSON numbers
   const char *currentLocale = setlocale(LC_NUMERIC, NULL);
@@ -136,3 +144,131 @@ bool CJSONVariantWriter::InternalWrite(yajl_gen g, const CVariant &value)
 
   return success;
 }
+
+CJSONVariantStreamWriter::CJSONVariantStreamWriter(const CVariant &value, bool compact)
+{
+  m_gen    = CJSONVariantWriter::AllocGenerator(compact);
+  m_offset = 0;
+  m_failed = false;
+
+  SFrame frame;
+  frame.value  = &value;
+  frame.opened = false;
+  m_stack.push_back(frame);
+}
+
+CJSONVariantStreamWriter::~CJSONVariantStreamWriter()
+{
+  yajl_gen_clear(m_gen);
+  yajl_gen_free(m_gen);
+}
+
+int CJSONVariantStreamWriter::Read(char *buffer, size_t size)
+{
+  if (m_failed)
+    return -1;
+
+  const unsigned char *data;
+#if YAJL_MAJOR == 2
+  size_t length;
+#else
+  unsigned int length;
+#endif
+  yajl_gen_get_buf(m_gen, &data, &length);
+
+  if (length - m_offset < size && !m_stack.empty())
+  {
+    // Set locale to classic ("C") to ensure valid JSON numbers
+    const char *currentLocale = setlocale(LC_NUMERIC, NULL);
+    if (currentLocale != NULL)
+      setlocale(LC_NUMERIC, "C");
+
+    // generate until there is enough to fill the caller's buffer
+    while (length - m_offset < size && !m_stack.empty() && !m_failed)
+    {
+      m_failed = !Step();
+      yajl_gen_get_buf(m_gen, &data, &length);
+    }
+
+    if (currentLocale != NULL)
+      setlocale(LC_NUMERIC, currentLocale);
+
+    if (m_failed)
+      return -1;
+  }
+
+  size_t count = std::min(size, (size_t)(length - m_offset));
+  memcpy(buffer, data + m_offset, count);
+  m_offset += count;
+
+  // everything generated so far was read, start over with an empty buffer
+  if (m_offset == length)
+  {
+    yajl_gen_clear(m_gen);
+    m_offset = 0;
+  }
+
+  return (int)count;
+}
+
+bool CJSONVariantStreamWriter::Step()
+{
+  SFrame &frame = m_stack.back();
+  const CVariant &value = *frame.value;
+
+  if (value.isArray())
+  {
+    if (!frame.opened)
+    {
+      frame.opened = true;
+      frame.array  = value.begin_array();
+      return yajl_gen_status_ok == yajl_gen_array_open(m_gen);
+    }
+
+    if (frame.array == value.end_array())
+    {
+      m_stack.pop_back();
+      return yajl_gen_status_ok == yajl_gen_array_close(m_gen);
+    }
+
+    SFrame item;
+    item.value  = &*frame.array++;
+    item.opened = false;
+    m_stack.push_back(item); // invalidates frame
+    return true;
+  }
+
+  if (value.isObject())
+  {
+    if (!frame.opened)
+    {
+      frame.opened = true;
+      frame.map    = value.begin_map();
+      return yajl_gen_status_ok == yajl_gen_map_open(m_gen);
+    }
+
+    if (frame.map == value.end_map())
+    {
+      m_stack.pop_back();
+      return yajl_gen_status_ok == yajl_gen_map_close(m_gen);
+    }
+
+    const string &key = frame.map->first;
+#if YAJL_MAJOR == 2
+    if (yajl_gen_status_ok != yajl_gen_string(m_gen, (const unsigned char*)key.c_str(), (size_t)key.length()))
+#else
+    if (yajl_gen_status_ok != yajl_gen_string(m_gen, (const unsigned char*)key.c_str(), key.length()))
+#endif
+      return false;
+
+    SFrame item;
+    item.value  = &(frame.map++)->second;
+    item.opened = false;
+    m_stack.push_back(item); // invalidates frame
+    return true;
+  }
+
+  // anything else is written in one go
+  m_stack.pop_back();
+  return CJSONVariantWriter::InternalWrite(m_gen, value);
+}
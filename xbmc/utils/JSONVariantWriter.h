@@ -21,6 +21,7 @@
 
 #include "system.h"
 #include "Variant.h"
+#include <vector>
 #include <yajl/yajl_gen.h>
 #ifdef HAVE_YAJL_YAJL_VERSION_H
 #include <yajl/yajl_version.h>
@@ -31,5 +32,47 @@ class CJSONVariantWriter
 public:
   static std::string Write(const CVariant &value, bool compact);
 private:
+  friend class CJSONVariantStreamWriter;
+
+  static yajl_gen AllocGenerator(bool compact);
   static bool InternalWrite(yajl_gen g, const CVariant &value);
 };
+
+/*!
+ \brief Serializes a CVariant a piece at a time
+
+ Produces the same output as CJSONVariantWriter::Write, but only the part
+ that hasn't been read yet is kept in memory instead of the whole document,
+ so large responses can be sent while they are being serialized. The value
+ must not change until the writer is done with it.
+ */
+class CJSONVariantStreamWriter
+{
+public:
+  CJSONVariantStreamWriter(const CVariant &value, bool compact);
+  ~CJSONVariantStreamWriter();
+
+  /*!
+   \brief Serialize the next part of the value
+   \param buffer buffer to write to
+   \param size size of the buffer
+   \return number of bytes written, 0 once the whole value was read, -1 on failure
+   */
+  int Read(char *buffer, size_t size);
+
+private:
+  bool Step();
+
+  struct SFrame
+  {
+    const CVariant            *value;
+    bool                       opened;
+    CVariant::const_iterator_array array;
+    CVariant::const_iterator_map   map;
+  };
+
+  yajl_gen            m_gen;
+  std::vector<SFrame> m_stack;  ///< containers being written, innermost last
+  size_t              m_offset; ///< bytes of the generator's buffer that were already read
+  bool                m_failed;
+};
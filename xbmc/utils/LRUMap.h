@@ -0,0 +1,103 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stddef.h>
+#include <list>
+#include <map>
+#include <utility>
+
+/*!
+ \brief Map holding at most a fixed number of entries, dropping the least recently used.
+
+ Not thread-safe, callers are expected to hold their own lock.
+ */
+template<class Key, class Value>
+class CLRUMap
+{
+public:
+  CLRUMap(size_t maxSize) : m_maxSize(maxSize), m_size(0) {}
+
+  /*! \brief Look up an entry, marking it as the most recently used
+   \return true if the key was found, false otherwise
+   */
+  bool Get(const Key &key, Value &value)
+  {
+    typename Index::iterator i = m_index.find(key);
+    if (i == m_index.end())
+      return false;
+    m_entries.splice(m_entries.begin(), m_entries, i->second);
+    value = i->second->second;
+    return true;
+  }
+
+  /*! \brief Add or replace an entry, marking it as the most recently used
+   \return true if an older entry had to be dropped to make room, false otherwise
+   */
+  bool Set(const Key &key, const Value &value)
+  {
+    typename Index::iterator i = m_index.find(key);
+    if (i != m_index.end())
+    {
+      i->second->second = value;
+      m_entries.splice(m_entries.begin(), m_entries, i->second);
+      return false;
+    }
+
+    m_entries.push_front(std::make_pair(key, value));
+    m_index.insert(std::make_pair(key, m_entries.begin()));
+    if (++m_size <= m_maxSize)
+      return false;
+
+    m_index.erase(m_entries.back().first);
+    m_entries.pop_back();
+    m_size--;
+    return true;
+  }
+
+  void Erase(const Key &key)
+  {
+    typename Index::iterator i = m_index.find(key);
+    if (i == m_index.end())
+      return;
+    m_entries.erase(i->second);
+    m_index.erase(i);
+    m_size--;
+  }
+
+  void Clear()
+  {
+    m_index.clear();
+    m_entries.clear();
+    m_size = 0;
+  }
+
+  size_t Size() const    { return m_size; }
+  size_t MaxSize() const { return m_maxSize; }
+
+private:
+  typedef std::list<std::pair<Key, Value> > Entries;
+  typedef std::map<Key, typename Entries::iterator> Index;
+
+  Entries m_entries; ///< most recently used first
+  Index   m_index;
+  size_t  m_maxSize;
+  size_t  m_size;    ///< std::list::size() is linear
+};
@@ -617,6 +617,53 @@ void CVariant::append(const CVariant &variant)
   push_back(variant);
 }
 
+void CVariant::push_back_swap(CVariant &variant)
+{
+  if (m_type == VariantTypeNull)
+  {
+    m_type = VariantTypeArray;
+    m_data.array = new VariantArray;
+  }
+
+  if (m_type != VariantTypeArray)
+    return;
+
+  VariantArray &array = *m_data.array;
+  if (array.size() == array.capacity())
+  {
+    // growing the vector would copy every element, swap them over instead
+    VariantArray grown;
+    grown.reserve(array.empty() ? 4 : array.size() * 2);
+    grown.resize(array.size());
+    for (unsigned int index = 0; index < array.size(); index++)
+      grown[index].swap(array[index]);
+    array.swap(grown);
+  }
+
+  array.push_back(CVariant());
+  array.back().swap(variant);
+}
+
+void CVariant::reserve(unsigned int size)
+{
+  if (m_type == VariantTypeNull)
+  {
+    m_type = VariantTypeArray;
+    m_data.array = new VariantArray;
+  }
+
+  if (m_type == VariantTypeArray && size > m_data.array->capacity())
+  {
+    // see push_back_swap(), don't let reserve() copy the elements either
+    VariantArray grown;
+    grown.reserve(size);
+    grown.resize(m_data.array->size());
+    for (unsigned int index = 0; index < m_data.array->size(); index++)
+      grown[index].swap((*m_data.array)[index]);
+    m_data.array->swap(grown);
+  }
+}
+
 const char *CVariant::c_str() const
 {
   if (m_type == VariantTypeString)
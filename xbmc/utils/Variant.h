@@ -99,6 +99,13 @@ public:
 
   void push_back(const CVariant &variant);
   void append(const CVariant &variant);
+  /*!
+   \brief Appends variant without copying it, variant is left null
+   Neither variant nor the elements already in the array are deep copied,
+   so use it to hand over large values that are no longer needed.
+   */
+  void push_back_swap(CVariant &variant);
+  void reserve(unsigned int size);
 
   const char *c_str() const;
 
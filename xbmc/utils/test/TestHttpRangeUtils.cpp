@@ -0,0 +1,105 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/HttpRangeUtils.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestHttpRangeUtils, FirstLast)
+{
+  int64_t start, end;
+  EXPECT_EQ(1, HttpRangeUtils::ParseRange("bytes=0-499", 1000, start, end));
+  EXPECT_EQ(0, start);
+  EXPECT_EQ(499, end);
+
+  EXPECT_EQ(1, HttpRangeUtils::ParseRange("bytes=500-999", 1000, start, end));
+  EXPECT_EQ(500, start);
+  EXPECT_EQ(999, end);
+
+  /* a last byte past the end is cut to the file */
+  EXPECT_EQ(1, HttpRangeUtils::ParseRange("bytes=900-5000", 1000, start, end));
+  EXPECT_EQ(900, start);
+  EXPECT_EQ(999, end);
+
+  EXPECT_EQ(1, HttpRangeUtils::ParseRange("bytes=5-5", 1000, start, end));
+  EXPECT_EQ(5, start);
+  EXPECT_EQ(5, end);
+}
+
+TEST(TestHttpRangeUtils, OpenEnded)
+{
+  int64_t start, end;
+  EXPECT_EQ(1, HttpRangeUtils::ParseRange("bytes=0-", 1000, start, end));
+  EXPECT_EQ(0, start);
+  EXPECT_EQ(999, end);
+
+  EXPECT_EQ(1, HttpRangeUtils::ParseRange("bytes=999-", 1000, start, end));
+  EXPECT_EQ(999, start);
+  EXPECT_EQ(999, end);
+
+  /* offsets past 4GB */
+  EXPECT_EQ(1, HttpRangeUtils::ParseRange("bytes=5000000000-", 6000000000LL, start, end));
+  EXPECT_EQ(5000000000LL, start);
+  EXPECT_EQ(5999999999LL, end);
+}
+
+TEST(TestHttpRangeUtils, Suffix)
+{
+  int64_t start, end;
+  EXPECT_EQ(1, HttpRangeUtils::ParseRange("bytes=-100", 1000, start, end));
+  EXPECT_EQ(900, start);
+  EXPECT_EQ(999, end);
+
+  /* a suffix longer than the file is the whole file */
+  EXPECT_EQ(1, HttpRangeUtils::ParseRange("bytes=-5000", 1000, start, end));
+  EXPECT_EQ(0, start);
+  EXPECT_EQ(999, end);
+}
+
+TEST(TestHttpRangeUtils, NotSatisfiable)
+{
+  int64_t start, end;
+  EXPECT_EQ(-1, HttpRangeUtils::ParseRange("bytes=1000-", 1000, start, end));
+  EXPECT_EQ(-1, HttpRangeUtils::ParseRange("bytes=1000-1999", 1000, start, end));
+  EXPECT_EQ(-1, HttpRangeUtils::ParseRange("bytes=-0", 1000, start, end));
+}
+
+TEST(TestHttpRangeUtils, EmptyFile)
+{
+  /* no range of an empty file can be satisfied */
+  int64_t start, end;
+  EXPECT_EQ(-1, HttpRangeUtils::ParseRange("bytes=0-", 0, start, end));
+  EXPECT_EQ(-1, HttpRangeUtils::ParseRange("bytes=0-0", 0, start, end));
+  EXPECT_EQ(-1, HttpRangeUtils::ParseRange("bytes=-100", 0, start, end));
+}
+
+TEST(TestHttpRangeUtils, Ignored)
+{
+  /* anything else is answered with the whole file */
+  int64_t start, end;
+  EXPECT_EQ(0, HttpRangeUtils::ParseRange("", 1000, start, end));
+  EXPECT_EQ(0, HttpRangeUtils::ParseRange("items=0-10", 1000, start, end));
+  EXPECT_EQ(0, HttpRangeUtils::ParseRange("bytes=0-10,20-30", 1000, start, end));
+  EXPECT_EQ(0, HttpRangeUtils::ParseRange("bytes=10", 1000, start, end));
+  EXPECT_EQ(0, HttpRangeUtils::ParseRange("bytes=500-100", 1000, start, end));
+  EXPECT_EQ(0, HttpRangeUtils::ParseRange("bytes=-", 1000, start, end));
+  EXPECT_EQ(0, HttpRangeUtils::ParseRange("bytes=a-b", 1000, start, end));
+  EXPECT_EQ(0, HttpRangeUtils::ParseRange("bytes=-1-2", 1000, start, end));
+}
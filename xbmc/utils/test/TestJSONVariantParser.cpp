@@ -31,3 +31,21 @@ TEST(TestJSONVariantParser, Parse)
   variant = CJSONVariantParser::Parse(buf, sizeof(buf));
   EXPECT_TRUE(variant.isNull());
 }
+
+TEST(TestJSONVariantParser, ParseNested)
+{
+  const char json[] = "{\"id\":1,\"items\":[{\"label\":\"a\",\"genre\":[\"x\",\"y\"]},[],{\"rating\":7.5,\"watched\":false,\"art\":null}]}";
+  CVariant variant = CJSONVariantParser::Parse((const unsigned char *)json, strlen(json));
+
+  EXPECT_TRUE(variant.isObject());
+  EXPECT_EQ(1, variant["id"].asInteger());
+  EXPECT_EQ(3u, variant["items"].size());
+  EXPECT_STREQ("a", variant["items"][0]["label"].c_str());
+  EXPECT_STREQ("y", variant["items"][0]["genre"][1].c_str());
+  EXPECT_TRUE(variant["items"][1].isArray());
+  EXPECT_TRUE(variant["items"][1].empty());
+  EXPECT_FLOAT_EQ(7.5f, variant["items"][2]["rating"].asFloat());
+  EXPECT_FALSE(variant["items"][2]["watched"].asBoolean(true));
+  EXPECT_TRUE(variant["items"][2].isMember("art"));
+  EXPECT_TRUE(variant["items"][2]["art"].isNull());
+}
@@ -30,3 +30,39 @@ TEST(TestJSONVariantWriter, Write)
   str = CJSONVariantWriter::Write(variant, false);
   EXPECT_STREQ("null\n", str.c_str());
 }
+
+TEST(TestJSONVariantWriter, StreamWriter)
+{
+  CVariant variant;
+  variant["string"] = "value";
+  variant["integer"] = 42;
+  variant["empty"] = CVariant(CVariant::VariantTypeArray);
+  for (int i = 0; i < 100; i++)
+  {
+    CVariant item;
+    item["id"] = i;
+    item["flag"] = (i % 2) == 0;
+    item["list"].push_back("a");
+    item["list"].push_back(CVariant(CVariant::VariantTypeObject));
+    variant["items"].push_back(item);
+  }
+
+  for (int compact = 0; compact < 2; compact++)
+  {
+    std::string expected = CJSONVariantWriter::Write(variant, compact != 0);
+
+    // buffer sizes smaller and larger than single tokens
+    for (size_t size = 1; size <= 4096; size *= 8)
+    {
+      CJSONVariantStreamWriter writer(variant, compact != 0);
+      std::string str;
+      std::vector<char> buffer(size);
+      int read;
+      while ((read = writer.Read(&buffer[0], size)) > 0)
+        str.append(&buffer[0], read);
+
+      EXPECT_EQ(0, read);
+      EXPECT_EQ(expected, str);
+    }
+  }
+}
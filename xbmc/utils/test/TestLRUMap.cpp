@@ -0,0 +1,75 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/LRUMap.h"
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+TEST(TestLRUMap, GetAndSet)
+{
+  CLRUMap<std::string, int> map(2);
+  int value = 0;
+
+  EXPECT_FALSE(map.Get("a", value));
+  EXPECT_FALSE(map.Set("a", 1));
+  EXPECT_TRUE(map.Get("a", value));
+  EXPECT_EQ(1, value);
+
+  EXPECT_FALSE(map.Set("a", 2));
+  EXPECT_TRUE(map.Get("a", value));
+  EXPECT_EQ(2, value);
+  EXPECT_EQ(1u, map.Size());
+}
+
+TEST(TestLRUMap, DropsLeastRecentlyUsed)
+{
+  CLRUMap<std::string, int> map(2);
+  int value = 0;
+
+  map.Set("a", 1);
+  map.Set("b", 2);
+  EXPECT_TRUE(map.Get("a", value));
+  EXPECT_TRUE(map.Set("c", 3));
+  EXPECT_EQ(2u, map.Size());
+
+  EXPECT_FALSE(map.Get("b", value));
+  EXPECT_TRUE(map.Get("a", value));
+  EXPECT_TRUE(map.Get("c", value));
+}
+
+TEST(TestLRUMap, EraseAndClear)
+{
+  CLRUMap<std::string, int> map(2);
+  int value = 0;
+
+  map.Set("a", 1);
+  map.Set("b", 2);
+  map.Erase("a");
+  map.Erase("x");
+  EXPECT_EQ(1u, map.Size());
+  EXPECT_FALSE(map.Get("a", value));
+  EXPECT_FALSE(map.Set("c", 3));
+
+  map.Clear();
+  EXPECT_EQ(0u, map.Size());
+  EXPECT_FALSE(map.Get("c", value));
+}
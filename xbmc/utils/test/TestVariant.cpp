@@ -224,6 +224,28 @@ TEST(TestVariant, c_str)
   EXPECT_STREQ("variant", a.c_str());
 }
 
+TEST(TestVariant, push_back_swap)
+{
+  CVariant a, b;
+  for (int i = 0; i < 10; i++)
+  {
+    CVariant c;
+    c["key"] = i;
+    a.push_back_swap(c);
+    EXPECT_TRUE(c.isNull());
+  }
+  b.reserve(20);
+  b.push_back_swap(a[9]);
+
+  EXPECT_TRUE(a.isArray());
+  EXPECT_EQ(10u, a.size());
+  EXPECT_EQ(0, a[0]["key"].asInteger());
+  EXPECT_EQ(8, a[8]["key"].asInteger());
+  EXPECT_TRUE(a[9].isNull());
+  EXPECT_EQ(1u, b.size());
+  EXPECT_EQ(9, b[0]["key"].asInteger());
+}
+
 TEST(TestVariant, swap)
 {
   CVariant a((int)0), b("variant");
@@ -477,8 +477,10 @@ int CVideoDatabase::GetPathId(const CStdString& strPath)
 
     URIUtils::AddSlashAtEnd(strPath1);
 
-    strSQL=PrepareSQL("select idPath from path where strPath='%s'",strPath1.c_str());
-    m_pDS->query(strSQL.c_str());
+    strSQL = "select idPath from path where strPath=?";
+    SqlParams params;
+    params.push_back(strPath1);
+    m_pDS->query(strSQL, params);
     if (!m_pDS->eof())
       idPath = m_pDS->fv("path.idPath").get_asInt();
 
@@ -668,8 +670,9 @@ bool CVideoDatabase::GetPathHash(const CStdString &path, CStdString &hash)
     if (NULL == m_pDB.get()) return false;
     if (NULL == m_pDS.get()) return false;
 
-    CStdString strSQL=PrepareSQL("select strHash from path where strPath='%s'", path.c_str());
-    m_pDS->query(strSQL.c_str());
+    SqlParams params;
+    params.push_back(path);
+    m_pDS->query("select strHash from path where strPath=?", params);
     if (m_pDS->num_rows() == 0)
       return false;
     hash = m_pDS->fv("strHash").get_asString();
@@ -700,9 +703,12 @@ int CVideoDatabase::AddFile(const CStdString& strFileNameAndPath)
     if (idPath < 0)
       return -1;
 
-    CStdString strSQL=PrepareSQL("select idFile from files where strFileName='%s' and idPath=%i", strFileName.c_str(),idPath);
+    SqlParams params;
+    params.push_back(strFileName);
+    params.push_back(idPath);
 
-    m_pDS->query(strSQL.c_str());
+    strSQL = "select idFile from files where strFileName=? and idPath=?";
+    m_pDS->query(strSQL, params);
     if (m_pDS->num_rows() > 0)
     {
       idFile = m_pDS->fv("idFile").get_asInt() ;
@@ -711,8 +717,10 @@ int CVideoDatabase::AddFile(const CStdString& strFileNameAndPath)
     }
     m_pDS->close();
 
-    strSQL=PrepareSQL("insert into files (idFile, idPath, strFileName) values(NULL, %i, '%s')", idPath, strFileName.c_str());
-    m_pDS->exec(strSQL.c_str());
+    strSQL = "insert into files (idFile, idPath, strFileName) values(NULL, ?, ?)";
+    params[0] = idPath;
+    params[1] = strFileName;
+    m_pDS->exec(strSQL, params);
     idFile = (int)m_pDS->lastinsertid();
     return idFile;
   }
@@ -919,9 +927,10 @@ int CVideoDatabase::GetFileId(const CStdString& strFilenameAndPath)
     int idPath = GetPathId(strPath);
     if (idPath >= 0)
     {
-      CStdString strSQL;
-      strSQL=PrepareSQL("select idFile from files where strFileName='%s' and idPath=%i", strFileName.c_str(),idPath);
-      m_pDS->query(strSQL.c_str());
+      SqlParams params;
+      params.push_back(strFileName);
+      params.push_back(idPath);
+      m_pDS->query("select idFile from files where strFileName=? and idPath=?", params);
       if (m_pDS->num_rows() > 0)
       {
         int idFile = m_pDS->fv("files.idFile").get_asInt();
@@ -1269,14 +1278,17 @@ int CVideoDatabase::AddToTable(const CStdString& table, const CStdString& firstF
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
 
-    CStdString strSQL = PrepareSQL("select %s from %s where %s like '%s'", firstField.c_str(), table.c_str(), secondField.c_str(), value.c_str());
-    m_pDS->query(strSQL.c_str());
+    SqlParams params;
+    params.push_back(value);
+
+    CStdString strSQL = PrepareSQL("select %s from %s where %s like ?", firstField.c_str(), table.c_str(), secondField.c_str());
+    m_pDS->query(strSQL, params);
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
       // doesnt exists, add it
-      strSQL = PrepareSQL("insert into %s (%s, %s) values(NULL, '%s')", table.c_str(), firstField.c_str(), secondField.c_str(), value.c_str());      
-      m_pDS->exec(strSQL.c_str());
+      strSQL = PrepareSQL("insert into %s (%s, %s) values(NULL, ?)", table.c_str(), firstField.c_str(), secondField.c_str());
+      m_pDS->exec(strSQL, params);
       int id = (int)m_pDS->lastinsertid();
       return id;
     }
@@ -1334,14 +1346,15 @@ int CVideoDatabase::AddActor(const CStdString& strActor, const CStdString& thumb
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
     int idActor = -1;
-    CStdString strSQL=PrepareSQL("select idActor from actors where strActor like '%s'", strActor.c_str());
-    m_pDS->query(strSQL.c_str());
+    SqlParams params;
+    params.push_back(strActor);
+    m_pDS->query("select idActor from actors where strActor like ?", params);
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
       // doesnt exists, add it
-      strSQL=PrepareSQL("insert into actors (idActor, strActor, strThumb) values( NULL, '%s','%s')", strActor.c_str(),thumbURLs.c_str());
-      m_pDS->exec(strSQL.c_str());
+      params.push_back(thumbURLs);
+      m_pDS->exec("insert into actors (idActor, strActor, strThumb) values( NULL, ?, ?)", params);
       idActor = (int)m_pDS->lastinsertid();
     }
     else
@@ -1351,8 +1364,10 @@ int CVideoDatabase::AddActor(const CStdString& strActor, const CStdString& thumb
       // update the thumb url's
       if (!thumbURLs.IsEmpty())
       {
-        strSQL=PrepareSQL("update actors set strThumb='%s' where idActor=%i",thumbURLs.c_str(),idActor);
-        m_pDS->exec(strSQL.c_str());
+        params.clear();
+        params.push_back(thumbURLs);
+        params.push_back(idActor);
+        m_pDS->exec("update actors set strThumb=? where idActor=?", params);
       }
     }
     // add artwork
@@ -1376,13 +1391,19 @@ void CVideoDatabase::AddLinkToActor(const char *table, int actorID, const char *
     if (NULL == m_pDB.get()) return ;
     if (NULL == m_pDS.get()) return ;
 
-    CStdString strSQL=PrepareSQL("select * from %s where idActor=%i and %s=%i", table, actorID, secondField, secondID);
-    m_pDS->query(strSQL.c_str());
+    SqlParams params;
+    params.push_back(actorID);
+    params.push_back(secondID);
+
+    CStdString strSQL=PrepareSQL("select * from %s where idActor=? and %s=?", table, secondField);
+    m_pDS->query(strSQL, params);
     if (m_pDS->num_rows() == 0)
     {
       // doesnt exists, add it
-      strSQL=PrepareSQL("insert into %s (idActor, %s, strRole, iOrder) values(%i,%i,'%s',%i)", table, secondField, actorID, secondID, role.c_str(), order);
-      m_pDS->exec(strSQL.c_str());
+      params.push_back(role);
+      params.push_back(order);
+      strSQL=PrepareSQL("insert into %s (idActor, %s, strRole, iOrder) values(?,?,?,?)", table, secondField);
+      m_pDS->exec(strSQL, params);
     }
     m_pDS->close();
   }
@@ -1399,18 +1420,25 @@ void CVideoDatabase::AddToLinkTable(const char *table, const char *firstField, i
     if (NULL == m_pDB.get()) return ;
     if (NULL == m_pDS.get()) return ;
 
-    CStdString strSQL = PrepareSQL("select * from %s where %s=%i and %s=%i", table, firstField, firstID, secondField, secondID);
+    SqlParams params;
+    params.push_back(firstID);
+    params.push_back(secondID);
+
+    CStdString strSQL = PrepareSQL("select * from %s where %s=? and %s=?", table, firstField, secondField);
     if (typeField != NULL && type != NULL)
-      strSQL += PrepareSQL(" and %s='%s'", typeField, type);
-    m_pDS->query(strSQL.c_str());
+    {
+      strSQL += PrepareSQL(" and %s=?", typeField);
+      params.push_back(type);
+    }
+    m_pDS->query(strSQL, params);
     if (m_pDS->num_rows() == 0)
     {
       // doesnt exists, add it
       if (typeField == NULL || type == NULL)
-        strSQL = PrepareSQL("insert into %s (%s,%s) values(%i,%i)", table, firstField, secondField, firstID, secondID);
+        strSQL = PrepareSQL("insert into %s (%s,%s) values(?,?)", table, firstField, secondField);
       else
-        strSQL = PrepareSQL("insert into %s (%s,%s,%s) values(%i,%i,'%s')", table, firstField, secondField, typeField, firstID, secondID, type);
-      m_pDS->exec(strSQL.c_str());
+        strSQL = PrepareSQL("insert into %s (%s,%s,%s) values(?,?,?)", table, firstField, secondField, typeField);
+      m_pDS->exec(strSQL, params);
     }
     m_pDS->close();
   }
@@ -5859,28 +5887,35 @@ bool CVideoDatabase::GetMoviesByWhere(const CStdString& strBaseDir, const Filter
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
-    int iRowsFound = RunQuery(strSQL);
-    if (iRowsFound <= 0)
-      return iRowsFound == 0;
-
-    // store the total value of items as a property
-    if (total < iRowsFound)
-      total = iRowsFound;
-    items.SetProperty("total", total);
-    
     DatabaseResults results;
-    results.reserve(iRowsFound);
+    const query_data *data = NULL;
+    if (sorting.sortBy == SortByNone)
+    {
+      // rows are used in the order they are read, step through them
+      // instead of holding the whole library in memory
+      if (!m_pDS->query_stream(strSQL))
+        return false;
+    }
+    else
+    {
+      int iRowsFound = RunQuery(strSQL);
+      if (iRowsFound <= 0)
+        return iRowsFound == 0;
 
-    if (!SortUtils::SortFromDataset(sortDescription, MediaTypeMovie, m_pDS, results))
-      return false;
+      results.reserve(iRowsFound);
+      if (!SortUtils::SortFromDataset(sortDescription, MediaTypeMovie, m_pDS, results))
+        return false;
+
+      items.Reserve(results.size());
+      data = &m_pDS->get_result_set().records;
+    }
 
     // get data from returned rows
-    items.Reserve(results.size());
-    const query_data &data = m_pDS->get_result_set().records;
-    for (DatabaseResults::const_iterator it = results.begin(); it != results.end(); it++)
+    int iRowsFound = 0;
+    DatabaseResults::const_iterator it = results.begin();
+    for (; data ? it != results.end() : !m_pDS->eof(); iRowsFound++)
     {
-      unsigned int targetRow = (unsigned int)it->at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
+      const dbiplus::sql_record* const record = data ? data->at((unsigned int)(it++)->at(FieldRow).asInteger()) : m_pDS->get_sql_record();
 
       CVideoInfoTag movie = GetDetailsForMovie(record);
       if (g_settings.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
@@ -5897,8 +5932,16 @@ bool CVideoDatabase::GetMoviesByWhere(const CStdString& strBaseDir, const Filter
         pItem->SetOverlayImage(CGUIListItem::ICON_OVERLAY_UNWATCHED,movie.m_playCount > 0);
         items.Add(pItem);
       }
+
+      if (!data)
+        m_pDS->next();
     }
 
+    // store the total value of items as a property
+    if (total < iRowsFound)
+      total = iRowsFound;
+    items.SetProperty("total", total);
+
     // cleanup
     m_pDS->close();
     return true;
@@ -6284,29 +6327,37 @@ bool CVideoDatabase::GetEpisodesByWhere(const CStdString& strBaseDir, const Filt
 
     strSQL = PrepareSQL(strSQL, !extFilter.fields.empty() ? extFilter.fields.c_str() : "*") + strSQLExtra;
 
-    int iRowsFound = RunQuery(strSQL);
-    if (iRowsFound <= 0)
-      return iRowsFound == 0;
-
-    // store the total value of items as a property
-    if (total < iRowsFound)
-      total = iRowsFound;
-    items.SetProperty("total", total);
-    
     DatabaseResults results;
-    results.reserve(iRowsFound);
-    if (!SortUtils::SortFromDataset(sorting, MediaTypeEpisode, m_pDS, results))
-      return false;
+    const query_data *data = NULL;
+    if (sorting.sortBy == SortByNone)
+    {
+      // rows are used in the order they are read, step through them
+      // instead of holding the whole library in memory
+      if (!m_pDS->query_stream(strSQL))
+        return false;
+    }
+    else
+    {
+      int iRowsFound = RunQuery(strSQL);
+      if (iRowsFound <= 0)
+        return iRowsFound == 0;
+
+      results.reserve(iRowsFound);
+      if (!SortUtils::SortFromDataset(sorting, MediaTypeEpisode, m_pDS, results))
+        return false;
+
+      items.Reserve(results.size());
+      data = &m_pDS->get_result_set().records;
+    }
     
     // get data from returned rows
-    items.Reserve(results.size());
     CLabelFormatter formatter("%H. %T", "");
 
-    const query_data &data = m_pDS->get_result_set().records;
-    for (DatabaseResults::const_iterator it = results.begin(); it != results.end(); it++)
+    int iRowsFound = 0;
+    DatabaseResults::const_iterator it = results.begin();
+    for (; data ? it != results.end() : !m_pDS->eof(); iRowsFound++)
     {
-      unsigned int targetRow = (unsigned int)it->at(FieldRow).asInteger();
-      const dbiplus::sql_record* const record = data.at(targetRow);
+      const dbiplus::sql_record* const record = data ? data->at((unsigned int)(it++)->at(FieldRow).asInteger()) : m_pDS->get_sql_record();
 
       CVideoInfoTag movie = GetDetailsForEpisode(record);
       if (g_settings.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
@@ -6332,8 +6383,16 @@ bool CVideoDatabase::GetEpisodesByWhere(const CStdString& strBaseDir, const Filt
         pItem->GetVideoInfoTag()->m_iYear = pItem->m_dateTime.GetYear();
         items.Add(pItem);
       }
+
+      if (!data)
+        m_pDS->next();
     }
 
+    // store the total value of items as a property
+    if (total < iRowsFound)
+      total = iRowsFound;
+    items.SetProperty("total", total);
+
     // cleanup
     m_pDS->close();
     return true;
@@ -8958,6 +9017,8 @@ bool CVideoDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
   { // number of items in the db has likely changed, so recalculate
+    if (InBatch()) // once the batch is committed
+      return true;
     g_infoManager.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
     g_infoManager.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
     g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSICVIDEOS, HasContent(VIDEODB_CONTENT_MUSICVIDEOS));
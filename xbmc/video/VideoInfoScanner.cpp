@@ -106,6 +106,9 @@ namespace VIDEO
       // result in unexpected behaviour.
       m_bCanInterrupt = false;
 
+      // commit the scan in groups of items rather than one by one
+      m_database.BeginBatch();
+
       bool bCancelled = false;
       while (!bCancelled && m_pathsToScan.size())
       {
@@ -130,6 +133,9 @@ namespace VIDEO
           bCancelled = true;
       }
 
+      m_database.EndBatch();
+      AnnounceUpdates();
+
       if (!bCancelled)
       {
         if (m_bClean)
@@ -150,6 +156,8 @@ namespace VIDEO
     catch (...)
     {
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
+      m_database.EndBatch();
+      AnnounceUpdates();
     }
     
     m_bRunning = false;
@@ -1050,7 +1058,10 @@ namespace VIDEO
       return -1;
 
     if (!libraryImport)
+    {
+      FlushBatch();
       GetArtwork(pItem, content, videoFolder, useLocal, showInfo ? showInfo->m_strPath : "");
+    }
 
     // ensure the art map isn't completely empty by specifying an empty thumb
     map<string, string> art = pItem->GetArt();
@@ -1153,10 +1164,30 @@ namespace VIDEO
     m_database.Close();
 
     CFileItemPtr itemCopy = CFileItemPtr(new CFileItem(*pItem));
-    ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnUpdate", itemCopy);
+    if (m_database.InBatch())
+    { // listeners can't see the item until the batch holding it is committed
+      m_pendingUpdates.push_back(itemCopy);
+      if (m_database.BatchItemDone())
+        AnnounceUpdates();
+    }
+    else
+      ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnUpdate", itemCopy);
     return lResult;
   }
 
+  void CVideoInfoScanner::AnnounceUpdates()
+  {
+    for (VECFILEITEMS::iterator it = m_pendingUpdates.begin(); it != m_pendingUpdates.end(); ++it)
+      ANNOUNCEMENT::CAnnouncementManager::Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnUpdate", *it);
+    m_pendingUpdates.clear();
+  }
+
+  void CVideoInfoScanner::FlushBatch()
+  {
+    if (m_database.FlushBatch())
+      AnnounceUpdates();
+  }
+
   string ContentToMediaType(CONTENT_TYPE content, bool folder)
   {
     switch (content)
@@ -1377,6 +1408,7 @@ namespace VIDEO
             pDlgProgress->Progress();
           }
 
+          FlushBatch();
           CVideoInfoDownloader imdb(scraper);
           if (!imdb.GetEpisodeList(url, episodes))
             return INFO_NOT_FOUND;
@@ -1463,6 +1495,7 @@ namespace VIDEO
 
       if (bFound)
       {
+        FlushBatch();
         CVideoInfoDownloader imdb(scraper);
         CFileItem item;
         item.SetPath(file->strPath);
@@ -1608,6 +1641,7 @@ namespace VIDEO
     if (m_handle && !url.strTitle.IsEmpty())
       m_handle->SetText(url.strTitle);
 
+    FlushBatch();
     CVideoInfoDownloader imdb(scraper);
     bool ret = imdb.GetDetails(url, movieDetails, pDialog);
 
@@ -1891,6 +1925,7 @@ namespace VIDEO
   int CVideoInfoScanner::FindVideo(const CStdString &videoName, const ScraperPtr &scraper, CScraperUrl &url, CGUIDialogProgress *progress)
   {
     MOVIELIST movielist;
+    FlushBatch();
     CVideoInfoDownloader imdb(scraper);
     int returncode = imdb.FindMovie(videoName, movielist, progress);
     if (returncode < 0 || (returncode == 0 && (m_bStop || !DownloadFailed(progress))))
@@ -22,6 +22,7 @@
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
 #include "NfoFile.h"
+#include "FileItem.h"
 
 class CRegExp;
 class CFileItem;
@@ -124,6 +125,15 @@ namespace VIDEO
     virtual void Process();
     bool DoScan(const CStdString& strDirectory);
 
+    /*! \brief Announce the items added since the last batch commit
+     */
+    void AnnounceUpdates();
+
+    /*! \brief Commit the items written so far before a scraper or artwork lookup,
+     so the library isn't locked while waiting on the network
+     */
+    void FlushBatch();
+
     INFO_RET RetrieveInfoForTvShow(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, bool fetchEpisodes, CGUIDialogProgress* pDlgProgress);
     INFO_RET RetrieveInfoForMovie(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, CGUIDialogProgress* pDlgProgress);
     INFO_RET RetrieveInfoForMusicVideo(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, CGUIDialogProgress* pDlgProgress);
@@ -237,6 +247,7 @@ namespace VIDEO
     std::set<CStdString> m_pathsToScan;
     std::set<CStdString> m_pathsToCount;
     std::set<int> m_pathsToClean;
+    VECFILEITEMS m_pendingUpdates; ///< \brief items added in the open batch, announced once it's committed
     CNfoFile m_nfoReader;
   };
 }
@@ -35,6 +35,9 @@
 #include "cores/dvdplayer/DVDFileInfo.h"
 #include "video/VideoInfoScanner.h"
 #include "music/MusicDatabase.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/CPUInfo.h"
 
 using namespace XFILE;
 using namespace std;
@@ -111,8 +114,17 @@ bool CThumbExtractor::DoWork()
   return result;
 }
 
+/* extraction is a demux, one keyframe decode and a scale, so files are
+ * handled in parallel. Leave a core for playback and the gui. */
+static unsigned int ThumbExtractJobs()
+{
+  if (g_advancedSettings.m_videoLibraryThumbJobs > 0)
+    return g_advancedSettings.m_videoLibraryThumbJobs;
+  return std::max(1, std::min(4, g_cpuInfo.getCPUCount() - 1));
+}
+
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(1), CJobQueue(true), m_pStreamDetailsObs(NULL)
+  CThumbLoader(1), CJobQueue(true, ThumbExtractJobs()), m_pStreamDetailsObs(NULL)
 {
   m_database = new CVideoDatabase();
 }
@@ -438,6 +450,8 @@ void CVideoThumbLoader::OnJobComplete(unsigned int jobID, bool success, CJob* jo
 {
   if (success)
   {
+    // extractors finish on several job threads at once
+    CSingleLock lock(m_completeSection);
     CThumbExtractor* loader = (CThumbExtractor*)job;
     loader->m_item.SetPath(loader->m_listpath);
     CVideoInfoTag* info = loader->m_item.GetVideoInfoTag();
@@ -27,6 +27,7 @@
 
 #include <map>
 #include "ThumbLoader.h"
+#include "threads/CriticalSection.h"
 #include "utils/JobManager.h"
 #include "FileItem.h"
 
@@ -137,6 +138,7 @@ protected:
   CVideoDatabase *m_database;
   typedef std::map<int, std::map<std::string, std::string> > ArtCache;
   ArtCache m_showArt;
+  CCriticalSection m_completeSection;
 };
 
 #endif
\ No newline at end of file
@@ -27,6 +27,7 @@
 #ifdef HAS_VIDEO_PLAYBACK
 #include "cores/VideoRenderers/RenderManager.h"
 #endif
+#include "cores/AudioEngine/AEFactory.h"
 #include "GUIInfoManager.h"
 #include "guilib/GUIProgressControl.h"
 #include "guilib/GUIAudioManager.h"
@@ -997,6 +998,16 @@ void CGUIWindowFullScreen::FrameMove()
     // show audio codec info
     CStdString strAudio, strVideo, strGeneral;
     g_application.m_pPlayer->GetAudioInfo(strAudio);
+    AEStats aeStats;
+    if (CAEFactory::GetStats(aeStats))
+      strAudio.AppendFormat(" AE( %s buf:%.0f/%.0fms sink:%.0f/%.0fms xrun:%u mix:%.0f/%.0fus out:%.0f/%.0fus ratio:%.4f )"
+                           , aeStats.sink.c_str()
+                           , aeStats.bufferedTime * 1000.0, aeStats.bufferedTotal * 1000.0
+                           , aeStats.sinkCacheTime * 1000.0, aeStats.sinkCacheTotal * 1000.0
+                           , aeStats.underruns + aeStats.sinkErrors
+                           , aeStats.streamStage.average, aeStats.streamStage.max
+                           , aeStats.outputStage.average, aeStats.outputStage.max
+                           , aeStats.resampleRatio);
     {
       CGUIMessage msg(GUI_MSG_LABEL_SET, GetID(), LABEL_ROW1);
       msg.SetLabel(strAudio);
@@ -1004,6 +1015,8 @@ void CGUIWindowFullScreen::FrameMove()
     }
     // show video codec info
     g_application.m_pPlayer->GetVideoInfo(strVideo);
+    if (g_renderManager.IsStarted())
+      strVideo.AppendFormat(" R( %s )", g_renderManager.GetRenderStatsState().c_str());
     {
       CGUIMessage msg(GUI_MSG_LABEL_SET, GetID(), LABEL_ROW2);
       msg.SetLabel(strVideo);